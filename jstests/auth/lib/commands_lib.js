@@ -1362,6 +1362,22 @@ var authCommandsLib = {
                 { runOnDb: secondDbName, roles: roles_all, privileges: [ ] }
             ]
         },
+        {
+            testname: "latencyStats",
+            command: {latencyStats: 1},
+            skipSharded: true,
+            testcases: [
+                {
+                    runOnDb: adminDbName,
+                    roles: roles_monitoring,
+                    privileges: [
+                        { resource: {cluster: true}, actions: ["top"] }
+                    ]
+                },
+                { runOnDb: firstDbName, roles: {} },
+                { runOnDb: secondDbName, roles: {} }
+            ]
+        },
         {
             testname: "listCommands",
             command: {listCommands: 1},
@@ -1703,6 +1719,22 @@ var authCommandsLib = {
                 }
             ]
         },
+        {
+            testname: "profileCpu",
+            command: {profileCpu: 1, durationSecs: 1},
+            skipSharded: true,
+            testcases: [
+                {
+                    runOnDb: adminDbName,
+                    roles: roles_hostManager,
+                    privileges: [
+                        { resource: {cluster: true}, actions: ["cpuProfiler"] }
+                    ]
+                },
+                { runOnDb: firstDbName, roles: {} },
+                { runOnDb: secondDbName, roles: {} }
+            ]
+        },
         {
             testname: "renameCollection_sameDb",
             command: {renameCollection: firstDbName + ".x",
@@ -0,0 +1,37 @@
+// Batched inserts through benchRun, using both the insert command and OP_INSERT.
+// Comparing the insert latencies of the two workloads, divided by the batch size, gives the
+// server cost per inserted document.
+
+t = db.bench_test4
+var batchSize = 100;
+
+[ true, false ].forEach( function( writeCmd ) {
+    t.drop();
+
+    benchArgs = { ops : [ { ns : t.getFullName() ,
+                            op : "insert" ,
+                            safe : true ,
+                            writeCmd : writeCmd ,
+                            batchSize : batchSize ,
+                            doc : { x : { "#RAND_INT" : [ 0 , 1000 ] } ,
+                                    s : "0123456789abcdef0123456789abcdef" } } ] ,
+                  parallel : 2 ,
+                  seconds : 2 ,
+                  totals : true ,
+                  host : db.getMongo().host }
+
+    if (jsTest.options().auth) {
+        benchArgs['db'] = 'admin';
+        benchArgs['username'] = jsTest.options().adminUser;
+        benchArgs['password'] = jsTest.options().adminPassword;
+    }
+
+    res = benchRun( benchArgs )
+    printjson( res );
+
+    print( "writeCmd: " + writeCmd + " micros per document: " +
+           res.insertLatencyAverageMicros / batchSize );
+
+    assert.gt( res.insert , 0 );
+    assert.gte( t.count() , batchSize );
+} );
@@ -0,0 +1,75 @@
+// A limited sort on text score lets the text stage stop once no unseen document can make the
+// top k.  Check that the results match those of the unlimited search.
+
+var t = db.fts_score_sort_limit;
+t.drop();
+
+var words = ["alpha", "bravo", "charlie", "delta", "echo", "foxtrot", "golf", "hotel"];
+Random.setRandomSeed();
+for (var i = 0; i < 500; i++) {
+    var text = [];
+    var n = 1 + Random.randInt(12);
+    for (var j = 0; j < n; j++) {
+        // Skew towards the front of the word list.
+        text.push(words[Math.floor(Random.rand() * Random.rand() * words.length)]);
+    }
+    assert.writeOK(t.insert({_id: i, a: i % 3, t: text.join(" ")}));
+}
+// A few documents that outscore everything above for "alpha bravo", so that the limited search
+// below can stop early.
+for (var i = 500; i < 503; i++) {
+    var text = [];
+    for (var j = 0; j < 8; j++) {
+        text.push("alpha", "bravo");
+    }
+    assert.writeOK(t.insert({_id: i, a: i % 3, t: text.join(" ")}));
+}
+assert.commandWorked(t.ensureIndex({t: "text"}));
+
+var proj = {score: {$meta: "textScore"}};
+var sort = {score: {$meta: "textScore"}};
+
+function scores(cursor) {
+    return cursor.toArray().map(function(doc) { return doc.score; });
+}
+
+function checkTopK(query, k) {
+    var all = scores(t.find(query, proj).sort(sort));
+    var topK = scores(t.find(query, proj).sort(sort).limit(k));
+    assert.eq(all.slice(0, k), topK, tojson(query));
+}
+
+function findTextStage(stage) {
+    while (stage.stage != "TEXT") {
+        stage = stage.inputStage;
+    }
+    return stage;
+}
+
+[1, 5, 20, 1000].forEach(function(k) {
+    checkTopK({$text: {$search: "alpha"}}, k);
+    checkTopK({$text: {$search: "alpha bravo"}}, k);
+    checkTopK({$text: {$search: "alpha bravo golf"}}, k);
+    checkTopK({$text: {$search: "bravo -charlie"}}, k);
+    checkTopK({$text: {$search: "\"alpha bravo\" delta"}}, k);
+    checkTopK({$text: {$search: "alpha bravo"}, a: 1}, k);
+});
+
+// Limit plus skip.
+var all = scores(t.find({$text: {$search: "alpha delta"}}, proj).sort(sort));
+var page = scores(t.find({$text: {$search: "alpha delta"}}, proj).sort(sort).skip(5).limit(5));
+assert.eq(all.slice(5, 10), page);
+
+// The text stage knows about the limit and reads fewer keys than the unlimited search.
+var limited = t.find({$text: {$search: "alpha bravo"}}, proj).sort(sort).limit(3).explain(true);
+var unlimited = t.find({$text: {$search: "alpha bravo"}}, proj).sort(sort).explain(true);
+var limitedText = findTextStage(limited.executionStats.executionStages);
+var unlimitedText = findTextStage(unlimited.executionStats.executionStages);
+assert.eq(3, limitedText.limit);
+assert.eq(undefined, unlimitedText.limit);
+assert.lt(limitedText.keysExamined, unlimitedText.keysExamined);
+
+// Sorting on anything besides the text score alone has to see every result.
+var other = t.find({$text: {$search: "alpha bravo"}}, proj).sort({_id: 1, score: {$meta: "textScore"}})
+             .limit(3).explain(true);
+assert.eq(undefined, findTextStage(other.executionStats.executionStages).limit);
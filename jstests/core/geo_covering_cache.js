@@ -0,0 +1,29 @@
+// Repeating a $geoWithin/$geoIntersects region reuses the covering computed for it during
+// planning.  Check that the results don't change and that the cache reports the hit.
+
+var t = db.geo_covering_cache;
+t.drop();
+
+assert.commandWorked(t.ensureIndex({loc: "2dsphere"}));
+for (var x = 0; x < 10; x++) {
+    for (var y = 0; y < 10; y++) {
+        assert.writeOK(t.insert({loc: [x, y]}));
+    }
+}
+
+var polygon = {type: "Polygon",
+               coordinates: [[[0.5, 0.5], [6.5, 0.5], [6.5, 3.5], [0.5, 3.5], [0.5, 0.5]]]};
+
+function coveringCacheStats() {
+    return db.serverStatus().metrics.query.geoCoveringCache;
+}
+
+var within = t.find({loc: {$geoWithin: {$geometry: polygon}}}).count();
+assert.eq(18, within);
+
+var before = coveringCacheStats();
+assert.eq(within, t.find({loc: {$geoWithin: {$geometry: polygon}}}).count());
+// The region is covered the same way for $geoIntersects.
+assert.eq(within, t.find({loc: {$geoIntersects: {$geometry: polygon}}}).count());
+var after = coveringCacheStats();
+assert.gte(after.hits, before.hits + 2);
@@ -0,0 +1,83 @@
+// $near searches a sequence of annuli sized from the density of nearby points.  Check that the
+// results are the same however the points are spread out, and that explain reports the annuli.
+
+var t = db.geo_near_intervals;
+
+function nearIds(query, limit) {
+    var cursor = t.find(query);
+    if (limit) {
+        cursor = cursor.limit(limit);
+    }
+    return cursor.toArray().map(function(doc) { return doc._id; });
+}
+
+function findNearStage(stage) {
+    while (stage.stage != "GEO_NEAR_2DSPHERE" && stage.stage != "GEO_NEAR_2D") {
+        stage = stage.inputStage;
+    }
+    return stage;
+}
+
+function checkNear(point) {
+    var query = {loc: {$near: point}};
+    var all = nearIds(query);
+    assert.eq(t.count(), all.length);
+
+    // Results come back in distance order, without duplicates.
+    var seen = {};
+    var lastDistance = 0;
+    t.find(query).forEach(function(doc) {
+        assert(!seen[doc._id], "duplicate result " + doc._id);
+        seen[doc._id] = true;
+        var distance = Geo.sphereDistance(point.$geometry ? point.$geometry.coordinates : point,
+                                          doc.loc);
+        assert.gte(distance + 1e-12, lastDistance);
+        lastDistance = distance;
+    });
+
+    [1, 10, 100].forEach(function(limit) {
+        assert.eq(all.slice(0, limit), nearIds(query, limit));
+    });
+
+    var explain = t.find(query).limit(50).explain(true);
+    var nearStage = findNearStage(explain.executionStats.executionStages);
+    assert.gt(nearStage.searchIntervals.length, 0, tojson(nearStage));
+    var lastMax = 0;
+    nearStage.searchIntervals.forEach(function(interval) {
+        assert.gte(interval.minDistance, lastMax - 1e-9, tojson(nearStage.searchIntervals));
+        assert.gt(interval.maxDistance, interval.minDistance);
+        lastMax = interval.maxDistance;
+    });
+}
+
+// A dense cluster around the origin with a sparse scattering further out.
+function populate() {
+    t.drop();
+    Random.setRandomSeed();
+    var id = 0;
+    for (var i = 0; i < 1500; i++) {
+        t.insert({_id: id++, loc: [(Random.rand() - 0.5) * 0.01, (Random.rand() - 0.5) * 0.01]});
+    }
+    for (var i = 0; i < 300; i++) {
+        t.insert({_id: id++, loc: [(Random.rand() - 0.5) * 40, (Random.rand() - 0.5) * 40]});
+    }
+}
+
+populate();
+assert.commandWorked(t.ensureIndex({loc: "2dsphere"}));
+checkNear({$geometry: {type: "Point", coordinates: [0, 0]}});
+checkNear({$geometry: {type: "Point", coordinates: [10, 10]}});
+
+// The same point found through more than one annulus is only returned once.
+t.insert({_id: "line", loc: {type: "LineString", coordinates: [[0, 0], [15, 15]]}});
+assert.eq(1, t.find({loc: {$near: {$geometry: {type: "Point", coordinates: [10, 10]}}},
+                     _id: "line"}).itcount());
+t.remove({_id: "line"});
+
+populate();
+assert.commandWorked(t.ensureIndex({loc: "2d"}));
+var flatIds = nearIds({loc: {$near: [0, 0]}});
+assert.eq(t.count(), flatIds.length);
+assert.eq(flatIds.slice(0, 10), nearIds({loc: {$near: [0, 0]}}, 10));
+var flatExplain = t.find({loc: {$near: [0, 0]}}).limit(50).explain(true);
+assert.gt(findNearStage(flatExplain.executionStats.executionStages).searchIntervals.length, 0);
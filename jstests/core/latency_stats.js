@@ -0,0 +1,57 @@
+// The latencyStats command and the opLatencies serverStatus section report latency histograms of
+// reads, writes, commands and getMores, overall and per collection.
+
+var t = db.latency_stats;
+t.drop();
+
+var adminDB = db.getSiblingDB("admin");
+
+function latencyStats(options) {
+    var res = adminDB.runCommand(Object.extend({latencyStats: 1}, options || {}));
+    assert.commandWorked(res);
+    return res;
+}
+
+var before = latencyStats().global;
+
+for (var i = 0; i < 20; i++) {
+    t.insert({_id: i});
+}
+for (var i = 0; i < 10; i++) {
+    t.findOne({_id: i});
+}
+t.find().batchSize(2).itcount();
+
+var after = latencyStats({namespaces: true});
+["reads", "writes", "commands", "getMores"].forEach(function(type) {
+    var hist = after.global[type];
+    assert.gte(hist.ops, before[type].ops, type);
+    assert.gte(hist.p99, hist.p50, type);
+    assert.gte(hist.p999, hist.p99, type);
+    assert.gte(hist.max, hist.p999, type);
+    assert.eq(undefined, hist.histogram, type);
+});
+assert.gte(after.global.reads.ops - before.reads.ops, 11);
+assert.gte(after.global.getMores.ops - before.getMores.ops, 1);
+// Inserts sent as write commands are counted as commands.
+assert.gte(after.global.writes.ops + after.global.commands.ops -
+           before.writes.ops - before.commands.ops, 20);
+
+var coll = after.namespaces[t.getFullName()];
+assert(coll, tojson(after));
+assert.gte(coll.reads.ops, 11);
+
+// With histograms, the bucket counts add up to the number of operations.
+var withBuckets = latencyStats({namespaces: true, histograms: true});
+var reads = withBuckets.namespaces[t.getFullName()].reads;
+var total = 0;
+reads.histogram.forEach(function(bucket) { total += bucket.count; });
+assert.eq(reads.ops, total);
+
+// Dropping the collection forgets its latencies.
+t.drop();
+assert.eq(undefined, latencyStats({namespaces: true}).namespaces[t.getFullName()]);
+
+var status = db.serverStatus();
+assert(status.opLatencies, tojson(status));
+assert.gte(status.opLatencies.reads.ops, after.global.reads.ops);
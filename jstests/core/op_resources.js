@@ -0,0 +1,34 @@
+// Operations report the CPU time, document bytes and lock waits they use in the profiler, and
+// top sums them per collection.
+
+var testDB = db.getSiblingDB("op_resources");
+testDB.dropDatabase();
+var t = testDB.coll;
+
+var padding = new Array(101).join("x");
+for (var i = 0; i < 100; i++) {
+    t.insert({_id: i, padding: padding});
+}
+
+testDB.setProfilingLevel(2);
+assert.eq(100, t.find().itcount());
+testDB.setProfilingLevel(0);
+
+var entry = testDB.system.profile.find({op: "query", ns: t.getFullName()})
+                                 .sort({$natural: -1}).limit(1).next();
+assert(entry.resources, tojson(entry));
+assert.gt(entry.resources.docBytesRead, 100 * padding.length, tojson(entry));
+assert.eq(0, entry.resources.docBytesWritten, tojson(entry));
+assert.eq("object", typeof entry.resources.lockWaitMicros, tojson(entry));
+if (entry.resources.cpuMicros !== undefined) {
+    assert.gte(entry.resources.cpuMicros, 0, tojson(entry));
+}
+
+var top = db.getSiblingDB("admin").runCommand({top: 1});
+assert.commandWorked(top);
+var coll = top.totals[t.getFullName()];
+assert(coll, tojson(top));
+assert.gt(coll.resources.docBytesRead, 100 * padding.length, tojson(coll));
+assert.gt(coll.resources.docBytesWritten, 100 * padding.length, tojson(coll));
+
+testDB.dropDatabase();
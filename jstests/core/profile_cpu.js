@@ -0,0 +1,48 @@
+// The profileCpu command samples the stacks of busy threads and returns them folded by stack.
+
+var adminDB = db.getSiblingDB("admin");
+var isMongos = db.isMaster().msg == "isdbgrid";
+
+if (!isMongos && !_isWindows()) {
+    assert.commandFailedWithCode(adminDB.runCommand({profileCpu: 1, durationSecs: 0}),
+                                 ErrorCodes.BadValue);
+    assert.commandFailedWithCode(adminDB.runCommand({profileCpu: 1, durationSecs: 1,
+                                                     frequencyHz: 100000}),
+                                 ErrorCodes.BadValue);
+    assert.commandFailed(db.runCommand({profileCpu: 1, durationSecs: 1}));
+
+    // Keep the server busy while it samples itself.
+    var t = db.profile_cpu;
+    t.drop();
+    for (var i = 0; i < 100; i++) {
+        t.insert({_id: i});
+    }
+    var busy = startParallelShell(
+        "var end = new Date().getTime() + 3000;" +
+        "while (new Date().getTime() < end) {" +
+        "    db.profile_cpu.find({$where: 'for (var i = 0; i < 100; i++) {} return true;'})" +
+        "        .itcount();" +
+        "}");
+
+    var res = adminDB.runCommand({profileCpu: 1, durationSecs: 2, frequencyHz: 200});
+    busy();
+    assert.commandWorked(res);
+    assert.gt(res.samples, 0, tojson(res));
+    assert.eq(200, res.frequencyHz);
+
+    var total = 0;
+    var lastCount = Infinity;
+    res.stacks.forEach(function(stack) {
+        assert.eq("string", typeof stack.stack);
+        assert.lte(stack.count, lastCount, "stacks are not sorted by count");
+        lastCount = stack.count;
+        total += stack.count;
+    });
+    if (!res.truncated) {
+        assert.eq(res.samples, total);
+    }
+
+    res = adminDB.runCommand({profileCpu: 1, durationSecs: 1, maxStacks: 1});
+    assert.commandWorked(res);
+    assert.lte(res.stacks.length, 1);
+}
@@ -0,0 +1,31 @@
+// A tailable cursor with the awaitData option waits on the server for new documents, and wakes
+// up as soon as one is inserted.
+
+var collname = "jstests_tailable_await_data";
+var t = db[collname];
+t.drop();
+assert.commandWorked(db.createCollection(collname, {capped: true, size: 4096}));
+t.insert({_id: 0});
+
+var cursor = t.find().addOption(DBQuery.Option.tailable).addOption(DBQuery.Option.awaitData);
+assert.eq(0, cursor.next()._id);
+
+// With nothing inserted, the getMore comes back empty after a few seconds.
+var start = new Date();
+assert(!cursor.hasNext());
+assert.gte(new Date() - start, 1000);
+
+// A document inserted while the getMore waits is returned right away.  The getMore otherwise
+// looks again only after a second, so the insert is made as soon as the getMore shows up in
+// currentOp, and the wait is timed from the insert.
+var inserter = startParallelShell(
+    "assert.soon(function() {" +
+    "    return db.currentOp({op: 'getmore', ns: '" + t.getFullName() + "'}).inprog.length > 0;" +
+    "}, 'getMore never started', 30 * 1000, 10);" +
+    "db." + collname + ".insert({_id: 1, insertedAt: new Date()});");
+assert(cursor.hasNext());
+var doc = cursor.next();
+var waited = new Date() - doc.insertedAt;
+assert.eq(1, doc._id);
+assert.lt(waited, 800, "getMore did not wake up on insert");
+inserter();
@@ -0,0 +1,43 @@
+// Updates that cannot be done in place only rewrite the keys of indexes covering a modified
+// path.  Check that every index still finds each document after a mix of updates to indexed
+// and unindexed fields.
+var t = db.update_unindexed_fields;
+t.drop();
+
+t.ensureIndex({ a: 1 });
+t.ensureIndex({ "b.c": 1 });
+t.ensureIndex({ d: 1, a: 1 });
+
+for (var i = 0; i < 20; i++) {
+    t.insert({ _id: i, a: i, b: { c: [i, i + 100] }, d: "x", s: "" });
+}
+
+function checkIndexes() {
+    for (var i = 0; i < 20; i++) {
+        var doc = t.findOne({ _id: i });
+        assert.eq(1, t.find({ a: doc.a }).hint({ a: 1 }).itcount(), tojson(doc));
+        assert.eq(1, t.find({ "b.c": doc.b.c[0] }).hint({ "b.c": 1 }).itcount(), tojson(doc));
+        assert.eq(1, t.find({ d: doc.d, a: doc.a }).hint({ d: 1, a: 1 }).itcount(), tojson(doc));
+    }
+    assert(t.validate(true).valid);
+}
+
+// grow an unindexed field so the update is not done in place
+for (var i = 0; i < 20; i++) {
+    assert.writeOK(t.update({ _id: i }, { $set: { s: new Array(i + 2).join("s") } }));
+}
+checkIndexes();
+
+// indexed field, positional update of an array element, and a parent of an indexed path
+assert.writeOK(t.update({ _id: 1 }, { $set: { a: 101, s: "longer string than before" } }));
+assert.writeOK(t.update({ _id: 2, "b.c": 2 }, { $set: { "b.c.$": 202, s: "" } }));
+assert.writeOK(t.update({ _id: 3 }, { $set: { b: { c: [303, 304] }, s: "a" } }));
+assert.writeOK(t.update({ _id: 4 }, { $rename: { s: "d" } }));
+assert.writeOK(t.update({ _id: 5 }, { $unset: { a: 1 }, $set: { s: "abcdefgh" } }));
+checkIndexes();
+assert.eq(0, t.find({ "b.c": 2 }).hint({ "b.c": 1 }).itcount());
+assert.eq(0, t.find({ a: 1 }).hint({ a: 1 }).itcount());
+
+// replacement documents
+assert.writeOK(t.update({ _id: 6 }, { a: 606, b: { c: [6] }, d: "y", s: "replaced" }));
+checkIndexes();
@@ -0,0 +1,65 @@
+// Profile entries are inserted into system.profile by a background thread.  Check that a read of
+// system.profile, or a command on it, sees the entries of every operation that ran before it on
+// the same connection, that entries which don't fit in the queue are dropped and counted, and
+// that queued entries are written at shutdown.
+
+var conn = MongoRunner.runMongod({ setParameter: "profileQueueMaxBytes=100000" });
+var admin = conn.getDB("admin");
+var db = conn.getDB("profile_writer");
+
+function profiled(coll) {
+    return { ns: coll.getFullName() };
+}
+
+// With the writer paused, only the reads themselves can insert the queued entries.
+assert.commandWorked(admin.runCommand({ configureFailPoint: "pauseProfileWriter",
+                                        mode: "alwaysOn" }));
+db.setProfilingLevel(2);
+
+jsTest.log("A query on system.profile");
+for (var i = 0; i < 10; i++) {
+    db.find.findOne({ x: i });
+}
+assert.eq(10, db.system.profile.find(profiled(db.find)).itcount());
+
+jsTest.log("A count command on system.profile");
+for (var i = 0; i < 10; i++) {
+    db.count.findOne({ x: i });
+}
+var res = db.runCommand({ count: "system.profile", query: profiled(db.count) });
+assert.commandWorked(res);
+assert.eq(10, res.n);
+
+jsTest.log("An aggregation on system.profile");
+for (var i = 0; i < 10; i++) {
+    db.agg.findOne({ x: i });
+}
+assert.eq(10, db.system.profile.aggregate([{ $match: profiled(db.agg) }]).itcount());
+
+jsTest.log("Filling the queue while the writer is paused");
+var droppedBefore = admin.serverStatus().metrics.profile.dropped;
+var big = new Array(10 * 1024).join("x");
+for (var i = 0; i < 50; i++) {
+    db.full.findOne({ s: big, i: i });
+}
+var dropped = admin.serverStatus().metrics.profile.dropped - droppedBefore;
+assert.gt(dropped, 0, "no profile entries dropped");
+assert.lt(dropped, 50, "every profile entry dropped");
+
+// Every entry that made it into the queue is written, and the dropped ones are not.
+assert.commandWorked(admin.runCommand({ configureFailPoint: "pauseProfileWriter", mode: "off" }));
+assert.eq(50 - dropped, db.system.profile.find(profiled(db.full)).itcount());
+
+jsTest.log("Queued entries are written at shutdown");
+assert.commandWorked(admin.runCommand({ configureFailPoint: "pauseProfileWriter",
+                                        mode: "alwaysOn" }));
+for (var i = 0; i < 10; i++) {
+    db.shutdown.findOne({ x: i });
+}
+MongoRunner.stopMongod(conn);
+
+conn = MongoRunner.runMongod({ restart: conn });
+db = conn.getDB("profile_writer");
+assert.eq(10, db.system.profile.find(profiled(db.shutdown)).itcount());
+
+MongoRunner.stopMongod(conn);
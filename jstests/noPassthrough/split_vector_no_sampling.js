@@ -0,0 +1,24 @@
+// With splitVectorUseSampling off, splitVector counts every key of the chunk on each call: it
+// neither estimates split points from index samples nor serves them from its cache.
+
+var conn = MongoRunner.runMongod({ setParameter: "splitVectorUseSampling=false" });
+var coll = conn.getDB("test").split_vector_no_sampling;
+
+var pad = new Array(1024).join("x");
+var bulk = coll.initializeUnorderedBulkOp();
+for (var i = 0; i < 20000; i++) {
+    bulk.insert({ x: i, pad: pad });
+}
+assert.writeOK(bulk.execute());
+assert.commandWorked(coll.ensureIndex({ x: 1 }));
+
+var cmd = { splitVector: coll.getFullName(), keyPattern: { x: 1 }, maxChunkSizeBytes: 1024 * 1024 };
+for (var pass = 0; pass < 2; pass++) {
+    var res = conn.getDB("admin").runCommand(cmd);
+    assert.commandWorked(res);
+    assert.gt(res.splitKeys.length, 0, tojson(res));
+    assert(!res.estimated, "split points estimated with sampling off: " + tojson(res));
+    assert(!res.cached, "split points cached with sampling off: " + tojson(res));
+}
+
+MongoRunner.stopMongod(conn);
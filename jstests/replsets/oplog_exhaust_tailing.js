@@ -0,0 +1,95 @@
+// Test that secondaries replicate the same data whether the sync source streams oplog batches
+// over an exhaust cursor or answers a getMore for each batch, that a streaming secondary stops
+// reading while its buffer is over the high-water mark, and that streams are re-established after
+// the sync source goes away.
+var replTest = new ReplSetTest({ name: "oplog_exhaust_tailing", oplogSize: 50,
+                                 nodes: { n0: {},
+                                          n1: { setParameter: "replExhaustBufferHighWaterPercent=1" },
+                                          n2: { setParameter: "replExhaustOplogTailing=false" } } });
+replTest.startSet();
+replTest.initiate();
+
+var primary = replTest.getMaster();
+var coll = primary.getDB("test").exhaust;
+var bigString = new Array(16 * 1024).join("x");
+
+jsTestLog("Inserting documents while the secondaries tail the oplog");
+for (var round = 0; round < 10; round++) {
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 500; i++) {
+        bulk.insert({ round: round, i: i, s: bigString });
+    }
+    assert.writeOK(bulk.execute());
+}
+assert.writeOK(coll.insert({ last: true }, { writeConcern: { w: 3, wtimeout: 120000 } }));
+
+replTest.awaitReplication();
+replTest.liveNodes.slaves.forEach(function(secondary) {
+    secondary.setSlaveOk();
+    assert.eq(5001, secondary.getDB("test").exhaust.count(), secondary.host);
+
+    var network = secondary.getDB("admin").serverStatus().metrics.repl.network;
+    printjson(network);
+    assert.gt(network.getmores.num, 0, secondary.host);
+});
+
+function isStreaming(node) {
+    var res = node.getDB("admin").runCommand({ getParameter: 1, replExhaustOplogTailing: 1 });
+    assert.commandWorked(res);
+    return res.replExhaustOplogTailing;
+}
+
+function flowControlWaits(node) {
+    return node.getDB("admin").serverStatus().metrics.repl.network.flowControlWaits.num;
+}
+
+jsTestLog("Filling the buffer of a streaming secondary whose applier is stopped");
+var streamer = replTest.liveNodes.slaves.filter(isStreaming)[0];
+assert(streamer, "no streaming secondary");
+var admin = streamer.getDB("admin");
+assert.commandWorked(admin.runCommand({ setParameter: 1, replExhaustBufferHighWaterPercent: 1 }));
+var waitsBefore = flowControlWaits(streamer);
+
+assert.commandWorked(admin.runCommand({ configureFailPoint: "rsSyncApplyStop",
+                                        mode: "alwaysOn" }));
+var bulk = coll.initializeUnorderedBulkOp();
+for (var i = 0; i < 500; i++) {
+    bulk.insert({ round: "full", i: i, s: bigString });
+}
+assert.writeOK(bulk.execute());
+
+// Above the high-water mark the secondary stops reading, rather than buffering all of it.
+var buffer;
+assert.soon(function() {
+    buffer = admin.serverStatus().metrics.repl.buffer;
+    return buffer.sizeBytes >= buffer.maxSizeBytes / 100;
+}, "buffer never reached the high-water mark");
+sleep(2000);
+buffer = admin.serverStatus().metrics.repl.buffer;
+assert.lt(buffer.count, 500, tojson(buffer));
+assert.eq(waitsBefore, flowControlWaits(streamer), "flow control wait ended early");
+
+assert.commandWorked(admin.runCommand({ configureFailPoint: "rsSyncApplyStop", mode: "off" }));
+replTest.awaitReplication();
+streamer.setSlaveOk();
+assert.eq(5501, streamer.getDB("test").exhaust.count());
+assert.gt(flowControlWaits(streamer), waitsBefore);
+assert.commandWorked(admin.runCommand({ setParameter: 1, replExhaustBufferHighWaterPercent: 50 }));
+
+jsTestLog("Waiting out an idle period, then writing again");
+sleep(6000);
+assert.writeOK(coll.insert({ afterIdle: true }, { writeConcern: { w: 3, wtimeout: 60000 } }));
+
+jsTestLog("Restarting the primary, which ends every stream from it");
+replTest.restart(replTest.getNodeId(primary));
+primary = replTest.getMaster();
+coll = primary.getDB("test").exhaust;
+assert.writeOK(coll.insert({ afterRestart: true }, { writeConcern: { w: 3, wtimeout: 120000 } }));
+
+replTest.awaitReplication();
+replTest.nodes.forEach(function(node) {
+    node.setSlaveOk();
+    assert.eq(5503, node.getDB("test").exhaust.count(), node.host);
+});
+
+replTest.stopSet();
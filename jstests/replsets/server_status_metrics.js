@@ -10,6 +10,8 @@ function testSecondaryMetrics(secondary, opCount, offset) {
     assert(ss.metrics.repl.network.getmores.totalMillis > 0, "no getmores time")
     assert.eq(ss.metrics.repl.network.ops, opCount + offset, "wrong number of ops retrieved")
     assert(ss.metrics.repl.network.bytes > 0, "zero or missing network bytes")
+    // The buffer never gets near its high-water mark here.
+    assert.eq(ss.metrics.repl.network.flowControlWaits.num, 0, "unexpected flowControlWaits")
 
     assert(ss.metrics.repl.buffer.count >= 0, "buffer count missing")
     assert(ss.metrics.repl.buffer.sizeBytes >= 0, "size (bytes)] missing")
@@ -0,0 +1,71 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/base/counter.h"
+
+#if !defined(MONGO_HAVE___THREAD) && !defined(MONGO_HAVE___DECLSPEC_THREAD)
+#include <boost/thread/tss.hpp>
+#endif
+
+namespace mongo {
+
+    namespace {
+        AtomicUInt32 nextStripe;
+
+        unsigned assignStripe() {
+            return nextStripe.fetchAndAdd(1) % ShardedCounter64::kNumStripes;
+        }
+
+        // The thread local variants hold the stripe + 1, so that zero means "not yet assigned".
+#if defined(MONGO_HAVE___THREAD)
+        __thread unsigned threadStripe;
+#elif defined(MONGO_HAVE___DECLSPEC_THREAD)
+        __declspec( thread ) unsigned threadStripe;
+#else
+        boost::thread_specific_ptr<unsigned> threadStripe;
+#endif
+    }  // namespace
+
+    unsigned ShardedCounter64::currentStripe() {
+#if defined(MONGO_HAVE___THREAD) || defined(MONGO_HAVE___DECLSPEC_THREAD)
+        if ( !threadStripe )
+            threadStripe = assignStripe() + 1;
+        return threadStripe - 1;
+#else
+        unsigned* stripe = threadStripe.get();
+        if ( !stripe ) {
+            stripe = new unsigned( assignStripe() );
+            threadStripe.reset( stripe );
+        }
+        return *stripe;
+#endif
+    }
+
+}  // namespace mongo
@@ -31,6 +31,7 @@
 #pragma once
 
 #include "mongo/platform/atomic_word.h"
+#include "mongo/platform/compiler.h"
 #include "mongo/platform/cstdint.h"
 
 namespace mongo {
@@ -57,4 +58,46 @@ namespace mongo {
     private:
         AtomicInt64 _counter;
     };
+
+    /**
+     * A 64bit counter for values that are bumped by many threads at once, such as per-operation
+     * statistics.
+     *
+     * The count is split across kNumStripes cache line sized cells, and each thread always bumps
+     * the same cell, so concurrent increments from different threads rarely touch the same cache
+     * line.  get() sums the cells; it is more expensive than Counter64::get() and the result is
+     * not a consistent snapshot while increments are in flight.
+     */
+    class ShardedCounter64 {
+    public:
+        enum { kNumStripes = 16, kCacheLineSize = 64 };
+
+        void increment( uint64_t n = 1 ) { _stripes[currentStripe()].value.fetchAndAdd(n); }
+
+        void decrement( uint64_t n = 1 ) { _stripes[currentStripe()].value.fetchAndSubtract(n); }
+
+        /** Return the sum of all the stripes */
+        long long get() const {
+            long long total = 0;
+            for ( int i = 0; i < kNumStripes; i++ )
+                total += _stripes[i].value.loadRelaxed();
+            return total;
+        }
+
+        operator long long() const { return get(); }
+
+        /**
+         * The stripe used by the calling thread.  Threads are handed stripes round robin the
+         * first time they ask.
+         */
+        static unsigned currentStripe();
+
+    private:
+        struct MONGO_COMPILER_ALIGN_TYPE(64) Stripe {
+            AtomicInt64 value;
+            char padding[kCacheLineSize - sizeof(AtomicInt64)];
+        };
+
+        Stripe _stripes[kNumStripes];
+    };
 }
@@ -28,7 +28,9 @@
 
 #include "mongo/platform/basic.h"
 
+#include <boost/bind.hpp>
 #include <boost/static_assert.hpp>
+#include <boost/thread/thread.hpp>
 #include <climits>
 #include <iostream>
 
@@ -54,5 +56,36 @@ namespace mongo {
             ASSERT_EQUALS(static_cast<long long>(c), 0);
         }
 
+        TEST( ShardedCounterTest, Basic ) {
+            ShardedCounter64 c;
+            ASSERT_EQUALS(c.get(), 0);
+            c.increment();
+            ASSERT_EQUALS(c.get(), 1);
+            c.increment(10);
+            ASSERT_EQUALS(c.get(), 11);
+            c.decrement(12);
+            ASSERT_EQUALS(c.get(), -1);
+            ASSERT_EQUALS(static_cast<long long>(c), -1);
+        }
+
+        TEST( ShardedCounterTest, StripesArePadded ) {
+            BOOST_STATIC_ASSERT(sizeof(ShardedCounter64) ==
+                                ShardedCounter64::kNumStripes * ShardedCounter64::kCacheLineSize);
+        }
+
+        void incrementMany( ShardedCounter64* c ) {
+            for ( int i = 0; i < 10000; i++ )
+                c->increment();
+        }
+
+        TEST( ShardedCounterTest, SumsAcrossThreads ) {
+            ShardedCounter64 c;
+            boost::thread_group threads;
+            for ( int i = 0; i < 2 * ShardedCounter64::kNumStripes; i++ )
+                threads.create_thread( boost::bind( incrementMany, &c ) );
+            threads.join_all();
+            ASSERT_EQUALS(c.get(), 2 * ShardedCounter64::kNumStripes * 10000);
+        }
+
     }  // namespace
 }  // namespace mongo
@@ -0,0 +1,116 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/bson/bson_field_index.h"
+
+#include "mongo/bson/bsonobjiterator.h"
+
+namespace mongo {
+
+    namespace {
+
+        uint32_t hashFieldName(const StringData& name) {
+            return static_cast<uint32_t>(StringData::Hasher()(name));
+        }
+
+    }  // namespace
+
+    BSONFieldIndex::BSONFieldIndex(const BSONObj& obj)
+        : _obj(obj),
+          _numLookups(0),
+          _built(false) {
+    }
+
+    BSONElement BSONFieldIndex::getField(const StringData& name) {
+        if (!_built) {
+            if (++_numLookups <= kLookupsBeforeIndexing) {
+                return _obj.getField(name);
+            }
+            buildIndex();
+        }
+
+        if (_slots.empty()) {
+            return _obj.getField(name);
+        }
+
+        const uint32_t hash = hashFieldName(name);
+        const size_t mask = _slots.size() - 1;
+        for (size_t i = hash & mask; _slots[i].offset != 0; i = (i + 1) & mask) {
+            if (_slots[i].hash != hash) {
+                continue;
+            }
+            BSONElement e(_obj.objdata() + _slots[i].offset);
+            if (name == e.fieldName()) {
+                return e;
+            }
+        }
+        return BSONElement();
+    }
+
+    void BSONFieldIndex::buildIndex() {
+        _built = true;
+
+        const int numFields = _obj.nFields();
+        if (numFields < kMinFieldsToIndex) {
+            return;
+        }
+
+        // Keep the table at most half full.
+        size_t numSlots = 1;
+        while (numSlots < static_cast<size_t>(2 * numFields)) {
+            numSlots *= 2;
+        }
+        Slot empty = { 0, 0 };
+        _slots.assign(numSlots, empty);
+
+        const size_t mask = numSlots - 1;
+        BSONObjIterator it(_obj);
+        while (it.more()) {
+            const BSONElement e = it.next();
+            const StringData name(e.fieldName(), e.fieldNameSize() - 1);
+            const uint32_t hash = hashFieldName(name);
+
+            size_t i = hash & mask;
+            bool duplicate = false;
+            for (; _slots[i].offset != 0; i = (i + 1) & mask) {
+                if (_slots[i].hash == hash
+                        && name == BSONElement(_obj.objdata() + _slots[i].offset).fieldName()) {
+                    duplicate = true;
+                    break;
+                }
+            }
+
+            // The first field with a name wins, as with BSONObj::getField().
+            if (!duplicate) {
+                _slots[i].hash = hash;
+                _slots[i].offset = static_cast<uint32_t>(e.rawdata() - _obj.objdata());
+            }
+        }
+    }
+
+}  // namespace mongo
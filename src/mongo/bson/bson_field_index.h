@@ -0,0 +1,91 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/platform/cstdint.h"
+
+namespace mongo {
+
+    /**
+     * Finds the top level fields of one BSONObj by name in constant time, for code that looks up
+     * many fields of the same object.  BSONObj::getField() scans the object on every call, which
+     * adds up for wide documents.
+     *
+     * The index is only built once enough lookups have been made to make it worthwhile, and only
+     * for objects with enough fields; until then, and for small objects, lookups scan the object
+     * as getField() does.  Like getField(), the first field with a given name is returned.
+     *
+     * The index refers into the object's buffer, which must stay valid while the index is used.
+     */
+    class BSONFieldIndex {
+        MONGO_DISALLOW_COPYING(BSONFieldIndex);
+    public:
+        explicit BSONFieldIndex(const BSONObj& obj);
+
+        /**
+         * Same as obj.getField(name).
+         */
+        BSONElement getField(const StringData& name);
+
+        const BSONObj& getObj() const { return _obj; }
+
+        /**
+         * True if lookups are served from the index rather than by scanning.
+         */
+        bool isIndexed() const { return !_slots.empty(); }
+
+        // Lookups made before the index is built.
+        static const int kLookupsBeforeIndexing = 2;
+
+        // Objects with fewer fields are always scanned.
+        static const int kMinFieldsToIndex = 16;
+
+    private:
+        struct Slot {
+            uint32_t hash;
+            // Offset of the element from the start of the object, or 0 for an empty slot.
+            uint32_t offset;
+        };
+
+        void buildIndex();
+
+        const BSONObj _obj;
+        int _numLookups;
+        bool _built;
+
+        // Open addressing with linear probing; the size is a power of two.
+        std::vector<Slot> _slots;
+    };
+
+}  // namespace mongo
@@ -0,0 +1,110 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/bson/bson_field_index.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/unittest/unittest.h"
+
+namespace {
+
+    using namespace mongo;
+
+    BSONObj wideObj(int numFields) {
+        BSONObjBuilder bob;
+        for (int i = 0; i < numFields; i++) {
+            bob.append(BSONObjBuilder::numStr(i) + "field", i);
+        }
+        return bob.obj();
+    }
+
+    void assertSameElement(const BSONElement& expected, const BSONElement& actual) {
+        ASSERT_EQUALS(expected.rawdata(), actual.rawdata());
+    }
+
+    TEST(BSONFieldIndex, SmallObjectIsNotIndexed) {
+        BSONObj obj = BSON("a" << 1 << "b" << 2);
+        BSONFieldIndex index(obj);
+        for (int i = 0; i < 10; i++) {
+            assertSameElement(obj["a"], index.getField("a"));
+            assertSameElement(obj["b"], index.getField("b"));
+            ASSERT(index.getField("c").eoo());
+        }
+        ASSERT_FALSE(index.isIndexed());
+    }
+
+    TEST(BSONFieldIndex, IndexedAfterSeveralLookups) {
+        BSONObj obj = wideObj(200);
+        BSONFieldIndex index(obj);
+        for (int i = 0; i < BSONFieldIndex::kLookupsBeforeIndexing; i++) {
+            assertSameElement(obj["7field"], index.getField("7field"));
+            ASSERT_FALSE(index.isIndexed());
+        }
+        assertSameElement(obj["7field"], index.getField("7field"));
+        ASSERT_TRUE(index.isIndexed());
+    }
+
+    TEST(BSONFieldIndex, SameAsGetField) {
+        for (int numFields = 0; numFields < 100; numFields += 7) {
+            BSONObj obj = wideObj(numFields);
+            BSONFieldIndex index(obj);
+            for (int i = 0; i < numFields + 5; i++) {
+                const std::string name = BSONObjBuilder::numStr(i) + "field";
+                assertSameElement(obj.getField(name), index.getField(name));
+            }
+            ASSERT(index.getField("").eoo());
+            ASSERT(index.getField("field").eoo());
+            ASSERT(index.getField("0fiel").eoo());
+            ASSERT(index.getField("0fieldx").eoo());
+        }
+    }
+
+    TEST(BSONFieldIndex, DuplicateNamesReturnFirst) {
+        BSONObjBuilder bob;
+        for (int i = 0; i < 50; i++) {
+            bob.append(BSONObjBuilder::numStr(i % 10), i);
+        }
+        BSONObj obj = bob.obj();
+        BSONFieldIndex index(obj);
+        for (int i = 0; i < 20; i++) {
+            const std::string name = BSONObjBuilder::numStr(i % 10);
+            assertSameElement(obj.getField(name), index.getField(name));
+            ASSERT_EQUALS(i % 10, index.getField(name).numberInt());
+        }
+        ASSERT_TRUE(index.isIndexed());
+    }
+
+    TEST(BSONFieldIndex, EmptyObject) {
+        BSONObj obj;
+        BSONFieldIndex index(obj);
+        for (int i = 0; i < 5; i++) {
+            ASSERT(index.getField("a").eoo());
+        }
+    }
+
+}  // namespace
@@ -28,7 +28,7 @@
  */
 
 #include <cstring>
-#include <deque>
+#include <vector>
 
 #include "mongo/base/data_view.h"
 #include "mongo/bson/bson_validate.h"
@@ -167,6 +167,48 @@ namespace mongo {
             int _startPosition;
         };
 
+        /**
+         * The stack of objects being validated.  Documents nested no deeper than kInlineFrames
+         * are validated without allocating.
+         */
+        class ValidationFrameStack {
+        public:
+            ValidationFrameStack() : _size(0) {}
+
+            bool empty() const { return _size == 0; }
+            size_t size() const { return _size; }
+
+            /**
+             * The returned reference is invalidated by the next push_back().
+             */
+            ValidationObjectFrame& back() {
+                if (_size <= kInlineFrames)
+                    return _inline[_size - 1];
+                return _overflow[_size - kInlineFrames - 1];
+            }
+
+            void push_back(const ValidationObjectFrame& frame) {
+                if (_size < kInlineFrames)
+                    _inline[_size] = frame;
+                else
+                    _overflow.push_back(frame);
+                _size++;
+            }
+
+            void pop_back() {
+                if (_size > kInlineFrames)
+                    _overflow.pop_back();
+                _size--;
+            }
+
+        private:
+            static const size_t kInlineFrames = 32;
+
+            size_t _size;
+            ValidationObjectFrame _inline[kInlineFrames];
+            std::vector<ValidationObjectFrame> _overflow;
+        };
+
         /**
          * WARNING: only pass in a non-EOO idElem if it has been fully validated already!
          */
@@ -267,7 +309,7 @@ namespace mongo {
         }
 
         Status validateBSONIterative(Buffer* buffer) {
-            std::deque<ValidationObjectFrame> frames;
+            ValidationFrameStack frames;
             ValidationObjectFrame* curr = NULL;
             ValidationState::State state = ValidationState::BeginObj;
 
@@ -304,7 +346,8 @@ namespace mongo {
                     // we've already validated that fieldname is safe to access as long as we aren't
                     // at the end of the object, since EOO doesn't have a fieldname.
                     if (nextState != ValidationState::EndObj && idElem.eoo() && atTopLevel) {
-                        if (strcmp(buffer->getBasePtr() + elemStartPos + 1/*type*/, "_id") == 0) {
+                        const char* fieldName = buffer->getBasePtr() + elemStartPos + 1/*type*/;
+                        if (fieldName[0] == '_' && strcmp(fieldName, "_id") == 0) {
                             idElemStartPos = elemStartPos;
                         }
                     }
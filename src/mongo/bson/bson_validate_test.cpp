@@ -234,6 +234,29 @@ namespace {
         ASSERT_NOT_OK(validateBSON(x.objdata(), x.objsize() / 2));
     }
 
+    TEST(BSONValidateFast, DeeplyNestedObject) {
+        BSONObj x = BSON("x" << 1);
+        for (int i = 0; i < 100; i++) {
+            x = BSON("a" << i << "b" << BSON_ARRAY(i << x));
+        }
+        ASSERT_OK(validateBSON(x.objdata(), x.objsize()));
+        ASSERT_NOT_OK(validateBSON(x.objdata(), x.objsize() / 2));
+    }
+
+    TEST(BSONValidateFast, LongFieldNames) {
+        BSONObjBuilder b;
+        for (int len = 1; len < 100; len++) {
+            b.append(std::string(len, 'f'), len);
+        }
+        BSONObj x = b.obj();
+        ASSERT_OK(validateBSON(x.objdata(), x.objsize()));
+
+        // The buffer ends partway through every field name tried.
+        for (int size = 5; size < x.objsize(); size += 7) {
+            ASSERT_NOT_OK(validateBSON(x.objdata(), size));
+        }
+    }
+
     TEST(BSONValidateFast, ErrorWithId) {
         BufBuilder bb;
         BSONObjBuilder ob(bb);
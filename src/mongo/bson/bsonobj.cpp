@@ -338,7 +338,7 @@ namespace mongo {
         BSONElement sub;
 
         if ( p ) {
-            sub = getField( string(name, p-name) );
+            sub = getField( StringData(name, p-name) );
             name = p + 1;
         }
         else {
@@ -27,6 +27,7 @@
 
 #pragma once
 
+#include <cstring>
 #include <vector>
 
 #include "mongo/platform/cstdint.h"
@@ -53,5 +54,17 @@ namespace mutablebson {
 
     typedef std::vector<DamageEvent> DamageVector;
 
+    /**
+     * Applies 'damages' to the buffer at 'target', reading replacement bytes from 'source'.
+     * Events are applied in order, so later events win where they overlap.  For storage that
+     * can be written directly; mmap_v1 must declare each write to its recovery unit instead.
+     */
+    inline void applyDamages(char* target, const char* source, const DamageVector& damages) {
+        const DamageVector::const_iterator end = damages.end();
+        for (DamageVector::const_iterator where = damages.begin(); where != end; ++where) {
+            std::memcpy(target + where->targetOffset, source + where->sourceOffset, where->size);
+        }
+    }
+
 } // namespace mutablebson
 } // namespace mongo
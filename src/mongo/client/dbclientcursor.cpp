@@ -211,9 +211,11 @@ namespace mongo {
                 throw UserException( 13127 , "getMore: cursor didn't exist on server, possible restart or timeout?" );
         }
 
-        if ( cursorId == 0 || ! ( opts & QueryOption_CursorTailable ) ) {
+        if ( cursorId == 0 || ! ( opts & QueryOption_CursorTailable ) ||
+             ( opts & QueryOption_Exhaust ) ) {
             // only set initially: we don't want to kill it on end of data
-            // if it's a tailable cursor
+            // if it's a tailable cursor.  an exhaust stream, tailable or not, ends with the
+            // first reply that carries no cursor id, so that one must be recorded.
             cursorId = qr.getCursorId();
         }
 
@@ -250,7 +252,10 @@ namespace mongo {
         if ( cursorId == 0 )
             return false;
 
-        requestMore();
+        if ( opts & QueryOption_Exhaust )
+            exhaustReceiveMore();
+        else
+            requestMore();
         return batch.pos < batch.nReturned;
     }
 
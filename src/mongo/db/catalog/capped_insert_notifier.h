@@ -0,0 +1,102 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/cstdint.h"
+
+namespace mongo {
+
+    /**
+     * Lets tailable cursors on a capped collection sleep until something is inserted into it,
+     * rather than poll.
+     *
+     * Each committed insert bumps a version number.  A reader notes the version before it reads,
+     * and if it finds nothing new, waits for the version to move on.  Because the version is
+     * noted first, an insert that commits between the read and the wait isn't missed.
+     *
+     * Readers register a Waiter before noting the version, so that inserts can skip notifying
+     * while nobody is waiting.  An insert checks when it is made, not when it commits, so a
+     * reader that registers in between may sleep through that insert until its wait times out.
+     *
+     * Shared between a Collection and the getMores waiting on it, which may outlive it.
+     */
+    class CappedInsertNotifier {
+        MONGO_DISALLOW_COPYING(CappedInsertNotifier);
+    public:
+        /**
+         * Counts the owner as waiting on 'notifier' for as long as it is in scope.
+         */
+        class Waiter {
+            MONGO_DISALLOW_COPYING(Waiter);
+        public:
+            explicit Waiter(const boost::shared_ptr<CappedInsertNotifier>& notifier);
+            ~Waiter();
+
+        private:
+            const boost::shared_ptr<CappedInsertNotifier> _notifier;
+        };
+
+        CappedInsertNotifier();
+
+        /** Wakes every waiter.  Called once an insert is committed. */
+        void notifyOfInsert();
+
+        /** True if any Waiter is registered, in which case inserts must call notifyOfInsert(). */
+        bool hasWaiters() const {
+            return _waiters.load() != 0;
+        }
+
+        uint64_t getVersion() const;
+
+        /**
+         * Waits until the version differs from 'referenceVersion', the notifier is killed, or
+         * 'timeoutMillis' passes, whichever comes first.
+         */
+        void waitForInsert(uint64_t referenceVersion, int timeoutMillis) const;
+
+        /** Wakes every waiter for good, when the collection goes away. */
+        void kill();
+
+        bool isDead() const;
+
+    private:
+        mutable boost::mutex _mutex;
+        mutable boost::condition_variable _notifier;
+        uint64_t _version;
+        bool _dead;
+        AtomicUInt32 _waiters;
+    };
+
+}  // namespace mongo
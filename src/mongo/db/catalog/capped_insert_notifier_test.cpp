@@ -0,0 +1,120 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "mongo/db/catalog/capped_insert_notifier.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
+
+namespace {
+
+    using mongo::CappedInsertNotifier;
+    using mongo::Timer;
+
+    TEST(CappedInsertNotifierTest, WaitTimesOutWithoutInsert) {
+        CappedInsertNotifier notifier;
+        Timer t;
+        notifier.waitForInsert(notifier.getVersion(), 50);
+        ASSERT_GREATER_THAN_OR_EQUALS(t.millis(), 40);
+    }
+
+    TEST(CappedInsertNotifierTest, InsertBeforeWaitIsNotMissed) {
+        CappedInsertNotifier notifier;
+        const uint64_t version = notifier.getVersion();
+        notifier.notifyOfInsert();
+        ASSERT_NOT_EQUALS(version, notifier.getVersion());
+
+        Timer t;
+        notifier.waitForInsert(version, 10 * 1000);
+        ASSERT_LESS_THAN(t.millis(), 5 * 1000);
+    }
+
+    void notifyAfter(CappedInsertNotifier* notifier, int millis, bool kill) {
+        mongo::sleepmillis(millis);
+        if (kill)
+            notifier->kill();
+        else
+            notifier->notifyOfInsert();
+    }
+
+    TEST(CappedInsertNotifierTest, InsertWakesWaiter) {
+        boost::shared_ptr<CappedInsertNotifier> notifier(new CappedInsertNotifier());
+        CappedInsertNotifier::Waiter waiter(notifier);
+        const uint64_t version = notifier->getVersion();
+        boost::thread inserter(mongo::stdx::bind(&notifyAfter, notifier.get(), 20, false));
+
+        Timer t;
+        notifier->waitForInsert(version, 10 * 1000);
+        ASSERT_LESS_THAN(t.millis(), 5 * 1000);
+        ASSERT_FALSE(notifier->isDead());
+        inserter.join();
+    }
+
+    TEST(CappedInsertNotifierTest, HasWaitersWhileWaiterInScope) {
+        boost::shared_ptr<CappedInsertNotifier> notifier(new CappedInsertNotifier());
+        ASSERT_FALSE(notifier->hasWaiters());
+        {
+            CappedInsertNotifier::Waiter first(notifier);
+            ASSERT_TRUE(notifier->hasWaiters());
+            {
+                CappedInsertNotifier::Waiter second(notifier);
+                ASSERT_TRUE(notifier->hasWaiters());
+            }
+            ASSERT_TRUE(notifier->hasWaiters());
+        }
+        ASSERT_FALSE(notifier->hasWaiters());
+
+        // Without waiters an insert still moves the version on.
+        const uint64_t version = notifier->getVersion();
+        notifier->notifyOfInsert();
+        ASSERT_NOT_EQUALS(version, notifier->getVersion());
+    }
+
+    TEST(CappedInsertNotifierTest, KillWakesWaiter) {
+        CappedInsertNotifier notifier;
+        boost::thread killer(mongo::stdx::bind(&notifyAfter, &notifier, 20, true));
+
+        Timer t;
+        notifier.waitForInsert(notifier.getVersion(), 10 * 1000);
+        ASSERT_LESS_THAN(t.millis(), 5 * 1000);
+        ASSERT_TRUE(notifier.isDead());
+        killer.join();
+
+        // Once dead, waits return straight away.
+        Timer again;
+        notifier.waitForInsert(notifier.getVersion(), 10 * 1000);
+        ASSERT_LESS_THAN(again.millis(), 5 * 1000);
+    }
+
+}  // namespace
@@ -54,6 +54,20 @@ namespace mongo {
 
     using logger::LogComponent;
 
+    namespace {
+        // Document bytes are charged to the client's current operation, if there is one.
+
+        void chargeBytesRead( long long bytes ) {
+            if ( haveClient() )
+                cc().curop()->resources().recordDocBytesRead( bytes );
+        }
+
+        void chargeBytesWritten( long long bytes ) {
+            if ( haveClient() )
+                cc().curop()->resources().recordDocBytesWritten( bytes );
+        }
+    }
+
     std::string CompactOptions::toString() const {
         std::stringstream ss;
         ss << "paddingMode: ";
@@ -89,12 +103,16 @@ namespace mongo {
           _cursorCache( fullNS ) {
         _magic = 1357924;
         _indexCatalog.init(txn);
-        if ( isCapped() )
+        if ( isCapped() ) {
             _recordStore->setCappedDeleteCallback( this );
+            _cappedNotifier.reset( new CappedInsertNotifier() );
+        }
     }
 
     Collection::~Collection() {
         verify( ok() );
+        if ( _cappedNotifier )
+            _cappedNotifier->kill();
         _magic = 0;
     }
 
@@ -157,7 +175,9 @@ namespace mongo {
     }
 
     BSONObj Collection::docFor(OperationContext* txn, const DiskLoc& loc) const {
-        return  _recordStore->dataFor( txn, loc ).toBson();
+        BSONObj doc = _recordStore->dataFor( txn, loc ).toBson();
+        chargeBytesRead( doc.objsize() );
+        return doc;
     }
 
     StatusWith<DiskLoc> Collection::insertDocument( OperationContext* txn,
@@ -171,6 +191,8 @@ namespace mongo {
         if ( !loc.isOK() )
             return loc;
 
+        chargeBytesWritten( doc->documentSize() );
+        _notifyCappedWaitersOnCommit( txn );
         return StatusWith<DiskLoc>( loc );
     }
 
@@ -207,10 +229,13 @@ namespace mongo {
         if ( !loc.isOK() )
             return loc;
 
+        chargeBytesWritten( doc.objsize() );
+
         Status status = indexBlock->insert( doc, loc.getValue() );
         if ( !status.isOK() )
             return StatusWith<DiskLoc>( status );
 
+        _notifyCappedWaitersOnCommit( txn );
         return loc;
     }
 
@@ -230,6 +255,8 @@ namespace mongo {
         if ( !loc.isOK() )
             return loc;
 
+        chargeBytesWritten( docToInsert.objsize() );
+
         invariant( minDiskLoc < loc.getValue() );
         invariant( loc.getValue() < maxDiskLoc );
 
@@ -252,9 +279,35 @@ namespace mongo {
             return StatusWith<DiskLoc>( e.toStatus( "insertDocument" ) );
         }
 
+        _notifyCappedWaitersOnCommit( txn );
         return loc;
     }
 
+    namespace {
+        class NotifyCappedWaitersOnCommit : public RecoveryUnit::Change {
+        public:
+            explicit NotifyCappedWaitersOnCommit(
+                    const boost::shared_ptr<CappedInsertNotifier>& notifier )
+                : _notifier( notifier ) {
+            }
+
+            virtual void commit() { _notifier->notifyOfInsert(); }
+            virtual void rollback() {}
+
+        private:
+            const boost::shared_ptr<CappedInsertNotifier> _notifier;
+        };
+    }
+
+    void Collection::_notifyCappedWaitersOnCommit( OperationContext* txn ) {
+        // Waking them any earlier could let them look before the insert is visible, then sleep
+        // through it.
+        if ( _cappedNotifier && _cappedNotifier->hasWaiters() ) {
+            txn->recoveryUnit()->registerChange(
+                new NotifyCappedWaitersOnCommit( _cappedNotifier ) );
+        }
+    }
+
     Status Collection::aboutToDeleteCapped( OperationContext* txn, const DiskLoc& loc ) {
 
         BSONObj doc = docFor( txn, loc );
@@ -304,9 +357,11 @@ namespace mongo {
                                                     const DiskLoc& oldLocation,
                                                     const BSONObj& objNew,
                                                     bool enforceQuota,
-                                                    OpDebug* debug ) {
+                                                    OpDebug* debug,
+                                                    const FieldRefSet* updatedFields ) {
 
         BSONObj objOld = _recordStore->dataFor( txn, oldLocation ).toBson();
+        chargeBytesRead( objOld.objsize() );
 
         if ( objOld.hasElement( "_id" ) ) {
             BSONElement oldId = objOld["_id"];
@@ -316,6 +371,10 @@ namespace mongo {
                                             "in Collection::updateDocument _id mismatch",
                                             13596 );
         }
+        else {
+            // an _id may have been added, which no updated path accounts for
+            updatedFields = NULL;
+        }
 
         /* duplicate key check. we descend the btree twice - once for this check, and once for the actual inserts, further
            below.  that is suboptimal, but it's pretty complicated to do it the other way without rollbacks...
@@ -324,6 +383,13 @@ namespace mongo {
         IndexCatalog::IndexIterator ii = _indexCatalog.getIndexIterator( txn, true );
         while ( ii.more() ) {
             IndexDescriptor* descriptor = ii.next();
+
+            // Keys can only change if the update touched a path the index covers.
+            if ( updatedFields &&
+                 !_infoCache.indexKeys( txn, descriptor ).mightBeIndexed( *updatedFields ) ) {
+                continue;
+            }
+
             IndexAccessMethod* iam = _indexCatalog.getIndex( descriptor );
 
             InsertDeleteOptions options;
@@ -351,6 +417,8 @@ namespace mongo {
             return newLocation;
         }
 
+        chargeBytesWritten( objNew.objsize() );
+
         _infoCache.notifyOfWriteOp();
 
         if ( newLocation.getValue() != oldLocation ) {
@@ -373,10 +441,16 @@ namespace mongo {
         ii = _indexCatalog.getIndexIterator( txn, true );
         while ( ii.more() ) {
             IndexDescriptor* descriptor = ii.next();
+            std::map<IndexDescriptor*, UpdateTicket*>::iterator ticket =
+                updateTickets.mutableMap().find( descriptor );
+            if ( ticket == updateTickets.mutableMap().end() ) {
+                // skipped above
+                continue;
+            }
             IndexAccessMethod* iam = _indexCatalog.getIndex( descriptor );
 
             int64_t updatedKeys;
-            Status ret = iam->update(txn, *updateTickets.mutableMap()[descriptor], &updatedKeys);
+            Status ret = iam->update(txn, *ticket->second, &updatedKeys);
             if ( !ret.isOK() )
                 return StatusWith<DiskLoc>( ret );
             if ( debug )
@@ -408,7 +482,14 @@ namespace mongo {
         // Broadcast the mutation so that query results stay correct.
         _cursorCache.invalidateDocument(loc, INVALIDATION_MUTATION);
 
-        return _recordStore->updateWithDamages( txn, loc, damangeSource, damages );
+        Status status = _recordStore->updateWithDamages( txn, loc, damangeSource, damages );
+        if ( status.isOK() ) {
+            long long bytes = 0;
+            for ( size_t i = 0; i < damages.size(); i++ )
+                bytes += damages[i].size;
+            chargeBytesWritten( bytes );
+        }
+        return status;
     }
 
     bool Collection::_enforceQuota( bool userEnforeQuota ) const {
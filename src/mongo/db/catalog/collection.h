@@ -30,10 +30,12 @@
 
 #pragma once
 
+#include <boost/shared_ptr.hpp>
 #include <string>
 
 #include "mongo/base/string_data.h"
 #include "mongo/bson/mutable/damage_vector.h"
+#include "mongo/db/catalog/capped_insert_notifier.h"
 #include "mongo/db/catalog/collection_cursor_cache.h"
 #include "mongo/db/catalog/collection_info_cache.h"
 #include "mongo/db/catalog/index_catalog.h"
@@ -49,6 +51,7 @@ namespace mongo {
     class CollectionCatalogEntry;
     class Database;
     class ExtentManager;
+    class FieldRefSet;
     class IndexCatalog;
     class MultiIndexBlock;
     class OperationContext;
@@ -126,6 +129,14 @@ namespace mongo {
 
         CollectionCursorCache* cursorCache() const { return &_cursorCache; }
 
+        /**
+         * Tells tailable cursors when documents are inserted.  NULL unless the collection is
+         * capped.
+         */
+        boost::shared_ptr<CappedInsertNotifier> getCappedInsertNotifier() const {
+            return _cappedNotifier;
+        }
+
         bool requiresIdIndex() const;
 
         BSONObj docFor(OperationContext* txn, const DiskLoc& loc) const;
@@ -184,13 +195,16 @@ namespace mongo {
          * updates the document @ oldLocation with newDoc
          * if the document fits in the old space, it is put there
          * if not, it is moved
+         * if updatedFields is not NULL, it holds every path that may differ between the old
+         * document and newDoc, and indexes that cover none of them are left alone
          * @return the post update location of the doc (may or may not be the same as oldLocation)
          */
         StatusWith<DiskLoc> updateDocument( OperationContext* txn,
                                             const DiskLoc& oldLocation,
                                             const BSONObj& newDoc,
                                             bool enforceQuota,
-                                            OpDebug* debug );
+                                            OpDebug* debug,
+                                            const FieldRefSet* updatedFields = NULL );
 
         /**
          * right now not allowed to modify indexes
@@ -283,6 +297,12 @@ namespace mongo {
 
         bool _enforceQuota( bool userEnforeQuota ) const;
 
+        /**
+         * Wakes tailable cursors waiting on a capped collection once the current unit of work
+         * commits.
+         */
+        void _notifyCappedWaitersOnCommit( OperationContext* txn );
+
         int _magic;
 
         NamespaceString _ns;
@@ -297,6 +317,8 @@ namespace mongo {
         // should be about the data.
         mutable CollectionCursorCache _cursorCache;
 
+        boost::shared_ptr<CappedInsertNotifier> _cappedNotifier;
+
         friend class Database;
         friend class IndexCatalog;
         friend class NamespaceDetails;
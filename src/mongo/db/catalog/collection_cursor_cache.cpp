@@ -265,6 +265,19 @@ namespace mongo {
     // --------------------------
 
 
+    const int CollectionCursorCache::kIdleTimeoutMillis;
+    const int CollectionCursorCache::kNumShards;
+
+    namespace {
+        // Idle timeouts are checked every few seconds, so finer ticks would buy nothing.
+        const long long kIdleTimeoutTickMillis = 1000;
+    }
+
+    CollectionCursorCache::CursorShard::CursorShard()
+        : mutex( "CollectionCursorCache" ),
+          idleClockMillis( 0 ) {
+    }
+
     CollectionCursorCache::CollectionCursorCache( const StringData& ns )
         : _nss( ns ),
           _mutex( "CollectionCursorCache" ) {
@@ -291,58 +304,70 @@ namespace mongo {
         }
         _nonCachedExecutors.clear();
 
-        if ( collectionGoingAway ) {
-            // we're going to wipe out the world
-            for ( CursorMap::const_iterator i = _cursors.begin(); i != _cursors.end(); ++i ) {
-                ClientCursor* cc = i->second;
+        for ( int s = 0; s < kNumShards; s++ ) {
+            CursorShard& shard = _shards[s];
+            SimpleMutex::scoped_lock shardLock( shard.mutex );
 
-                cc->kill();
-
-                invariant( cc->getExecutor() == NULL || cc->getExecutor()->collection() == NULL );
+            if ( collectionGoingAway ) {
+                // we're going to wipe out the world
+                for ( CursorMap::const_iterator i = shard.cursors.begin();
+                      i != shard.cursors.end();
+                      ++i ) {
+                    ClientCursor* cc = i->second;
 
-                // If there is a pinValue >= 100, somebody is actively using the CC and we do
-                // not delete it.  Instead we notify the holder that we killed it.  The holder
-                // will then delete the CC.
-                // pinvalue is <100, so there is nobody actively holding the CC.  We can
-                // safely delete it as nobody is holding the CC.
+                    cc->kill();
 
-                if (cc->pinValue() < 100) {
-                    delete cc;
-                }
-            }
-        }
-        else {
-            CursorMap newMap;
+                    invariant( cc->getExecutor() == NULL ||
+                               cc->getExecutor()->collection() == NULL );
 
-            // collection will still be around, just all PlanExecutors are invalid
-            for ( CursorMap::const_iterator i = _cursors.begin(); i != _cursors.end(); ++i ) {
-                ClientCursor* cc = i->second;
+                    // If there is a pinValue >= 100, somebody is actively using the CC and we do
+                    // not delete it.  Instead we notify the holder that we killed it.  The holder
+                    // will then delete the CC.
+                    // pinvalue is <100, so there is nobody actively holding the CC.  We can
+                    // safely delete it as nobody is holding the CC.
 
-                // Note that a valid ClientCursor state is "no cursor no executor."  This is because
-                // the set of active cursor IDs in ClientCursor is used as representation of query
-                // state.  See sharding_block.h.  TODO(greg,hk): Move this out.
-                if (NULL == cc->getExecutor() ) {
-                    newMap.insert( *i );
-                    continue;
+                    if (cc->pinValue() < 100) {
+                        delete cc;
+                    }
                 }
+            }
+            else {
+                CursorMap newMap;
+
+                // collection will still be around, just all PlanExecutors are invalid
+                for ( CursorMap::const_iterator i = shard.cursors.begin();
+                      i != shard.cursors.end();
+                      ++i ) {
+                    ClientCursor* cc = i->second;
+
+                    // Note that a valid ClientCursor state is "no cursor no executor."  This is
+                    // because the set of active cursor IDs in ClientCursor is used as
+                    // representation of query state.  See sharding_block.h.  TODO(greg,hk): Move
+                    // this out.
+                    if (NULL == cc->getExecutor() ) {
+                        newMap.insert( *i );
+                        continue;
+                    }
+
+                    if (cc->pinValue() >= 100 || cc->isAggCursor) {
+                        // Pinned cursors need to stay alive, so we leave them around.
+                        // Aggregation cursors also can stay alive (since they don't have their
+                        // lifetime bound to the underlying collection).  However, if they have an
+                        // associated executor, we need to kill it, because it's now invalid.
+                        if ( cc->getExecutor() )
+                            cc->getExecutor()->kill();
+                        newMap.insert( *i );
+                    }
+                    else {
+                        shard.cancelTimeout( i->first );
+                        cc->kill();
+                        delete cc;
+                    }
 
-                if (cc->pinValue() >= 100 || cc->isAggCursor) {
-                    // Pinned cursors need to stay alive, so we leave them around.  Aggregation
-                    // cursors also can stay alive (since they don't have their lifetime bound to
-                    // the underlying collection).  However, if they have an associated executor, we
-                    // need to kill it, because it's now invalid.
-                    if ( cc->getExecutor() )
-                        cc->getExecutor()->kill();
-                    newMap.insert( *i );
-                }
-                else {
-                    cc->kill();
-                    delete cc;
                 }
 
+                shard.cursors.swap( newMap );
             }
-
-            _cursors = newMap;
         }
     }
 
@@ -364,34 +389,53 @@ namespace mongo {
             exec->invalidate(dl, type);
         }
 
-        for ( CursorMap::const_iterator i = _cursors.begin(); i != _cursors.end(); ++i ) {
-            PlanExecutor* exec = i->second->getExecutor();
-            if ( exec ) {
-                exec->invalidate(dl, type);
+        for ( int s = 0; s < kNumShards; s++ ) {
+            CursorShard& shard = _shards[s];
+            SimpleMutex::scoped_lock shardLock( shard.mutex );
+            for ( CursorMap::const_iterator i = shard.cursors.begin();
+                  i != shard.cursors.end();
+                  ++i ) {
+                PlanExecutor* exec = i->second->getExecutor();
+                if ( exec ) {
+                    exec->invalidate(dl, type);
+                }
             }
         }
     }
 
     std::size_t CollectionCursorCache::timeoutCursors( int millisSinceLastCall ) {
-        SimpleMutex::scoped_lock lk( _mutex );
+        std::size_t numTimedOut = 0;
 
-        vector<ClientCursor*> toDelete;
+        for ( int s = 0; s < kNumShards; s++ ) {
+            CursorShard& shard = _shards[s];
+            SimpleMutex::scoped_lock lk( shard.mutex );
 
-        for ( CursorMap::const_iterator i = _cursors.begin(); i != _cursors.end(); ++i ) {
-            ClientCursor* cc = i->second;
-            if ( cc->shouldTimeout( millisSinceLastCall ) )
-                toDelete.push_back( cc );
-        }
+            shard.idleClockMillis += millisSinceLastCall;
+            if ( !shard.idleTimeouts )
+                continue;
+
+            vector<CursorId> expired;
+            shard.idleTimeouts->advance( shard.idleClockMillis, &expired );
+            if ( shard.idleTimeouts->size() == 0 )
+                shard.idleTimeouts.reset();
 
-        for ( vector<ClientCursor*>::const_iterator i = toDelete.begin();
-                i != toDelete.end(); ++i ) {
-            ClientCursor* cc = *i;
-            _deregisterCursor_inlock( cc );
-            cc->kill();
-            delete cc;
+            for ( vector<CursorId>::const_iterator i = expired.begin(); i != expired.end(); ++i ) {
+                CursorMap::iterator it = shard.cursors.find( *i );
+                invariant( it != shard.cursors.end() );
+
+                // Pinning a cursor stops its timeout.
+                ClientCursor* cc = it->second;
+                invariant( cc->_pinValue == 0 );
+
+                _deregisterCursor_inlock( shard, cc );
+                cc->kill();
+                delete cc;
+            }
+
+            numTimedOut += expired.size();
         }
 
-        return toDelete.size();
+        return numTimedOut;
     }
 
     void CollectionCursorCache::registerExecutor( PlanExecutor* exec ) {
@@ -406,9 +450,10 @@ namespace mongo {
     }
 
     ClientCursor* CollectionCursorCache::find( CursorId id, bool pin ) {
-        SimpleMutex::scoped_lock lk( _mutex );
-        CursorMap::const_iterator it = _cursors.find( id );
-        if ( it == _cursors.end() )
+        CursorShard& shard = _shardFor( id );
+        SimpleMutex::scoped_lock lk( shard.mutex );
+        CursorMap::const_iterator it = shard.cursors.find( id );
+        if ( it == shard.cursors.end() )
             return NULL;
 
         ClientCursor* cursor = it->second;
@@ -417,60 +462,77 @@ namespace mongo {
                      "clientcursor already in use? driver problem?",
                      cursor->_pinValue < 100 );
             cursor->_pinValue += 100;
+            shard.cancelTimeout( id );
         }
 
         return cursor;
     }
 
     void CollectionCursorCache::unpin( ClientCursor* cursor ) {
-        SimpleMutex::scoped_lock lk( _mutex );
+        CursorShard& shard = _shardFor( cursor->cursorid() );
+        SimpleMutex::scoped_lock lk( shard.mutex );
 
         invariant( cursor->_pinValue >= 100 );
         cursor->_pinValue -= 100;
+        _scheduleTimeout_inlock( shard, cursor->cursorid(), cursor );
     }
 
     void CollectionCursorCache::getCursorIds( std::set<CursorId>* openCursors ) {
-        SimpleMutex::scoped_lock lk( _mutex );
+        for ( int s = 0; s < kNumShards; s++ ) {
+            CursorShard& shard = _shards[s];
+            SimpleMutex::scoped_lock lk( shard.mutex );
 
-        for ( CursorMap::const_iterator i = _cursors.begin(); i != _cursors.end(); ++i ) {
-            ClientCursor* cc = i->second;
-            openCursors->insert( cc->cursorid() );
+            for ( CursorMap::const_iterator i = shard.cursors.begin();
+                  i != shard.cursors.end();
+                  ++i ) {
+                ClientCursor* cc = i->second;
+                openCursors->insert( cc->cursorid() );
+            }
         }
     }
 
     size_t CollectionCursorCache::numCursors(){
-        SimpleMutex::scoped_lock lk( _mutex );
-        return _cursors.size();
+        size_t count = 0;
+        for ( int s = 0; s < kNumShards; s++ ) {
+            CursorShard& shard = _shards[s];
+            SimpleMutex::scoped_lock lk( shard.mutex );
+            count += shard.cursors.size();
+        }
+        return count;
     }
 
-    CursorId CollectionCursorCache::_allocateCursorId_inlock() {
+    CursorId CollectionCursorCache::registerCursor( ClientCursor* cc ) {
+        invariant( cc );
         for ( int i = 0; i < 10000; i++ ) {
-            unsigned mypart = static_cast<unsigned>( _random->nextInt32() );
+            unsigned mypart;
+            {
+                SimpleMutex::scoped_lock lk( _mutex );
+                mypart = static_cast<unsigned>( _random->nextInt32() );
+            }
             CursorId id = cursorIdFromParts( _collectionCacheRuntimeId, mypart );
-            if ( _cursors.count( id ) == 0 )
+
+            CursorShard& shard = _shardFor( id );
+            SimpleMutex::scoped_lock lk( shard.mutex );
+            if ( shard.cursors.insert( std::make_pair( id, cc ) ).second ) {
+                _scheduleTimeout_inlock( shard, id, cc );
                 return id;
+            }
         }
         fassertFailed( 17360 );
     }
 
-    CursorId CollectionCursorCache::registerCursor( ClientCursor* cc ) {
-        invariant( cc );
-        SimpleMutex::scoped_lock lk( _mutex );
-        CursorId id = _allocateCursorId_inlock();
-        _cursors[id] = cc;
-        return id;
-    }
-
     void CollectionCursorCache::deregisterCursor( ClientCursor* cc ) {
-        SimpleMutex::scoped_lock lk( _mutex );
-        _deregisterCursor_inlock( cc );
+        CursorShard& shard = _shardFor( cc->cursorid() );
+        SimpleMutex::scoped_lock lk( shard.mutex );
+        _deregisterCursor_inlock( shard, cc );
     }
 
     bool CollectionCursorCache::eraseCursor(OperationContext* txn, CursorId id, bool checkAuth) {
-        SimpleMutex::scoped_lock lk( _mutex );
+        CursorShard& shard = _shardFor( id );
+        SimpleMutex::scoped_lock lk( shard.mutex );
 
-        CursorMap::iterator it = _cursors.find( id );
-        if ( it == _cursors.end() ) {
+        CursorMap::iterator it = shard.cursors.find( id );
+        if ( it == shard.cursors.end() ) {
             if ( checkAuth )
                 audit::logKillCursorsAuthzCheck( txn->getClient(),
                                                  _nss,
@@ -492,15 +554,29 @@ namespace mongo {
                  cursor->pinValue() < 100 );
 
         cursor->kill();
-        _deregisterCursor_inlock( cursor );
+        _deregisterCursor_inlock( shard, cursor );
         delete cursor;
         return true;
     }
 
-    void CollectionCursorCache::_deregisterCursor_inlock( ClientCursor* cc ) {
+    void CollectionCursorCache::_deregisterCursor_inlock( CursorShard& shard, ClientCursor* cc ) {
         invariant( cc );
         CursorId id = cc->cursorid();
-        _cursors.erase( id );
+        shard.cursors.erase( id );
+        shard.cancelTimeout( id );
+    }
+
+    void CollectionCursorCache::_scheduleTimeout_inlock( CursorShard& shard,
+                                                         CursorId id,
+                                                         ClientCursor* cc ) {
+        // A pinValue of 1 marks a cursor that never times out.
+        if ( cc->_pinValue != 0 )
+            return;
+
+        if ( !shard.idleTimeouts )
+            shard.idleTimeouts.reset( new TimerWheel( kIdleTimeoutTickMillis,
+                                                      shard.idleClockMillis ) );
+        shard.idleTimeouts->schedule( id, shard.idleClockMillis + kIdleTimeoutMillis );
     }
 
 }
@@ -34,8 +34,10 @@
 #include "mongo/db/diskloc.h"
 #include "mongo/db/invalidation_type.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/platform/unordered_map.h"
 #include "mongo/platform/unordered_set.h"
 #include "mongo/util/concurrency/mutex.h"
+#include "mongo/util/timer_wheel.h"
 
 namespace mongo {
 
@@ -43,8 +45,19 @@ namespace mongo {
     class PseudoRandom;
     class PlanExecutor;
 
+    /**
+     * The cursors open on one collection, and the executors that must hear about changes to it.
+     *
+     * Cursors are split by id over kNumShards shards, each with its own lock, so that getMores
+     * on different cursors of a busy collection don't wait on each other.  Each shard keeps the
+     * idle timeouts of its unpinned cursors in a TimerWheel, so timing cursors out costs time
+     * in proportion to the cursors that expire rather than to all that are open.
+     */
     class CollectionCursorCache {
     public:
+        // Unpinned cursors are deleted after this long without use.
+        static const int kIdleTimeoutMillis = 10 * 60 * 1000;
+
         CollectionCursorCache( const StringData& ns );
 
         /**
@@ -71,6 +84,7 @@ namespace mongo {
         /*
          * timesout cursors that have been idle for too long
          * note: must have a readlock on the collection
+         * @param millisSinceLastCall how far to move the idle clock forward
          * @return number timed out
          */
         std::size_t timeoutCursors( int millisSinceLastCall );
@@ -122,20 +136,50 @@ namespace mongo {
         static std::size_t timeoutCursorsGlobal(OperationContext* txn, int millisSinceLastCall);
 
     private:
-        CursorId _allocateCursorId_inlock();
-        void _deregisterCursor_inlock( ClientCursor* cc );
+        static const int kNumShards = 16;
+
+        typedef unordered_map<CursorId,ClientCursor*> CursorMap;
+
+        struct CursorShard {
+            CursorShard();
+
+            SimpleMutex mutex;
+            CursorMap cursors;
+
+            void cancelTimeout( CursorId id ) {
+                if ( idleTimeouts )
+                    idleTimeouts->cancel( id );
+            }
+
+            // Deadlines of the unpinned cursors that can time out, on 'idleClockMillis', a clock
+            // which only moves when timeoutCursors() is called.  A wheel is several KB, so it is
+            // only created once the shard has a cursor to time out, and freed once it is empty.
+            scoped_ptr<TimerWheel> idleTimeouts;
+            long long idleClockMillis;
+        };
+
+        CursorShard& _shardFor( CursorId id ) {
+            return _shards[static_cast<uint64_t>( id ) % kNumShards];
+        }
+
+        void _deregisterCursor_inlock( CursorShard& shard, ClientCursor* cc );
+
+        /**
+         * (Re)starts the idle timeout of cursor 'id' if nothing holds it pinned.
+         */
+        static void _scheduleTimeout_inlock( CursorShard& shard, CursorId id, ClientCursor* cc );
 
         NamespaceString _nss;
         unsigned _collectionCacheRuntimeId;
-        scoped_ptr<PseudoRandom> _random;
 
+        // Protects _random and _nonCachedExecutors.  Taken before any shard's mutex.
         SimpleMutex _mutex;
+        scoped_ptr<PseudoRandom> _random;
 
         typedef unordered_set<PlanExecutor*> ExecSet;
         ExecSet _nonCachedExecutors;
 
-        typedef std::map<CursorId,ClientCursor*> CursorMap;
-        CursorMap _cursors;
+        CursorShard _shards[kNumShards];
     };
 
 }
@@ -60,50 +60,75 @@ namespace mongo {
         // index filters should persist throughout life of collection
     }
 
-    void CollectionInfoCache::computeIndexKeys( OperationContext* txn ) {
-        _indexedPaths.clear();
-
-        IndexCatalog::IndexIterator i = _collection->getIndexCatalog()->getIndexIterator(txn, true);
-        while (i.more()) {
-            IndexDescriptor* descriptor = i.next();
+namespace {
+
+    void addIndexedPaths(const IndexDescriptor* descriptor, UpdateIndexData* indexedPaths) {
+        if (descriptor->getAccessMethodName() != IndexNames::TEXT) {
+            BSONObj key = descriptor->keyPattern();
+            BSONObjIterator j(key);
+            while (j.more()) {
+                BSONElement e = j.next();
+                indexedPaths->addPath(e.fieldName());
+            }
+        }
+        else {
+            fts::FTSSpec ftsSpec(descriptor->infoObj());
 
-            if (descriptor->getAccessMethodName() != IndexNames::TEXT) {
-                BSONObj key = descriptor->keyPattern();
-                BSONObjIterator j(key);
-                while (j.more()) {
-                    BSONElement e = j.next();
-                    _indexedPaths.addPath(e.fieldName());
-                }
+            if (ftsSpec.wildcard()) {
+                indexedPaths->allPathsIndexed();
             }
             else {
-                fts::FTSSpec ftsSpec(descriptor->infoObj());
-
-                if (ftsSpec.wildcard()) {
-                    _indexedPaths.allPathsIndexed();
+                for (size_t i = 0; i < ftsSpec.numExtraBefore(); ++i) {
+                    indexedPaths->addPath(ftsSpec.extraBefore(i));
+                }
+                for (fts::Weights::const_iterator it = ftsSpec.weights().begin();
+                     it != ftsSpec.weights().end();
+                     ++it) {
+                    indexedPaths->addPath(it->first);
                 }
-                else {
-                    for (size_t i = 0; i < ftsSpec.numExtraBefore(); ++i) {
-                        _indexedPaths.addPath(ftsSpec.extraBefore(i));
-                    }
-                    for (fts::Weights::const_iterator it = ftsSpec.weights().begin();
-                         it != ftsSpec.weights().end();
-                         ++it) {
-                        _indexedPaths.addPath(it->first);
-                    }
-                    for (size_t i = 0; i < ftsSpec.numExtraAfter(); ++i) {
-                        _indexedPaths.addPath(ftsSpec.extraAfter(i));
-                    }
-                    // Any update to a path containing "language" as a component could change the
-                    // language of a subdocument.  Add the override field as a path component.
-                    _indexedPaths.addPathComponent(ftsSpec.languageOverrideField());
+                for (size_t i = 0; i < ftsSpec.numExtraAfter(); ++i) {
+                    indexedPaths->addPath(ftsSpec.extraAfter(i));
                 }
+                // Any update to a path containing "language" as a component could change the
+                // language of a subdocument.  Add the override field as a path component.
+                indexedPaths->addPathComponent(ftsSpec.languageOverrideField());
             }
         }
+    }
+
+} // namespace
+
+    void CollectionInfoCache::computeIndexKeys( OperationContext* txn ) {
+        _indexedPaths.clear();
+        _indexedPathsByIndex.clear();
+
+        IndexCatalog::IndexIterator i = _collection->getIndexCatalog()->getIndexIterator(txn, true);
+        while (i.more()) {
+            IndexDescriptor* descriptor = i.next();
+            addIndexedPaths(descriptor, &_indexedPaths);
+            addIndexedPaths(descriptor, &_indexedPathsByIndex[descriptor]);
+        }
 
         _keysComputed = true;
 
     }
 
+    const UpdateIndexData& CollectionInfoCache::indexKeys( OperationContext* txn,
+                                                           const IndexDescriptor* descriptor ) {
+        if ( !_keysComputed )
+            computeIndexKeys( txn );
+
+        std::map<const IndexDescriptor*, UpdateIndexData>::iterator it =
+            _indexedPathsByIndex.find( descriptor );
+        if ( it == _indexedPathsByIndex.end() ) {
+            // not ready when the keys were computed
+            it = _indexedPathsByIndex.insert( std::make_pair( descriptor,
+                                                              UpdateIndexData() ) ).first;
+            addIndexedPaths( descriptor, &it->second );
+        }
+        return it->second;
+    }
+
     void CollectionInfoCache::notifyOfWriteOp() {
         if (NULL != _planCache.get()) {
             _planCache->notifyOfWriteOp();
@@ -31,6 +31,7 @@
 #pragma once
 
 #include <boost/scoped_ptr.hpp>
+#include <map>
 
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/query_settings.h"
@@ -39,6 +40,7 @@
 namespace mongo {
 
     class Collection;
+    class IndexDescriptor;
 
     /**
      * this is for storing things that you want to cache about a single collection
@@ -79,6 +81,12 @@ namespace mongo {
             return _indexedPaths;
         }
 
+        /* the same as above, but for a single index.  an update that touches none of these
+           paths leaves that index's keys for the document unchanged.
+        */
+        const UpdateIndexData& indexKeys( OperationContext* txn,
+                                          const IndexDescriptor* descriptor );
+
         // ---------------------
 
         /**
@@ -98,6 +106,7 @@ namespace mongo {
         // ---  index keys cache
         bool _keysComputed;
         UpdateIndexData _indexedPaths;
+        std::map<const IndexDescriptor*, UpdateIndexData> _indexedPathsByIndex;
 
         // A cache for query plans.
         boost::scoped_ptr<PlanCache> _planCache;
@@ -472,6 +472,9 @@ namespace mongo {
         
         s << " ";
         curop.lockStat().report( s );
+
+        s << " ";
+        curop.resources().report( s );
         
         OPDEBUG_TOSTRING_HELP( nreturned );
         if ( responseLength > 0 )
@@ -556,6 +559,10 @@ namespace mongo {
         b.appendNumber( "numYield" , curop.numYields() );
         b.append( "lockStats" , curop.lockStat().report() );
 
+        BSONObjBuilder resources( b.subobjStart( "resources" ) );
+        curop.resources().totals().append( &resources );
+        resources.done();
+
         if ( ! exceptionInfo.empty() )
             exceptionInfo.append( b , "exception" , "exceptionCode" );
 
@@ -98,7 +98,6 @@ namespace mongo {
 
         isAggCursor = false;
 
-        _idleAgeMillis = 0;
         _leftoverMaxTimeMicros = 0;
         _pinValue = 0;
         _pos = 0;
@@ -153,15 +152,6 @@ namespace mongo {
     // Timing and timeouts
     //
 
-    bool ClientCursor::shouldTimeout(int millis) {
-        _idleAgeMillis += millis;
-        return _idleAgeMillis > 600000 && _pinValue == 0;
-    }
-
-    void ClientCursor::setIdleTime( int millis ) {
-        _idleAgeMillis = millis;
-    }
-
     void ClientCursor::updateSlaveLocation(OperationContext* txn, CurOp& curop) {
         if (_slaveReadTill.isNull())
             return;
@@ -94,14 +94,6 @@ namespace mongo {
         // Timing and timeouts
         //
 
-        /**
-         * @param millis amount of idle passed time since last call
-         * note called outside of locks (other than ccmutex) so care must be exercised
-         */
-        bool shouldTimeout( int millis );
-        void setIdleTime( int millis );
-        int idleTime() const { return _idleAgeMillis; }
-
         uint64_t getLeftoverMaxTimeMicros() const { return _leftoverMaxTimeMicros; }
         void setLeftoverMaxTimeMicros( uint64_t leftoverMaxTimeMicros ) {
             _leftoverMaxTimeMicros = leftoverMaxTimeMicros;
@@ -232,9 +224,6 @@ namespace mongo {
         // TODO: document better.
         OpTime _slaveReadTill;
 
-        // How long has the cursor been idle?
-        int _idleAgeMillis;
-
         // TODO: Document.
         uint64_t _leftoverMaxTimeMicros;
 
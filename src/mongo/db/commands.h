@@ -220,12 +220,12 @@ namespace mutablebson {
         static std::map<std::string,Command*> * _webCommands;
 
         // Counters for how many times this command has been executed and failed
-        Counter64 _commandsExecuted;
-        Counter64 _commandsFailed;
+        ShardedCounter64 _commandsExecuted;
+        ShardedCounter64 _commandsFailed;
 
         // Pointers to hold the metrics tree references
-        ServerStatusMetricField<Counter64> _commandsExecutedMetric;
-        ServerStatusMetricField<Counter64> _commandsFailedMetric;
+        ServerStatusMetricField<ShardedCounter64> _commandsExecutedMetric;
+        ServerStatusMetricField<ShardedCounter64> _commandsFailedMetric;
 
     public:
         // Stops all index builds required to run this command and returns index builds killed.
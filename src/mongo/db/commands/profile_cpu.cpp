@@ -0,0 +1,173 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+/**
+ * The profileCpu command samples the stacks of all threads in mongod for a few seconds and
+ * returns them aggregated in the "folded" format that flame graph tools read:
+ *
+ *     { profileCpu: 1, durationSecs: 5, frequencyHz: 100, maxStacks: 1000 }
+ *
+ * Unlike _cpuProfilerStart/_cpuProfilerStop, it needs no special build and writes nothing on
+ * the server host.  See CpuSampler.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "mongo/db/auth/action_set.h"
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/privilege.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/util/cpu_sampler.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/timer.h"
+
+namespace mongo {
+
+    namespace {
+
+        // Leave room in the reply for everything besides the stacks.
+        const int kMaxStacksBytes = BSONObjMaxUserSize / 2;
+
+        /**
+         * Reads the optional number 'fieldName' from 'cmdObj' into '*out', leaving it unchanged
+         * if the field is absent.
+         */
+        Status readIntOption(const BSONObj& cmdObj, StringData fieldName, int* out) {
+            BSONElement e = cmdObj[fieldName];
+            if (e.eoo())
+                return Status::OK();
+            if (!e.isNumber()) {
+                return Status(ErrorCodes::TypeMismatch, str::stream()
+                              << "'" << fieldName << "' must be a number");
+            }
+            *out = e.numberInt();
+            return Status::OK();
+        }
+
+        bool moreSamples(const std::pair<long long, const std::string*>& lhs,
+                         const std::pair<long long, const std::string*>& rhs) {
+            if (lhs.first != rhs.first)
+                return lhs.first > rhs.first;
+            return *lhs.second < *rhs.second;
+        }
+
+        class ProfileCpuCmd : public Command {
+        public:
+            ProfileCpuCmd() : Command("profileCpu") {}
+
+            virtual bool slaveOk() const { return true; }
+            virtual bool adminOnly() const { return true; }
+            virtual bool isWriteCommandForConfigServer() const { return false; }
+            virtual void help(std::stringstream& help) const {
+                help << "samples the stacks of running threads, in folded flame graph format\n"
+                     << "{ profileCpu : 1 , durationSecs : <int> , frequencyHz : <int> ,"
+                     << " maxStacks : <int> }";
+            }
+            virtual void addRequiredPrivileges(const std::string& dbname,
+                                               const BSONObj& cmdObj,
+                                               std::vector<Privilege>* out) {
+                ActionSet actions;
+                actions.addAction(ActionType::cpuProfiler);
+                out->push_back(Privilege(ResourcePattern::forClusterResource(), actions));
+            }
+
+            virtual bool run(OperationContext* txn,
+                             const std::string& dbname,
+                             BSONObj& cmdObj,
+                             int options,
+                             std::string& errmsg,
+                             BSONObjBuilder& result,
+                             bool fromRepl) {
+                int durationSecs = 5;
+                int frequencyHz = 100;
+                int maxStacks = 1000;
+                Status status = readIntOption(cmdObj, "durationSecs", &durationSecs);
+                if (status.isOK())
+                    status = readIntOption(cmdObj, "frequencyHz", &frequencyHz);
+                if (status.isOK())
+                    status = readIntOption(cmdObj, "maxStacks", &maxStacks);
+                if (status.isOK() &&
+                    (durationSecs < 1 || durationSecs > CpuSampler::kMaxDurationMillis / 1000)) {
+                    status = Status(ErrorCodes::BadValue, str::stream()
+                                    << "durationSecs must be between 1 and "
+                                    << CpuSampler::kMaxDurationMillis / 1000);
+                }
+                if (status.isOK() && maxStacks < 1) {
+                    status = Status(ErrorCodes::BadValue, "maxStacks must be positive");
+                }
+                if (!status.isOK())
+                    return appendCommandStatus(result, status);
+
+                // No locks are held while sampling, so the rest of the server runs as usual.
+                CpuSampler::Result samples;
+                Timer elapsed;
+                status = CpuSampler::sample(durationSecs * 1000, frequencyHz, &samples);
+                if (!status.isOK())
+                    return appendCommandStatus(result, status);
+
+                result.append("samples", samples.samples);
+                result.append("dropped", samples.dropped);
+                result.append("durationMillis", elapsed.millis());
+                result.append("frequencyHz", frequencyHz);
+
+                std::vector<std::pair<long long, const std::string*> > byCount;
+                byCount.reserve(samples.stacks.size());
+                for (CpuSampler::FoldedStacks::const_iterator it = samples.stacks.begin();
+                     it != samples.stacks.end(); ++it) {
+                    byCount.push_back(std::make_pair(it->second, &it->first));
+                }
+                std::sort(byCount.begin(), byCount.end(), moreSamples);
+
+                bool truncated = false;
+                BSONArrayBuilder stacks(result.subarrayStart("stacks"));
+                for (size_t i = 0; i < byCount.size(); ++i) {
+                    if (static_cast<int>(i) >= maxStacks || stacks.len() > kMaxStacksBytes) {
+                        truncated = true;
+                        break;
+                    }
+                    BSONObjBuilder stack(stacks.subobjStart());
+                    stack.append("stack", *byCount[i].second);
+                    stack.append("count", byCount[i].first);
+                    stack.doneFast();
+                }
+                stacks.doneFast();
+                result.append("truncated", truncated);
+                return true;
+            }
+
+        } profileCpuCmd;
+
+    }  // namespace
+
+}  // namespace mongo
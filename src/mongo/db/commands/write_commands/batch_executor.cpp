@@ -506,7 +506,8 @@ namespace mongo {
     // HELPERS FOR CUROP MANAGEMENT AND GLOBAL STATS
     //
 
-    static CurOp* beginCurrentOp( Client* client, const BatchItemRef& currWrite ) {
+    static CurOp* beginCurrentOp( OperationContext* txn, const BatchItemRef& currWrite ) {
+        Client* client = txn->getClient();
 
         // Execute the write item as a child operation of the current operation.
         auto_ptr<CurOp> currentOp( new CurOp( client, client->curop() ) );
@@ -517,6 +518,7 @@ namespace mongo {
         // TODO Modify CurOp "wrapped" constructor to take an opcode, so calling .reset()
         // is unneeded
         currentOp->reset( remote, getOpCode( currWrite.getRequest()->getBatchType() ) );
+        currentOp->resources().startLockWaits( *txn->lockState() );
         currentOp->ensureStarted();
         currentOp->setNS( currWrite.getRequest()->getNS() );
 
@@ -604,6 +606,8 @@ namespace mongo {
         currentOp->done();
         int executionTime = currentOp->debug().executionTime = currentOp->totalTimeMillis();
         currentOp->debug().recordStats();
+        currentOp->resources().finishLockWaits( *txn->lockState() );
+        currentOp->recordResourceUsage();
 
         if ( opError ) {
             currentOp->debug().exceptionInfo = ExceptionInfo( opError->getErrMessage(),
@@ -858,7 +862,7 @@ namespace mongo {
                                          WriteErrorDetail** error ) {
 
         // BEGIN CURRENT OP
-        scoped_ptr<CurOp> currentOp( beginCurrentOp( _txn->getClient(), updateItem ) );
+        scoped_ptr<CurOp> currentOp( beginCurrentOp( _txn, updateItem ) );
         incOpStats( updateItem );
 
         WriteOpResult result;
@@ -884,7 +888,7 @@ namespace mongo {
         // Removes are similar to updates, but page faults are handled externally
 
         // BEGIN CURRENT OP
-        scoped_ptr<CurOp> currentOp( beginCurrentOp( _txn->getClient(), removeItem ) );
+        scoped_ptr<CurOp> currentOp( beginCurrentOp( _txn, removeItem ) );
         incOpStats( removeItem );
 
         WriteOpResult result;
@@ -1024,7 +1028,7 @@ namespace mongo {
 
     void WriteBatchExecutor::execOneInsert(ExecInsertsState* state, WriteErrorDetail** error) {
         BatchItemRef currInsertItem(state->request, state->currIndex);
-        scoped_ptr<CurOp> currentOp(beginCurrentOp(_txn->getClient(), currInsertItem));
+        scoped_ptr<CurOp> currentOp(beginCurrentOp(_txn, currInsertItem));
         incOpStats(currInsertItem);
 
         WriteOpResult result;
@@ -94,10 +94,10 @@ namespace mongo {
             "Collection",
             "Document",
         };
+    }
 
-        inline const char* resourceTypeName(ResourceType resourceType) {
-            return ResourceTypeNames[resourceType];
-        }
+    const char* resourceTypeName(ResourceType resourceType) {
+        return ResourceTypeNames[resourceType];
     }
 
 
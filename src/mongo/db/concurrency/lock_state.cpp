@@ -34,6 +34,7 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/timer.h"
 
 
 namespace mongo {
@@ -323,6 +324,9 @@ namespace mongo {
           _scopedLk(NULL),
           _lockPending(false) {
 
+        for (int i = 0; i < RESOURCE_LAST; i++) {
+            _lockWaitMicros[i] = 0;
+        }
     }
 
     LockerImpl::LockerImpl() 
@@ -334,6 +338,9 @@ namespace mongo {
           _scopedLk(NULL),
           _lockPending(false) {
 
+        for (int i = 0; i < RESOURCE_LAST; i++) {
+            _lockWaitMicros[i] = 0;
+        }
     }
 
     LockerImpl::~LockerImpl() {
@@ -494,8 +501,11 @@ namespace mongo {
             }
 
             // Do the blocking outside of the flush lock (if not in a write unit of work)
+            Timer waitTimer;
             result = _notify.wait(timeoutMs);
 
+            _lockWaitMicros[resId.getType()] += waitTimer.micros();
+
             if (unlockedFlushLock) {
                 // We cannot obey the timeout here, because it is not correct to return from the
                 // lock request with the flush lock released.
@@ -152,6 +152,9 @@ namespace mongo {
         std::queue<ResourceId> _resourcesToUnlockAtEndOfUnitOfWork;
         int _wuowNestingLevel; // if > 0 we are inside of a WriteUnitOfWork
 
+        // Time spent blocked in lock(), by the type of the resource requested.
+        long long _lockWaitMicros[RESOURCE_LAST];
+
 
         //////////////////////////////////////////////////////////////////////////////////////////
         //
@@ -196,6 +199,10 @@ namespace mongo {
         virtual void recordLockTime() { _scopedLk->recordTime(); }
         virtual void resetLockTime() { _scopedLk->resetTime(); }
 
+        virtual long long getLockWaitMicros(ResourceType type) const {
+            return _lockWaitMicros[type];
+        }
+
         virtual void setIsBatchWriter(bool newValue) { _batchWriter = newValue; }
         virtual bool isBatchWriter() const { return _batchWriter; }
         virtual void setLockPendingParallelWriter(bool newValue) { 
@@ -91,6 +91,25 @@ namespace mongo {
         ASSERT(locker2.unlockAll());
     }
 
+    TEST(LockerImpl, CountsLockWaits) {
+        const ResourceId resId(RESOURCE_COLLECTION, std::string("TestDB.collection"));
+
+        LockerImpl locker1(1);
+        ASSERT(LOCK_OK == locker1.lockGlobal(MODE_IX));
+        ASSERT(LOCK_OK == locker1.lock(resId, MODE_X));
+
+        LockerImpl locker2(2);
+        ASSERT(LOCK_OK == locker2.lockGlobal(MODE_IX));
+        ASSERT_EQUALS(0, locker2.getLockWaitMicros(RESOURCE_COLLECTION));
+        ASSERT(LOCK_TIMEOUT == locker2.lock(resId, MODE_S, 10));
+        ASSERT_GREATER_THAN(locker2.getLockWaitMicros(RESOURCE_COLLECTION), 0);
+        ASSERT_EQUALS(0, locker2.getLockWaitMicros(RESOURCE_DATABASE));
+        ASSERT_EQUALS(0, locker1.getLockWaitMicros(RESOURCE_COLLECTION));
+
+        ASSERT(locker1.unlockAll());
+        ASSERT(locker2.unlockAll());
+    }
+
     TEST(LockerImpl, ConflictUpgradeWithTimeout) {
         const ResourceId resId(RESOURCE_COLLECTION, std::string("TestDB.collection"));
 
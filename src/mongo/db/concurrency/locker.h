@@ -241,6 +241,12 @@ namespace mongo {
         virtual void recordLockTime() = 0;
         virtual void resetLockTime() = 0;
 
+        /**
+         * The total time this locker has spent blocked waiting for locks on resources of type
+         * 'type'.  Operations note it when they start and finish to learn their own waits.
+         */
+        virtual long long getLockWaitMicros(ResourceType type) const = 0;
+
         // Used for the replication parallel log op application threads
         virtual void setIsBatchWriter(bool newValue) = 0;
         virtual bool isBatchWriter() const = 0;
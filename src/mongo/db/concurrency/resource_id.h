@@ -61,6 +61,11 @@ namespace mongo {
     // We only use 3 bits for the resource type in the ResourceId hash
     BOOST_STATIC_ASSERT(RESOURCE_LAST < 8);
 
+    /**
+     * Maps the resource type to a human-readable string.
+     */
+    const char* resourceTypeName(ResourceType resourceType);
+
 
     /**
      * Uniquely identifies a lockable resource.
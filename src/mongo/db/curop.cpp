@@ -82,6 +82,7 @@ namespace mongo {
         _numYields = 0;
         _expectedLatencyMs = 0;
         _lockStat.reset();
+        _resources.reset();
     }
 
     void CurOp::reset() {
@@ -123,6 +124,7 @@ namespace mongo {
 
     CurOp::~CurOp() {
         if ( _wrapped ) {
+            _wrapped->_resources.addNested( _resources );
             scoped_lock bl(Client::clientsMutex);
             _client->_curOp = _wrapped;
         }
@@ -158,6 +160,11 @@ namespace mongo {
         Top::global.record(nsStr, _op, isWriteLocked ? 1 : -1, micros, _isCommand);
     }
 
+    void CurOp::recordResourceUsage() const {
+        // Nested operations have recorded their own usage already.
+        Top::global.recordResources(_ns.toString(), _resources.ownTotals());
+    }
+
     void CurOp::reportState(BSONObjBuilder* builder) {
         builder->append("opid", _opNum);
         bool a = _active && _start;
@@ -207,6 +214,10 @@ namespace mongo {
 
         builder->append( "numYields" , _numYields );
         builder->append( "lockStats" , _lockStat.report() );
+
+        BSONObjBuilder resources( builder->subobjStart( "resources" ) );
+        _resources.totals().append( &resources );
+        resources.done();
     }
 
     BSONObj CurOp::description() {
@@ -263,28 +274,28 @@ namespace mongo {
 
     AtomicUInt32 CurOp::_nextOpNum;
 
-    static Counter64 returnedCounter;
-    static Counter64 insertedCounter;
-    static Counter64 updatedCounter;
-    static Counter64 deletedCounter;
-    static Counter64 scannedCounter;
-    static Counter64 scannedObjectCounter;
-
-    static ServerStatusMetricField<Counter64> displayReturned( "document.returned", &returnedCounter );
-    static ServerStatusMetricField<Counter64> displayUpdated( "document.updated", &updatedCounter );
-    static ServerStatusMetricField<Counter64> displayInserted( "document.inserted", &insertedCounter );
-    static ServerStatusMetricField<Counter64> displayDeleted( "document.deleted", &deletedCounter );
-    static ServerStatusMetricField<Counter64> displayScanned( "queryExecutor.scanned", &scannedCounter );
-    static ServerStatusMetricField<Counter64> displayScannedObjects( "queryExecutor.scannedObjects",
+    static ShardedCounter64 returnedCounter;
+    static ShardedCounter64 insertedCounter;
+    static ShardedCounter64 updatedCounter;
+    static ShardedCounter64 deletedCounter;
+    static ShardedCounter64 scannedCounter;
+    static ShardedCounter64 scannedObjectCounter;
+
+    static ServerStatusMetricField<ShardedCounter64> displayReturned( "document.returned", &returnedCounter );
+    static ServerStatusMetricField<ShardedCounter64> displayUpdated( "document.updated", &updatedCounter );
+    static ServerStatusMetricField<ShardedCounter64> displayInserted( "document.inserted", &insertedCounter );
+    static ServerStatusMetricField<ShardedCounter64> displayDeleted( "document.deleted", &deletedCounter );
+    static ServerStatusMetricField<ShardedCounter64> displayScanned( "queryExecutor.scanned", &scannedCounter );
+    static ServerStatusMetricField<ShardedCounter64> displayScannedObjects( "queryExecutor.scannedObjects",
                                                                      &scannedObjectCounter );
 
-    static Counter64 idhackCounter;
-    static Counter64 scanAndOrderCounter;
-    static Counter64 fastmodCounter;
+    static ShardedCounter64 idhackCounter;
+    static ShardedCounter64 scanAndOrderCounter;
+    static ShardedCounter64 fastmodCounter;
 
-    static ServerStatusMetricField<Counter64> displayIdhack( "operation.idhack", &idhackCounter );
-    static ServerStatusMetricField<Counter64> displayScanAndOrder( "operation.scanAndOrder", &scanAndOrderCounter );
-    static ServerStatusMetricField<Counter64> displayFastMod( "operation.fastmod", &fastmodCounter );
+    static ServerStatusMetricField<ShardedCounter64> displayIdhack( "operation.idhack", &idhackCounter );
+    static ServerStatusMetricField<ShardedCounter64> displayScanAndOrder( "operation.scanAndOrder", &scanAndOrderCounter );
+    static ServerStatusMetricField<ShardedCounter64> displayFastMod( "operation.fastmod", &fastmodCounter );
 
     void OpDebug::recordStats() {
         if ( nreturned > 0 )
@@ -34,6 +34,7 @@
 #include "mongo/db/client.h"
 #include "mongo/db/concurrency/lock_stat.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/stats/operation_resources.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/util/concurrency/spin_lock.h"
 #include "mongo/util/net/hostandport.h"
@@ -314,10 +315,19 @@ namespace mongo {
         void setExpectedLatencyMs( long long latency ) { _expectedLatencyMs = latency; }
 
         void recordGlobalTime(bool isWriteLocked, long long micros) const;
+
+        /**
+         * adds the resources this operation used, less those of the nested operations it ran,
+         * to its namespace's totals in Top
+         */
+        void recordResourceUsage() const;
         
         const LockStat& lockStat() const { return _lockStat; }
         LockStat& lockStat() { return _lockStat; }
 
+        const OperationResources& resources() const { return _resources; }
+        OperationResources& resources() { return _resources; }
+
         /**
          * this should be used very sparingly
          * generally the Context should set this up
@@ -350,6 +360,7 @@ namespace mongo {
         AtomicInt32 _killPending;
         int _numYields;
         LockStat _lockStat;
+        OperationResources _resources;
         
         // this is how much "extra" time a query might take
         // a writebacklisten for example will block for 30s 
@@ -506,6 +506,7 @@ namespace mongo {
         }
 
         startClientCursorMonitor();
+        startProfileWriter();
 
         PeriodicTask::startRunningPeriodicTasks();
 
@@ -41,7 +41,9 @@ namespace mongo {
      */
     class WorkingSetMatchableDocument : public MatchableDocument {
     public:
-        WorkingSetMatchableDocument(WorkingSetMember* wsm) : _wsm(wsm) { }
+        WorkingSetMatchableDocument(WorkingSetMember* wsm)
+            : _wsm(wsm),
+              _fieldIndex(wsm->hasObj() ? wsm->obj : BSONObj()) { }
         virtual ~WorkingSetMatchableDocument() { }
 
         // This is only called by a $where query.  The query system must be smart enough to realize
@@ -55,7 +57,7 @@ namespace mongo {
             // BSONElementIterator does some interesting things with arrays that I don't think
             // SimpleArrayElementIterator does.
             if (_wsm->hasObj()) {
-                return new BSONElementIterator(path, _wsm->obj);
+                return new BSONElementIterator(path, _wsm->obj, &_fieldIndex);
             }
 
             // NOTE: This (kind of) duplicates code in WorkingSetMember::getFieldDotted.
@@ -95,6 +97,9 @@ namespace mongo {
 
     private:
         WorkingSetMember* _wsm;
+
+        // Expressions with many clauses look up many fields of the same document.
+        mutable BSONFieldIndex _fieldIndex;
     };
 
     class IndexKeyMatchableDocument : public MatchableDocument {
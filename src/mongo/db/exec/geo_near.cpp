@@ -417,20 +417,46 @@ namespace mongo {
         class IndexScanWithMatch : public IndexScan {
         public:
 
+            /**
+             * Results whose DiskLoc is in 'skipLocs', if provided, are dropped before they are
+             * passed on to be fetched.
+             */
             IndexScanWithMatch(OperationContext* txn,
                                const IndexScanParams& params,
                                WorkingSet* workingSet,
-                               MatchExpression* filter)
-                : IndexScan(txn, params, workingSet, filter), _matcher(filter) {
+                               MatchExpression* filter,
+                               const NearStage::DiskLocSet* skipLocs = NULL)
+                : IndexScan(txn, params, workingSet, filter),
+                  _matcher(filter),
+                  _workingSet(workingSet),
+                  _skipLocs(skipLocs) {
             }
 
             virtual ~IndexScanWithMatch() {
             }
 
+            virtual StageState work(WorkingSetID* out) {
+                StageState state = IndexScan::work(out);
+                if (PlanStage::ADVANCED != state || NULL == _skipLocs) {
+                    return state;
+                }
+
+                WorkingSetMember* member = _workingSet->get(*out);
+                if (member->hasLoc() && _skipLocs->end() != _skipLocs->find(member->loc)) {
+                    _workingSet->free(*out);
+                    return PlanStage::NEED_TIME;
+                }
+                return state;
+            }
+
         private:
 
             // Owns matcher
             const scoped_ptr<MatchExpression> _matcher;
+
+            // Not owned here
+            WorkingSet* const _workingSet;
+            const NearStage::DiskLocSet* const _skipLocs;
         };
 
         // Helper class to maintain ownership of a match expression alongside an index scan
@@ -455,6 +481,34 @@ namespace mongo {
         };
     }
 
+    // The number of results we would like each search interval to buffer: enough to amortize
+    // setting up the interval's scan, few enough to return the first results quickly.
+    static const double kTargetResultsPerInterval = 400;
+
+    /**
+     * Returns the width of the next search annulus.  Assumes the density of results seen in the
+     * last interval holds just beyond it, and sizes the next annulus to hold about
+     * kTargetResultsPerInterval results.  The width changes by at most 4x per interval, and
+     * grows by 4x after an empty one.
+     */
+    static double adaptBoundsIncrement(const IntervalStats& lastIntervalStats,
+                                       double boundsIncrement) {
+
+        const double inner = max(0.0, lastIntervalStats.minDistanceAllowed);
+        const double outer = lastIntervalStats.maxDistanceAllowed;
+        const double area = M_PI * (outer * outer - inner * inner);
+
+        if (lastIntervalStats.numResultsBuffered == 0 || area <= 0) {
+            return 4 * boundsIncrement;
+        }
+
+        const double density = lastIntervalStats.numResultsBuffered / area;
+        const double nextOuter = sqrt(outer * outer
+                                      + kTargetResultsPerInterval / (density * M_PI));
+
+        return max(boundsIncrement / 4, min(4 * boundsIncrement, nextOuter - outer));
+    }
+
     static double min2DBoundsIncrement(const GeoNearExpression& query, IndexDescriptor* twoDIndex) {
         GeoHashConverter::Parameters hashParams;
         Status status = GeoHashConverter::parseParameters(twoDIndex->infoObj(), &hashParams);
@@ -506,12 +560,7 @@ namespace mongo {
         if (!stats->intervalStats.empty()) {
 
             const IntervalStats& lastIntervalStats = stats->intervalStats.back();
-
-            // TODO: Generally we want small numbers of results fast, then larger numbers later
-            if (lastIntervalStats.numResultsBuffered < 300)
-                _boundsIncrement *= 2;
-            else if (lastIntervalStats.numResultsBuffered > 600)
-                _boundsIncrement /= 2;
+            _boundsIncrement = adaptBoundsIncrement(lastIntervalStats, _boundsIncrement);
         }
 
         _boundsIncrement = max(_boundsIncrement,
@@ -638,7 +687,8 @@ namespace mongo {
         }
 
         // IndexScanWithMatch owns the matcher
-        IndexScan* scan = new IndexScanWithMatch(txn, scanParams, workingSet, keyMatcher);
+        IndexScan* scan = new IndexScanWithMatch(txn, scanParams, workingSet, keyMatcher,
+                                                 &getBufferedLocs());
         
         MatchExpression* docMatcher = NULL;
         
@@ -816,6 +866,82 @@ namespace mongo {
         return fieldPosition;
     }
 
+    // The most index keys initialBoundsIncrement() reads.
+    static const int kDensityProbeMaxKeys = 1000;
+
+    double GeoNear2DSphereStage::initialBoundsIncrement(OperationContext* txn,
+                                                        WorkingSet* workingSet) {
+
+        const double defaultIncrement = _boundsIncrement;
+
+        // Not worth probing if the default covers the whole search anyway.
+        if (_fullBounds.getOuter() - max(0.0, _fullBounds.getInner()) <= defaultIncrement) {
+            return defaultIncrement;
+        }
+
+        // Count the keys in a cell around the query point that is several times wider than the
+        // default first annulus.
+        const int probeLevel =
+            S2::kAvgEdge.GetClosestLevel(8 * defaultIncrement / kRadiusOfEarthInMeters);
+        const S2CellId probeCell =
+            S2CellId::FromLatLng(S2LatLng::FromDegrees(_fullBounds.center().y,
+                                                       _fullBounds.center().x))
+                .parent(probeLevel);
+        const double probeEdge = S2::kAvgEdge.GetValue(probeLevel) * kRadiusOfEarthInMeters;
+        const double probeArea = S2::kAvgArea.GetValue(probeLevel)
+                                 * kRadiusOfEarthInMeters * kRadiusOfEarthInMeters;
+
+        IndexScanParams scanParams;
+        scanParams.descriptor = _s2Index;
+        scanParams.direction = 1;
+        scanParams.doNotDedup = true;
+        scanParams.bounds = _nearParams.baseBounds;
+
+        const int s2FieldPosition = getFieldPosition(_s2Index, _nearParams.nearQuery->field);
+        OrderedIntervalList* probeIntervals = &scanParams.bounds.fields[s2FieldPosition];
+        probeIntervals->intervals.clear();
+
+        // Keys of everything indexed inside the cell start with the cell's id.
+        const string probeStart = probeCell.toString();
+        string probeEnd = probeStart;
+        probeEnd[probeEnd.size() - 1]++;
+        probeIntervals->intervals.push_back(
+            IndexBoundsBuilder::makeRangeInterval(probeStart, probeEnd, true, false));
+
+        IndexScan probe(txn, scanParams, workingSet, NULL);
+        int numKeys = 0;
+        while (numKeys < kDensityProbeMaxKeys) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            PlanStage::StageState state = probe.work(&id);
+            if (PlanStage::ADVANCED == state) {
+                ++numKeys;
+                workingSet->free(id);
+            }
+            else if (PlanStage::NEED_TIME != state) {
+                if (WorkingSet::INVALID_ID != id) {
+                    workingSet->free(id);
+                }
+                break;
+            }
+        }
+
+        if (0 == numKeys) {
+            return max(defaultIncrement, probeEdge / 2);
+        }
+
+        // The radius of a disc expected to hold kTargetResultsPerInterval results.
+        const double width = sqrt(kTargetResultsPerInterval * probeArea / (numKeys * M_PI));
+        // The edge of the finest indexed cell, see twoDSphereBoundsIncrement().
+        const double minIncrement = defaultIncrement / 5;
+
+        if (numKeys >= kDensityProbeMaxKeys) {
+            // We stopped counting, so the density is at least this high.
+            return max(minIncrement, min(defaultIncrement, width));
+        }
+
+        return max(minIncrement, min(probeEdge, width));
+    }
+
     StatusWith<NearStage::CoveredInterval*> //
     GeoNear2DSphereStage::nextInterval(OperationContext* txn,
                                        WorkingSet* workingSet,
@@ -835,12 +961,10 @@ namespace mongo {
         if (!stats->intervalStats.empty()) {
 
             const IntervalStats& lastIntervalStats = stats->intervalStats.back();
-
-            // TODO: Generally we want small numbers of results fast, then larger numbers later
-            if (lastIntervalStats.numResultsBuffered < 300)
-                _boundsIncrement *= 2;
-            else if (lastIntervalStats.numResultsBuffered > 600)
-                _boundsIncrement /= 2;
+            _boundsIncrement = adaptBoundsIncrement(lastIntervalStats, _boundsIncrement);
+        }
+        else {
+            _boundsIncrement = initialBoundsIncrement(txn, workingSet);
         }
 
         R2Annulus nextBounds(_currBounds.center(),
@@ -880,7 +1004,8 @@ namespace mongo {
                                          coveredIntervals);
 
         // IndexScan owns the hash matcher
-        IndexScan* scan = new IndexScanWithMatch(txn, scanParams, workingSet, keyMatcher);
+        IndexScan* scan = new IndexScanWithMatch(txn, scanParams, workingSet, keyMatcher,
+                                                 &getBufferedLocs());
 
         // FetchStage owns index scan
         FetchStage* fetcher(new FetchStage(txn, workingSet, scan, _nearParams.filter, collection));
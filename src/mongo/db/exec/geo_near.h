@@ -124,6 +124,12 @@ namespace mongo {
 
     private:
 
+        /**
+         * Sizes the first search annulus from the number of index keys near the query point,
+         * so that it neither holds far too many results nor is almost certainly empty.
+         */
+        double initialBoundsIncrement(OperationContext* txn, WorkingSet* workingSet);
+
         const GeoNearParams _nearParams;
 
         // The 2D index we're searching over
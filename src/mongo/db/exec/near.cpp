@@ -35,6 +35,14 @@
 
 namespace mongo {
 
+    namespace {
+
+        // Beyond this many results we stop remembering buffered DiskLocs; later intervals still
+        // filter those results out by distance, after fetching them.
+        const size_t kMaxBufferedLocs = 100 * 1000;
+
+    }
+
     NearStage::NearStage(OperationContext* txn,
                          WorkingSet* workingSet,
                          Collection* collection,
@@ -156,6 +164,9 @@ namespace mongo {
             _childrenIntervals.push_back(intervalStatus.getValue());
             _nextInterval = _childrenIntervals.back();
             _nextIntervalStats.reset(new IntervalStats());
+            _nextIntervalStats->minDistanceAllowed = _nextInterval->minDistance;
+            _nextIntervalStats->maxDistanceAllowed = _nextInterval->maxDistance;
+            _nextIntervalStats->inclusiveMaxDistanceAllowed = _nextInterval->inclusiveMax;
         }
 
         WorkingSetID nextMemberID;
@@ -225,6 +236,10 @@ namespace mongo {
         if (inInterval) {
             _resultBuffer.push(SearchResult(nextMemberID, memberDistance));
 
+            if (nextMember->hasLoc() && _bufferedLocs.size() < kMaxBufferedLocs) {
+                _bufferedLocs.insert(nextMember->loc);
+            }
+
             ++_nextIntervalStats->numResultsBuffered;
 
             // Update buffered distance stats
@@ -287,6 +302,9 @@ namespace mongo {
             _childrenIntervals[i]->covering->invalidate(dl, type);
         }
 
+        // A new document may take this DiskLoc, and it could belong to any interval.
+        _bufferedLocs.erase(dl);
+
         // If a result is in _resultBuffer and has a DiskLoc it will be in _nextIntervalSeen as
         // well. It's safe to return the result w/o the DiskLoc, so just fetch the result.
         unordered_map<DiskLoc, WorkingSetID, DiskLoc::Hasher>::iterator seenIt = _nextIntervalSeen
@@ -336,4 +354,8 @@ namespace mongo {
         return static_cast<NearStats*>(_stats->specific.get());
     }
 
+    const NearStage::DiskLocSet& NearStage::getBufferedLocs() const {
+        return _bufferedLocs;
+    }
+
 } // namespace mongo
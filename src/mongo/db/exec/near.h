@@ -39,6 +39,7 @@
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/platform/unordered_map.h"
+#include "mongo/platform/unordered_set.h"
 
 namespace mongo {
 
@@ -78,6 +79,8 @@ namespace mongo {
 
         struct CoveredInterval;
 
+        typedef unordered_set<DiskLoc, DiskLoc::Hasher> DiskLocSet;
+
         virtual ~NearStage();
 
         virtual bool isEOF();
@@ -111,6 +114,13 @@ namespace mongo {
          */
         NearStats* getNearStats();
 
+        /**
+         * DiskLocs of results already buffered by this search.  Their distance puts them in an
+         * interval we have searched, so a covering stage may drop them before fetching.  This
+         * may not hold every such DiskLoc.
+         */
+        const DiskLocSet& getBufferedLocs() const;
+
         //
         // Methods implemented for specific search functionality
         //
@@ -165,6 +175,9 @@ namespace mongo {
         // invalidation of buffered results.
         unordered_map<DiskLoc, WorkingSetID, DiskLoc::Hasher> _nextIntervalSeen;
 
+        // See getBufferedLocs().  Bounded by kMaxBufferedLocs.
+        DiskLocSet _bufferedLocs;
+
         // Stats for the stage covering this interval
         scoped_ptr<IntervalStats> _nextIntervalStats;
 
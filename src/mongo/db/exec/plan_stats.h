@@ -532,6 +532,9 @@ namespace mongo {
         IntervalStats() :
             numResultsFound(0),
             numResultsBuffered(0),
+            minDistanceAllowed(-1),
+            maxDistanceAllowed(-1),
+            inclusiveMaxDistanceAllowed(false),
             minDistanceFound(-1),
             maxDistanceFound(-1),
             minDistanceBuffered(-1),
@@ -541,6 +544,11 @@ namespace mongo {
         long long numResultsFound;
         long long numResultsBuffered;
 
+        // The bounds of the interval searched.
+        double minDistanceAllowed;
+        double maxDistanceAllowed;
+        bool inclusiveMaxDistanceAllowed;
+
         double minDistanceFound;
         double maxDistanceFound;
         double minDistanceBuffered;
@@ -605,7 +613,7 @@ namespace mongo {
     };
 
     struct TextStats : public SpecificStats {
-        TextStats() : keysExamined(0), fetches(0), parsedTextQuery() { }
+        TextStats() : keysExamined(0), fetches(0), limit(0), parsedTextQuery() { }
 
         virtual SpecificStats* clone() const {
             TextStats* specific = new TextStats(*this);
@@ -616,6 +624,9 @@ namespace mongo {
 
         size_t fetches;
 
+        // Nonzero if the stage only computed the top 'limit' results.
+        size_t limit;
+
         // Human-readable form of the FTSQuery associated with the text stage.
         BSONObj parsedTextQuery;
 
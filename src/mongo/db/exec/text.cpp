@@ -37,8 +37,30 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/query/internal_plans.h"
 
+#include <algorithm>
+#include <functional>
+
 namespace mongo {
 
+    using fts::TermFrequencyMap;
+
+    namespace {
+
+        // Locate score within possibly compound key: {prefix,term,score,suffix}.
+        double scoreFromKey(const FTSSpec& spec, const BSONObj& key) {
+            BSONObjIterator keyIt(key);
+            for (unsigned i = 0; i < spec.numExtraBefore(); i++) {
+                keyIt.next();
+            }
+
+            keyIt.next(); // Skip past 'term'.
+
+            BSONElement scoreElement = keyIt.next();
+            return scoreElement.number();
+        }
+
+    } // namespace
+
     // static
     const char* TextStage::kStageType = "TEXT";
 
@@ -53,9 +75,11 @@ namespace mongo {
           _filter(filter),
           _commonStats(kStageType),
           _internalState(INIT_SCANS),
-          _currentIndexScanner(0) {
+          _currentIndexScanner(0),
+          _scansDone(0) {
         _scoreIterator = _scores.end();
         _specificStats.indexPrefix = _params.indexPrefix;
+        _specificStats.limit = _params.limit;
     }
 
     TextStage::~TextStage() { }
@@ -140,6 +164,27 @@ namespace mongo {
             }
             _scores.erase(scoreIt);
         }
+
+        // If the document was one of our current top k, rebuild the heap from every document
+        // we have scored so that the next best one takes its place.
+        if (READING_TERMS == _internalState && _params.limit) {
+            for (size_t i = 0; i < _topK.size(); ++i) {
+                if (_topK[i].second == dl) {
+                    _topK.clear();
+                    for (ScoreMap::const_iterator it = _scores.begin(); it != _scores.end(); ++it) {
+                        if (it->second >= 0) {
+                            _topK.push_back(ScoredLoc(it->second, it->first));
+                        }
+                    }
+                    std::make_heap(_topK.begin(), _topK.end(), std::greater<ScoredLoc>());
+                    while (_topK.size() > _params.limit) {
+                        std::pop_heap(_topK.begin(), _topK.end(), std::greater<ScoredLoc>());
+                        _topK.pop_back();
+                    }
+                    break;
+                }
+            }
+        }
     }
 
     vector<PlanStage*> TextStage::getChildren() const {
@@ -200,6 +245,11 @@ namespace mongo {
             return PlanStage::IS_EOF;
         }
 
+        if (_params.limit) {
+            _frontier.assign(_scanners.size(), MAX_WEIGHT);
+            _scanDone.assign(_scanners.size(), false);
+        }
+
         // Transition to the next state.
         _internalState = READING_TERMS;
         return PlanStage::NEED_TIME;
@@ -218,11 +268,40 @@ namespace mongo {
             invariant(1 == wsm->keyData.size());
             invariant(wsm->hasLoc());
             IndexKeyDatum& keyDatum = wsm->keyData.back();
-            addTerm(keyDatum.keyData, wsm->loc);
+
+            if (!_params.limit) {
+                addTerm(keyDatum.keyData, wsm->loc);
+                _ws->free(id);
+                return PlanStage::NEED_TIME;
+            }
+
+            addTermTopK(keyDatum.keyData, wsm->loc);
             _ws->free(id);
+
+            if (topKComplete()) {
+                doneReadingTerms();
+            }
+            else {
+                advanceScanner();
+            }
             return PlanStage::NEED_TIME;
         }
         else if (PlanStage::IS_EOF == childState) {
+            if (_params.limit) {
+                // This term can't contribute to any document we haven't seen yet.
+                _scanDone[_currentIndexScanner] = true;
+                _frontier[_currentIndexScanner] = 0;
+                ++_scansDone;
+
+                if (_scansDone == _scanners.size() || topKComplete()) {
+                    doneReadingTerms();
+                }
+                else {
+                    advanceScanner();
+                }
+                return PlanStage::NEED_TIME;
+            }
+
             // Done with this scan.
             ++_currentIndexScanner;
 
@@ -232,11 +311,7 @@ namespace mongo {
             }
 
             // If we're here we are done reading results.  Move to the next state.
-            _scoreIterator = _scores.begin();
-            _internalState = RETURNING_RESULTS;
-
-            // Don't need to keep these around.
-            _scanners.clear();
+            doneReadingTerms();
             return PlanStage::NEED_TIME;
         }
         else {
@@ -257,6 +332,44 @@ namespace mongo {
         }
     }
 
+    void TextStage::advanceScanner() {
+        invariant(_scansDone < _scanners.size());
+        do {
+            _currentIndexScanner = (_currentIndexScanner + 1) % _scanners.size();
+        } while (_scanDone[_currentIndexScanner]);
+    }
+
+    bool TextStage::topKComplete() const {
+        if (_topK.size() < _params.limit) {
+            return false;
+        }
+
+        double bound = 0;
+        for (size_t i = 0; i < _frontier.size(); ++i) {
+            bound += _frontier[i];
+        }
+
+        return _topK.front().first >= bound;
+    }
+
+    void TextStage::doneReadingTerms() {
+        // Only the top k survive.  Everything else we scored was needed just to know that
+        // we had seen it.
+        if (_params.limit) {
+            _scores.clear();
+            for (size_t i = 0; i < _topK.size(); ++i) {
+                _scores[_topK[i].second] = _topK[i].first;
+            }
+            _topK.clear();
+        }
+
+        _scoreIterator = _scores.begin();
+        _internalState = RETURNING_RESULTS;
+
+        // Don't need to keep these around.
+        _scanners.clear();
+    }
+
     PlanStage::StageState TextStage::returnResults(WorkingSetID* out) {
         if (_scoreIterator == _scores.end()) {
             _internalState = DONE;
@@ -273,8 +386,8 @@ namespace mongo {
             return PlanStage::NEED_TIME;
         }
 
-        // Filter for phrases and negated terms
-        if (_params.query.hasNonTermPieces()) {
+        // Filter for phrases and negated terms.  In top-k mode addTermTopK already did this.
+        if (_params.query.hasNonTermPieces() && !_params.limit) {
             if (!_ftsMatcher.matchesNonTerm(_params.index->getCollection()->docFor(_txn, loc))) {
                 return PlanStage::NEED_TIME;
             }
@@ -352,17 +465,8 @@ namespace mongo {
 
         ++_specificStats.keysExamined;
 
-        // Locate score within possibly compound key: {prefix,term,score,suffix}.
-        BSONObjIterator keyIt(key);
-        for (unsigned i = 0; i < _params.spec.numExtraBefore(); i++) {
-            keyIt.next();
-        }
-
-        keyIt.next(); // Skip past 'term'.
+        double documentTermScore = scoreFromKey(_params.spec, key);
 
-        BSONElement scoreElement = keyIt.next();
-        double documentTermScore = scoreElement.number();
-        
         // Handle filtering.
         if (*documentAggregateScore < 0) {
             // We have already rejected this document.
@@ -399,4 +503,85 @@ namespace mongo {
         *documentAggregateScore += documentTermScore;
     }
 
+    bool TextStage::passesFilter(const BSONObj& key, const DiskLoc& loc) {
+        if (NULL == _filter) {
+            return true;
+        }
+
+        bool fetched = false;
+        TextMatchableDocument tdoc(_txn,
+                                   _params.index->keyPattern(),
+                                   key,
+                                   loc,
+                                   _params.index->getCollection(),
+                                   &fetched);
+        bool matches = _filter->matches(&tdoc);
+        if (fetched && !matches) {
+            ++_specificStats.fetches;
+        }
+        return matches;
+    }
+
+    void TextStage::addTermTopK(const BSONObj& key, const DiskLoc& loc) {
+        ++_specificStats.keysExamined;
+
+        double documentTermScore = scoreFromKey(_params.spec, key);
+        _frontier[_currentIndexScanner] = documentTermScore;
+
+        std::pair<ScoreMap::iterator, bool> inserted = _scores.insert(std::make_pair(loc, -1.0));
+        if (!inserted.second) {
+            // We scored this document in full when we first saw it.
+            return;
+        }
+
+        if (!passesFilter(key, loc)) {
+            return;
+        }
+
+        // Every document that passes the filter is fetched from here on.
+        ++_specificStats.fetches;
+
+        const std::vector<std::string>& terms = _params.query.getTerms();
+        double score = documentTermScore;
+        BSONObj obj;
+
+        // With several terms the other ones may not have reached this document yet, so compute
+        // its score directly.  Summing in term order yields the same value as the blocking path.
+        if (terms.size() > 1) {
+            obj = _params.index->getCollection()->docFor(_txn, loc);
+            TermFrequencyMap termFreqs;
+            _params.spec.scoreDocument(obj, &termFreqs);
+
+            score = 0;
+            for (size_t i = 0; i < terms.size(); ++i) {
+                TermFrequencyMap::const_iterator it = termFreqs.find(terms[i]);
+                if (it != termFreqs.end()) {
+                    score += it->second;
+                }
+            }
+        }
+
+        if (_params.query.hasNonTermPieces()) {
+            if (obj.isEmpty()) {
+                obj = _params.index->getCollection()->docFor(_txn, loc);
+            }
+            if (!_ftsMatcher.matchesNonTerm(obj)) {
+                return;
+            }
+        }
+
+        inserted.first->second = score;
+
+        ScoredLoc entry(score, loc);
+        if (_topK.size() < _params.limit) {
+            _topK.push_back(entry);
+            std::push_heap(_topK.begin(), _topK.end(), std::greater<ScoredLoc>());
+        }
+        else if (entry > _topK.front()) {
+            std::pop_heap(_topK.begin(), _topK.end(), std::greater<ScoredLoc>());
+            _topK.back() = entry;
+            std::push_heap(_topK.begin(), _topK.end(), std::greater<ScoredLoc>());
+        }
+    }
+
 }  // namespace mongo
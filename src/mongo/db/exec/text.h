@@ -55,7 +55,7 @@ namespace mongo {
     class OperationContext;
 
     struct TextStageParams {
-        TextStageParams(const FTSSpec& s) : spec(s) {}
+        TextStageParams(const FTSSpec& s) : spec(s), limit(0) {}
 
         // Text index descriptor.  IndexCatalog owns this.
         IndexDescriptor* index;
@@ -68,11 +68,20 @@ namespace mongo {
 
         // The text query.
         FTSQuery query;
+
+        // If nonzero, only the 'limit' highest scoring documents are needed.  The caller is
+        // expected to sort our output by text score.
+        size_t limit;
     };
 
     /**
      * Implements a blocking stage that returns text search results.
      *
+     * When a limit is given, the term scans are read round-robin in descending score order and
+     * each newly seen document is scored in full, keeping only the best 'limit' documents.  We
+     * stop reading as soon as the lowest retained score is at least the sum of the scores at the
+     * head of each scan, since no document we have not yet seen can score higher than that.
+     *
      * Prerequisites: None; is a leaf node.
      * Output type: LOC_AND_OBJ_UNOWNED.
      */
@@ -140,6 +149,32 @@ namespace mongo {
          */
         void addTerm(const BSONObj& key, const DiskLoc& loc);
 
+        /**
+         * Top-k counterpart of addTerm, used when _params.limit is set.  Computes the full score
+         * of a document the first time any scan returns it and offers it to _topK.
+         */
+        void addTermTopK(const BSONObj& key, const DiskLoc& loc);
+
+        /**
+         * Returns true if the document identified by 'key' and 'loc' passes our filter.
+         */
+        bool passesFilter(const BSONObj& key, const DiskLoc& loc);
+
+        /**
+         * Returns true if no document we have not yet seen can displace the current top k.
+         */
+        bool topKComplete() const;
+
+        /**
+         * Moves _currentIndexScanner to the next scan that has not hit EOF.
+         */
+        void advanceScanner();
+
+        /**
+         * Called when we have read all the terms we need.  Sets up RETURNING_RESULTS.
+         */
+        void doneReadingTerms();
+
         /**
          * Possibly return a result.  FYI, this may perform a fetch directly if it is needed to
          * evaluate all filters.
@@ -181,6 +216,19 @@ namespace mongo {
         typedef unordered_map<DiskLoc, double, DiskLoc::Hasher> ScoreMap;
         ScoreMap _scores;
         ScoreMap::const_iterator _scoreIterator;
+
+        // Used only when _params.limit is set.  The score of the last key read from each scan,
+        // which bounds the score any unseen document can get from that term.  Zero once the scan
+        // hits EOF.
+        std::vector<double> _frontier;
+
+        // Which scans have hit EOF, and how many of them.
+        std::vector<bool> _scanDone;
+        size_t _scansDone;
+
+        // Min-heap of (score, loc) for the best documents seen so far.
+        typedef std::pair<double, DiskLoc> ScoredLoc;
+        std::vector<ScoredLoc> _topK;
     };
 
 } // namespace mongo
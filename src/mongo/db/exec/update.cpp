@@ -525,11 +525,15 @@ namespace mongo {
                 // Don't actually do the write if this is an explain.
                 if (!request->isExplain()) {
                     invariant(_collection);
+                    // A replacement does not report which fields it changed.
+                    const FieldRefSet* changedFields =
+                        driver->isDocReplacement() ? NULL : &updatedFields;
                     StatusWith<DiskLoc> res = _collection->updateDocument(request->getOpCtx(),
                                                                           loc,
                                                                           newObj,
                                                                           true,
-                                                                          _params.opDebug);
+                                                                          _params.opDebug,
+                                                                          changedFields);
                     uassertStatusOK(res.getStatus());
                     DiskLoc newLoc = res.getValue();
 
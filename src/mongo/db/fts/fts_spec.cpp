@@ -165,8 +165,9 @@ namespace mongo {
 
             while ( it.more() ) {
                 FTSIteratorValue val = it.next();
-                Stemmer stemmer( *val._language );
-                Tools tools( *val._language, &stemmer, StopWords::getStopWords( *val._language ) );
+                Tools tools( *val._language,
+                             StemCache::get( *val._language ),
+                             StopWords::getStopWords( *val._language ) );
                 _scoreStringV2( tools, val._text, term_freqs, val._weight );
             }
         }
@@ -180,18 +181,22 @@ namespace mongo {
 
             unsigned numTokens = 0;
 
+            // Reused for every token, so it stops allocating once it has grown to fit the
+            // longest one.
+            string word;
+
             Tokenizer i( tools.language, raw );
             while ( i.more() ) {
                 Token t = i.next();
                 if ( t.type != Token::TEXT )
                     continue;
 
-                string term = t.data.toString();
-                makeLower( &term );
-                if ( tools.stopwords->isStopWord( term ) ) {
+                word.assign( t.data.rawData(), t.data.size() );
+                makeLower( &word );
+                if ( tools.stopwords->isStopWord( word ) ) {
                     continue;
                 }
-                term = tools.stemmer->stem( term );
+                const string term = tools.stemCache->stem( word );
 
                 ScoreHelperStruct& data = terms[term];
 
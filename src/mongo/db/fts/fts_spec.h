@@ -70,10 +70,20 @@ namespace mongo {
                        const StopWords* _stopwords )
                     : language( _language )
                     , stemmer( _stemmer )
+                    , stemCache( NULL )
+                    , stopwords( _stopwords ) {}
+
+                Tools( const FTSLanguage& _language,
+                       StemCache* _stemCache,
+                       const StopWords* _stopwords )
+                    : language( _language )
+                    , stemmer( NULL )
+                    , stemCache( _stemCache )
                     , stopwords( _stopwords ) {}
 
                 const FTSLanguage& language;
-                const Stemmer* stemmer;
+                const Stemmer* stemmer; // used by version 1 indexes
+                StemCache* stemCache; // used by version 2 indexes
                 const StopWords* stopwords;
             };
 
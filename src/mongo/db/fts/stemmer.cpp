@@ -28,9 +28,12 @@
 *    it in the license file.
 */
 
+#include <boost/thread/tss.hpp>
 #include <cstdlib>
+#include <map>
 #include <string>
 
+#include "mongo/base/owned_pointer_map.h"
 #include "mongo/db/fts/stemmer.h"
 #include "mongo/util/mongoutils/str.h"
 
@@ -67,6 +70,84 @@ namespace mongo {
             return string( (const char*)(sb_sym), sb_stemmer_length( _stemmer ) );
         }
 
+        namespace {
+            // FTSLanguage objects are never destroyed, so their addresses are stable keys.
+
+            // The shared caches, which live for the rest of the process.
+            SimpleMutex stemCachesMutex( "StemCaches" );
+            std::map<const FTSLanguage*, StemCache*> stemCaches;
+
+            // What each thread keeps: its own stemmers, which libstemmer needs, and the shared
+            // caches it has looked up, so get() only takes stemCachesMutex once per language.
+            struct ThreadStemState {
+                OwnedPointerMap<const FTSLanguage*, Stemmer> stemmers;
+                std::map<const FTSLanguage*, StemCache*> caches;
+            };
+            boost::thread_specific_ptr<ThreadStemState> threadStemState;
+
+            ThreadStemState* getThreadStemState() {
+                ThreadStemState* state = threadStemState.get();
+                if ( !state ) {
+                    state = new ThreadStemState();
+                    threadStemState.reset( state );
+                }
+                return state;
+            }
+        }
+
+        const size_t StemCache::kGenerationSize;
+        const size_t StemCache::kStripes;
+
+        StemCache::StemCache( const FTSLanguage& language )
+            : _language( language ) {
+        }
+
+        void StemCache::_insert_inlock( Stripe* stripe, const string& word, const string& stemmed ) {
+            if ( stripe->current.size() >= kGenerationSize / kStripes ) {
+                stripe->previous.swap( stripe->current );
+                stripe->current.clear();
+            }
+            stripe->current.insert( StemMap::value_type( word, stemmed ) );
+        }
+
+        string StemCache::stem( const string& word ) {
+            Stripe& stripe = _stripes[StemMap::hasher()( word ) % kStripes];
+            {
+                SimpleMutex::scoped_lock lk( stripe.mutex );
+                StemMap::const_iterator i = stripe.current.find( word );
+                if ( i != stripe.current.end() )
+                    return i->second;
+
+                i = stripe.previous.find( word );
+                if ( i != stripe.previous.end() ) {
+                    const string stemmed = i->second;
+                    _insert_inlock( &stripe, word, stemmed );
+                    return stemmed;
+                }
+            }
+
+            Stemmer*& stemmer = getThreadStemState()->stemmers.mutableMap()[&_language];
+            if ( !stemmer )
+                stemmer = new Stemmer( _language );
+            const string stemmed = stemmer->stem( word );
+
+            SimpleMutex::scoped_lock lk( stripe.mutex );
+            _insert_inlock( &stripe, word, stemmed );
+            return stemmed;
+        }
+
+        StemCache* StemCache::get( const FTSLanguage& language ) {
+            StemCache*& cache = getThreadStemState()->caches[&language];
+            if ( !cache ) {
+                SimpleMutex::scoped_lock lk( stemCachesMutex );
+                StemCache*& shared = stemCaches[&language];
+                if ( !shared )
+                    shared = new StemCache( language );
+                cache = shared;
+            }
+            return cache;
+        }
+
     }
 
 }
@@ -33,8 +33,11 @@
 
 #include <string>
 
+#include "mongo/base/disallow_copying.h"
 #include "mongo/base/string_data.h"
 #include "mongo/db/fts/fts_language.h"
+#include "mongo/platform/unordered_map.h"
+#include "mongo/util/concurrency/mutex.h"
 #include "third_party/libstemmer_c/include/libstemmer.h"
 
 namespace mongo {
@@ -55,6 +58,55 @@ namespace mongo {
         private:
             struct sb_stemmer* _stemmer;
         };
+
+        /**
+         * Remembers the stems of recently seen words for one language.  Entries live in two
+         * generations; when the current one fills up it becomes the previous one and the old
+         * previous generation is dropped, so words in steady use stay cached.
+         *
+         * Words are split by hash over kStripes stripes, each with its own lock and
+         * generations, so a cache holds at most 2 * kGenerationSize words however many threads
+         * share it.  Misses are stemmed outside the lock, with a Stemmer of the calling thread.
+         *
+         * Thread safe.  StemCache::get() returns the process wide cache for a language.
+         */
+        class StemCache {
+            MONGO_DISALLOW_COPYING(StemCache);
+        public:
+            static const size_t kGenerationSize = 4096;
+            static const size_t kStripes = 16;
+
+            explicit StemCache( const FTSLanguage& language );
+
+            /**
+             * Same as Stemmer::stem.
+             */
+            std::string stem( const std::string& word );
+
+            /**
+             * Returns the cache for 'language'.
+             */
+            static StemCache* get( const FTSLanguage& language );
+
+        private:
+            typedef unordered_map<std::string, std::string> StemMap;
+
+            struct Stripe {
+                Stripe() : mutex( "StemCache" ) {}
+
+                SimpleMutex mutex;
+                StemMap current;
+                StemMap previous;
+            };
+
+            /** Adds 'word' to the current generation of 'stripe', rolling it over if full. */
+            static void _insert_inlock( Stripe* stripe,
+                                        const std::string& word,
+                                        const std::string& stemmed );
+
+            const FTSLanguage& _language;
+            Stripe _stripes[kStripes];
+        };
     }
 }
 
@@ -29,10 +29,14 @@
 */
 
 
+#include <boost/thread/thread.hpp>
+
 #include "mongo/unittest/unittest.h"
 
 #include "mongo/db/fts/fts_spec.h"
 #include "mongo/db/fts/stemmer.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
     namespace fts {
@@ -49,5 +53,61 @@ namespace mongo {
             ASSERT_EQUALS( "Unite", s.stem( "United" ) );
         }
 
+        TEST( StemCache, MatchesStemmer ) {
+            Stemmer s( languageEnglishV2 );
+            StemCache c( languageEnglishV2 );
+            const char* words[] = { "running", "runs", "united", "running", "unites" };
+            for ( size_t i = 0; i < sizeof( words ) / sizeof( words[0] ); i++ ) {
+                ASSERT_EQUALS( s.stem( words[i] ), c.stem( words[i] ) );
+            }
+        }
+
+        TEST( StemCache, GenerationRollover ) {
+            Stemmer s( languageEnglishV2 );
+            StemCache c( languageEnglishV2 );
+            ASSERT_EQUALS( "run", c.stem( "running" ) );
+            for ( size_t i = 0; i < 3 * StemCache::kGenerationSize; i++ ) {
+                std::string word = mongoutils::str::stream() << "walking" << i;
+                ASSERT_EQUALS( s.stem( word ), c.stem( word ) );
+            }
+            ASSERT_EQUALS( "run", c.stem( "running" ) );
+        }
+
+        TEST( StemCache, OnePerLanguage ) {
+            StemCache* english = StemCache::get( languageEnglishV2 );
+            ASSERT( english == StemCache::get( languageEnglishV2 ) );
+            ASSERT( english != StemCache::get( languagePorterV1 ) );
+            ASSERT_EQUALS( "Unite", StemCache::get( languagePorterV1 )->stem( "United" ) );
+        }
+
+        namespace {
+            void stemFromThread( StemCache** cache, int* mismatches ) {
+                *cache = StemCache::get( languageEnglishV2 );
+                Stemmer s( languageEnglishV2 );
+                for ( size_t i = 0; i < 2 * StemCache::kGenerationSize; i++ ) {
+                    std::string word = mongoutils::str::stream() << "jumping" << ( i % 1000 );
+                    if ( s.stem( word ) != ( *cache )->stem( word ) )
+                        ( *mismatches )++;
+                }
+            }
+        }
+
+        TEST( StemCache, SharedByThreads ) {
+            const int kThreads = 4;
+            StemCache* caches[kThreads];
+            int mismatches[kThreads] = { 0 };
+
+            boost::thread_group threads;
+            for ( int i = 0; i < kThreads; i++ ) {
+                threads.create_thread( stdx::bind( stemFromThread, &caches[i], &mismatches[i] ) );
+            }
+            threads.join_all();
+
+            for ( int i = 0; i < kThreads; i++ ) {
+                ASSERT( caches[i] == StemCache::get( languageEnglishV2 ) );
+                ASSERT_EQUALS( 0, mismatches[i] );
+            }
+        }
+
     }
 }
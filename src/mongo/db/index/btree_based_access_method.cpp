@@ -243,6 +243,14 @@ namespace mongo {
         return _newInterface->getSpaceUsedBytes( txn );
     }
 
+    bool BtreeBasedAccessMethod::sampleKeys(OperationContext* txn,
+                                            const BSONObj& start,
+                                            const BSONObj& end,
+                                            std::vector<BSONObj>* keysOut,
+                                            double* keysPerSampleOut) const {
+        return _newInterface->sampleKeys(txn, start, end, keysOut, keysPerSampleOut);
+    }
+
     Status BtreeBasedAccessMethod::validateUpdate(OperationContext* txn,
                                                   const BSONObj &from,
                                                   const BSONObj &to,
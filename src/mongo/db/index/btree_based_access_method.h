@@ -106,6 +106,12 @@ namespace mongo {
 
         virtual long long getSpaceUsedBytes( OperationContext* txn ) const;
 
+        virtual bool sampleKeys(OperationContext* txn,
+                                const BSONObj& start,
+                                const BSONObj& end,
+                                std::vector<BSONObj>* keysOut,
+                                double* keysPerSampleOut) const;
+
         // XXX: consider migrating callers to use IndexCursor instead
         virtual DiskLoc findSingle( OperationContext* txn, const BSONObj& key ) const;
 
@@ -109,6 +109,14 @@ namespace mongo {
             return -1;
         }
 
+        virtual bool sampleKeys(OperationContext* txn,
+                                const BSONObj& start,
+                                const BSONObj& end,
+                                std::vector<BSONObj>* keysOut,
+                                double* keysPerSampleOut) const {
+            return false;
+        }
+
         virtual Status update(OperationContext* txn,
                               const UpdateTicket& ticket,
                               int64_t* numUpdated) {
@@ -27,10 +27,65 @@
 */
 
 #include "mongo/db/index/btree_key_generator.h"
+
+#include <boost/thread/tss.hpp>
+
 #include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
 
+namespace {
+
+    // Working copies of a generator's field names and fixed values.  getKeysImpl() consumes
+    // them, so every getKeys() call starts from a fresh copy; keeping the vectors per thread
+    // lets that copy reuse their storage instead of allocating for each document.
+    struct KeyGenScratch {
+        vector<const char*> fieldNames;
+        vector<BSONElement> fixed;
+    };
+
+    boost::thread_specific_ptr<KeyGenScratch> keyGenScratch;
+
+    KeyGenScratch* getKeyGenScratch() {
+        KeyGenScratch* scratch = keyGenScratch.get();
+        if (!scratch) {
+            scratch = new KeyGenScratch();
+            keyGenScratch.reset(scratch);
+        }
+        return scratch;
+    }
+
+    /**
+     * Completes BSONObj::getFieldDottedOrArray('field') given 'sub', the result of looking up
+     * the first component of 'field', which ends at 'dot' (NULL if 'field' has no dot).
+     * Advances 'field' past that first component.
+     */
+    BSONElement getFieldDottedOrArrayFrom(const BSONElement& sub, const char*& field,
+                                          const char* dot) {
+        field = dot ? dot + 1 : field + strlen(field);
+        if (sub.eoo()) {
+            return BSONElement();
+        }
+        if (sub.type() == Array || *field == '\0') {
+            return sub;
+        }
+        if (sub.type() == Object) {
+            return sub.embeddedObject().getFieldDottedOrArray(field);
+        }
+        return BSONElement();
+    }
+
+    bool allFieldNamesConsumed(const vector<const char*>& fieldNames) {
+        for (size_t i = 0; i < fieldNames.size(); ++i) {
+            if (*fieldNames[i] != '\0') {
+                return false;
+            }
+        }
+        return true;
+    }
+
+} // namespace
+
     // Used in scanandorder.cpp to inforatively error when we try to sort keys with parallel arrays.
     const int BtreeKeyGenerator::ParallelArraysCode = 10088;
 
@@ -52,9 +107,10 @@ namespace mongo {
 
     void BtreeKeyGenerator::getKeys(const BSONObj &obj, BSONObjSet *keys) const {
         // These are mutated as part of the getKeys call.  :|
-        vector<const char*> fieldNames(_fieldNames);
-        vector<BSONElement> fixed(_fixed);
-        getKeysImpl(fieldNames, fixed, obj, keys);
+        KeyGenScratch* scratch = getKeyGenScratch();
+        scratch->fieldNames.assign(_fieldNames.begin(), _fieldNames.end());
+        scratch->fixed.assign(_fixed.begin(), _fixed.end());
+        getKeysImpl(scratch->fieldNames, scratch->fixed, obj, keys);
         if (keys->empty() && ! _isSparse) {
             keys->insert(_nullKey);
         }
@@ -70,7 +126,8 @@ namespace mongo {
                                              vector<BSONElement> fixed, bool isSparse)
             : BtreeKeyGenerator(fieldNames, fixed, isSparse) { }
         
-    void BtreeKeyGeneratorV0::getKeysImpl(vector<const char*> fieldNames, vector<BSONElement> fixed,
+    void BtreeKeyGeneratorV0::getKeysImpl(vector<const char*>& fieldNames,
+                                          vector<BSONElement>& fixed,
                                           const BSONObj &obj, BSONObjSet *keys) const {
         BSONElement arrElt;
         unsigned arrIdx = ~0;
@@ -159,7 +216,10 @@ namespace mongo {
                 while( i.more() ) {
                     BSONElement e = i.next();
                     if ( e.type() == Object ) {
-                        getKeysImpl( fieldNames, fixed, e.embeddedObject(), keys );
+                        // each element starts from this level's state
+                        vector<const char*> elementFieldNames( fieldNames );
+                        vector<BSONElement> elementFixed( fixed );
+                        getKeysImpl( elementFieldNames, elementFixed, e.embeddedObject(), keys );
                     }
                 }
             }
@@ -200,9 +260,11 @@ namespace mongo {
     BSONElement BtreeKeyGeneratorV1::extractNextElement(const BSONObj &obj, const BSONObj &arr,
                                                         const char *&field,
                                                         bool &arrayNestedArray) const {
-        string firstField = mongoutils::str::before( field, '.' );
-        bool haveObjField = !obj.getField( firstField ).eoo();
-        BSONElement arrField = arr.getField( firstField );
+        const char* dot = strchr( field, '.' );
+        const StringData firstField = dot ? StringData( field, dot - field ) : StringData( field );
+        BSONElement objField = obj.getField( firstField );
+        bool haveObjField = !objField.eoo();
+        BSONElement arrField = arr.isEmpty() ? BSONElement() : arr.getField( firstField );
         bool haveArrField = !arrField.eoo();
 
         // An index component field name cannot exist in both a document
@@ -216,13 +278,13 @@ namespace mongo {
 
         arrayNestedArray = false;
         if ( haveObjField ) {
-            return obj.getFieldDottedOrArray( field );
+            return getFieldDottedOrArrayFrom( objField, field, dot );
         }
         else if ( haveArrField ) {
             if ( arrField.type() == Array ) {
                 arrayNestedArray = true;
             }
-            return arr.getFieldDottedOrArray( field );
+            return getFieldDottedOrArrayFrom( arrField, field, dot );
         }
         return BSONElement();
     }
@@ -232,34 +294,50 @@ namespace mongo {
                                                   const BSONElement &arrEntry, BSONObjSet *keys,
                                                   unsigned numNotFound,
                                                   const BSONElement &arrObjElt,
-                                                  const set<unsigned> &arrIdxs,
+                                                  const vector<unsigned> &arrIdxs,
                                                   bool mayExpandArrayUnembedded) const {
         // set up any terminal array values
-        for( set<unsigned>::const_iterator j = arrIdxs.begin(); j != arrIdxs.end(); ++j ) {
+        for( vector<unsigned>::const_iterator j = arrIdxs.begin(); j != arrIdxs.end(); ++j ) {
             if ( *fieldNames[ *j ] == '\0' ) {
                 fixed[ *j ] = mayExpandArrayUnembedded ? arrEntry : arrObjElt;
             }
         }
-        // recurse
-        getKeysImplWithArray(fieldNames,
-                             fixed,
-                             arrEntry.type() == Object ? arrEntry.embeddedObject() : BSONObj(),
+
+        const BSONObj entryObj = arrEntry.type() == Object ? arrEntry.embeddedObject() : BSONObj();
+
+        // Once every path has been resolved the recursion only builds a key and leaves the
+        // field names and values alone, so there is nothing to copy.  This is the common case
+        // of an array of scalars.
+        if ( allFieldNamesConsumed( fieldNames ) ) {
+            getKeysImplWithArray(fieldNames, fixed, entryObj, keys, numNotFound,
+                                 arrObjElt.embeddedObject());
+            return;
+        }
+
+        // recurse; the remaining array entries still need this level's state
+        vector<const char*> entryFieldNames( fieldNames );
+        vector<BSONElement> entryFixed( fixed );
+        getKeysImplWithArray(entryFieldNames,
+                             entryFixed,
+                             entryObj,
                              keys,
                              numNotFound,
                              arrObjElt.embeddedObject());
     }
 
-    void BtreeKeyGeneratorV1::getKeysImpl(vector<const char*> fieldNames, vector<BSONElement> fixed,
+    void BtreeKeyGeneratorV1::getKeysImpl(vector<const char*>& fieldNames,
+                                          vector<BSONElement>& fixed,
                                           const BSONObj &obj, BSONObjSet *keys) const {
         getKeysImplWithArray(fieldNames, fixed, obj, keys, 0, BSONObj());
     }
 
-    void BtreeKeyGeneratorV1::getKeysImplWithArray(vector<const char*> fieldNames,
-                                                   vector<BSONElement> fixed, const BSONObj &obj,
+    void BtreeKeyGeneratorV1::getKeysImplWithArray(vector<const char*>& fieldNames,
+                                                   vector<BSONElement>& fixed, const BSONObj &obj,
                                                    BSONObjSet *keys, unsigned numNotFound,
                                                    const BSONObj &array) const {
         BSONElement arrElt;
-        set<unsigned> arrIdxs;
+        // indexes are visited in increasing order, so this stays sorted
+        vector<unsigned> arrIdxs;
         bool mayExpandArrayUnembedded = true;
         for( unsigned i = 0; i < fieldNames.size(); ++i ) {
             if ( *fieldNames[ i ] == '\0' ) {
@@ -278,7 +356,7 @@ namespace mongo {
                 numNotFound++;
             }
             else if ( e.type() == Array ) {
-                arrIdxs.insert( i );
+                arrIdxs.push_back( i );
                 if ( arrElt.eoo() ) {
                     // we only expand arrays on a single path -- track the path here
                     arrElt = e;
@@ -57,7 +57,11 @@ namespace mongo {
         BSONSizeTracker _sizeTracker;
     private:
         // We have V0 and V1.  Sigh.
-        virtual void getKeysImpl(vector<const char*> fieldNames, vector<BSONElement> fixed,
+        /**
+         * 'fieldNames' and 'fixed' are working copies owned by the caller, which the
+         * implementation consumes as it walks 'obj'.
+         */
+        virtual void getKeysImpl(vector<const char*>& fieldNames, vector<BSONElement>& fixed,
                                  const BSONObj &obj, BSONObjSet *keys) const = 0;
         vector<BSONElement> _fixed;
     };
@@ -69,7 +73,7 @@ namespace mongo {
         virtual ~BtreeKeyGeneratorV0() { }
 
     private:
-        virtual void getKeysImpl(vector<const char*> fieldNames, vector<BSONElement> fixed,
+        virtual void getKeysImpl(vector<const char*>& fieldNames, vector<BSONElement>& fixed,
                                  const BSONObj &obj, BSONObjSet *keys) const;
     };
 
@@ -89,11 +93,11 @@ namespace mongo {
          * @param array - array from which keys should be extracted, based on names in fieldNames
          *        If obj and array are both nonempty, obj will be one of the elements of array.
          */        
-        virtual void getKeysImpl(vector<const char*> fieldNames, vector<BSONElement> fixed,
+        virtual void getKeysImpl(vector<const char*>& fieldNames, vector<BSONElement>& fixed,
                                  const BSONObj &obj, BSONObjSet *keys) const;
 
         // These guys are called by getKeysImpl.
-        void getKeysImplWithArray(vector<const char*> fieldNames, vector<BSONElement> fixed,
+        void getKeysImplWithArray(vector<const char*>& fieldNames, vector<BSONElement>& fixed,
                                   const BSONObj &obj, BSONObjSet *keys, unsigned numNotFound,
                                   const BSONObj &array) const;
         /**
@@ -105,7 +109,8 @@ namespace mongo {
         void _getKeysArrEltFixed(vector<const char*> &fieldNames, vector<BSONElement> &fixed,
                                  const BSONElement &arrEntry, BSONObjSet *keys,
                                  unsigned numNotFound, const BSONElement &arrObjElt,
-                                 const set<unsigned> &arrIdxs, bool mayExpandArrayUnembedded) const;
+                                 const vector<unsigned> &arrIdxs,
+                                 bool mayExpandArrayUnembedded) const;
 
         BSONObj _undefinedObj;
         BSONElement _undefinedElt;
@@ -586,4 +586,28 @@ namespace {
         ASSERT(testKeygen(keyPattern, genKeysFrom, expectedKeys));
     }
 
+    // The generator's working state is reused between calls; make sure that one document's
+    // array expansion does not leak into the keys of the next.
+    TEST(BtreeKeyGeneratorTest, GetKeysReusesGeneratorAcrossDocuments) {
+        vector<const char*> fieldNames;
+        fieldNames.push_back("a.b");
+        fieldNames.push_back("c");
+        vector<BSONElement> fixed(2);
+        BtreeKeyGeneratorV1 keyGen(fieldNames, fixed, false);
+
+        BSONObjSet firstKeys;
+        keyGen.getKeys(fromjson("{a: [{b: 1}, {b: [2, 3]}], c: 4}"), &firstKeys);
+        BSONObjSet expectedFirstKeys;
+        expectedFirstKeys.insert(fromjson("{'': 1, '': 4}"));
+        expectedFirstKeys.insert(fromjson("{'': 2, '': 4}"));
+        expectedFirstKeys.insert(fromjson("{'': 3, '': 4}"));
+        ASSERT(keysetsMatch(expectedFirstKeys, firstKeys));
+
+        BSONObjSet secondKeys;
+        keyGen.getKeys(fromjson("{a: {b: 5}}"), &secondKeys);
+        BSONObjSet expectedSecondKeys;
+        expectedSecondKeys.insert(fromjson("{'': 5, '': null}"));
+        ASSERT(keysetsMatch(expectedSecondKeys, secondKeys));
+    }
+
 } // namespace
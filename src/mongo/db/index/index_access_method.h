@@ -156,6 +156,17 @@ namespace mongo {
          */
         virtual long long getSpaceUsedBytes( OperationContext* txn ) const = 0;
 
+        /**
+         * Estimates the distribution of index entries in [start, end) without walking every
+         * entry.  See SortedDataInterface::sampleKeys.  Returns false if no estimate is available
+         * and the caller must scan the range.
+         */
+        virtual bool sampleKeys(OperationContext* txn,
+                                const BSONObj& start,
+                                const BSONObj& end,
+                                std::vector<BSONObj>* keysOut,
+                                double* keysPerSampleOut) const = 0;
+
         //
         // Bulk operations support
         //
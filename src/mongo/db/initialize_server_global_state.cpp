@@ -45,6 +45,9 @@
 #include "mongo/db/auth/authorization_manager_global.h"
 #include "mongo/db/auth/security_key.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/logger/async_file_appender.h"
+#include "mongo/logger/async_file_writer.h"
 #include "mongo/logger/logger.h"
 #include "mongo/logger/console_appender.h"
 #include "mongo/logger/message_event.h"
@@ -183,6 +186,14 @@ namespace mongo {
         return true;
     }
 
+    // When non-zero, log file output is buffered and written by a background thread, so that
+    // logging threads don't wait on the disk.
+    MONGO_EXPORT_STARTUP_SERVER_PARAMETER(logAsyncBufferSizeBytes, int, 0);
+
+    // With logAsyncBufferSizeBytes set, drop log output when the buffer is full instead of
+    // waiting for room.  Dropped messages are counted in the log.
+    MONGO_EXPORT_STARTUP_SERVER_PARAMETER(logAsyncDropWhenFull, bool, false);
+
     void forkServerOrDie() {
         if (!forkServer())
             quickExit(EXIT_FAILURE);
@@ -193,6 +204,8 @@ namespace mongo {
                               ("default"))(
             InitializerContext*) {
 
+        using logger::AsyncFileAppender;
+        using logger::AsyncFileWriter;
         using logger::LogManager;
         using logger::MessageEventEphemeral;
         using logger::MessageEventDetailsEncoder;
@@ -273,14 +286,31 @@ namespace mongo {
 
             LogManager* manager = logger::globalLogManager();
             manager->getGlobalDomain()->clearAppenders();
-            manager->getGlobalDomain()->attachAppender(
-                    MessageLogDomain::AppenderAutoPtr(
-                            new RotatableFileAppender<MessageEventEphemeral>(
-                                    new MessageEventDetailsEncoder, writer.getValue())));
-            manager->getNamedDomain("javascriptOutput")->attachAppender(
-                    MessageLogDomain::AppenderAutoPtr(
-                            new RotatableFileAppender<MessageEventEphemeral>(
-                                    new MessageEventDetailsEncoder, writer.getValue())));
+            if (logAsyncBufferSizeBytes > 0) {
+                // Lives for the rest of the process, like the file writer it wraps.
+                AsyncFileWriter* asyncWriter = new AsyncFileWriter(
+                        writer.getValue(),
+                        logAsyncBufferSizeBytes,
+                        logAsyncDropWhenFull ? AsyncFileWriter::kDrop : AsyncFileWriter::kBlock);
+                manager->getGlobalDomain()->attachAppender(
+                        MessageLogDomain::AppenderAutoPtr(
+                                new AsyncFileAppender<MessageEventEphemeral>(
+                                        new MessageEventDetailsEncoder, asyncWriter)));
+                manager->getNamedDomain("javascriptOutput")->attachAppender(
+                        MessageLogDomain::AppenderAutoPtr(
+                                new AsyncFileAppender<MessageEventEphemeral>(
+                                        new MessageEventDetailsEncoder, asyncWriter)));
+            }
+            else {
+                manager->getGlobalDomain()->attachAppender(
+                        MessageLogDomain::AppenderAutoPtr(
+                                new RotatableFileAppender<MessageEventEphemeral>(
+                                        new MessageEventDetailsEncoder, writer.getValue())));
+                manager->getNamedDomain("javascriptOutput")->attachAppender(
+                        MessageLogDomain::AppenderAutoPtr(
+                                new RotatableFileAppender<MessageEventEphemeral>(
+                                        new MessageEventDetailsEncoder, writer.getValue())));
+            }
 
             if (serverGlobalParams.logAppend && exists) {
                 log() << "***** SERVER RESTARTED *****" << endl;
@@ -72,6 +72,7 @@
 #include "mongo/db/repl/repl_coordinator_global.h"
 #include "mongo/db/stats/counters.h"
 #include "mongo/db/storage_options.h"
+#include "mongo/logger/async_file_writer.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/platform/process_id.h"
 #include "mongo/s/d_state.h"
@@ -243,6 +244,46 @@ namespace mongo {
         replyToQuery(0, m, dbresponse, obj);
     }
 
+    /**
+     * Profile entries are written in the background.  If 'query' on 'nss' reads a system.profile
+     * collection, insert that database's queued entries first, so that it sees every operation
+     * that has already been profiled.
+     */
+    static void flushProfileEntriesBeforeRead(OperationContext* txn,
+                                              const NamespaceString& nss,
+                                              const BSONObj& query) {
+        if (!profileEntriesPending() || txn->lockState()->isLocked()) {
+            return;
+        }
+
+        bool readsProfile = nss.coll() == "system.profile";
+        if (!readsProfile && nss.isCommand()) {
+            BSONObj cmdObj = query;
+            BSONElement first = cmdObj.firstElement();
+            if (first.type() == Object &&
+                    (str::equals(first.fieldName(), "query") ||
+                     str::equals(first.fieldName(), "$query"))) {
+                cmdObj = first.Obj();
+            }
+            BSONElement target = cmdObj.firstElement();
+            readsProfile = target.type() == String && target.valueStringData() == "system.profile";
+        }
+
+        if (!readsProfile) {
+            return;
+        }
+
+        // Commands are authorized after this point, so don't do the work for a client that
+        // could not read the collection anyway.
+        const NamespaceString profileNss(nss.db(), "system.profile");
+        AuthorizationSession* authSession = txn->getClient()->getAuthorizationSession();
+        if (!authSession->isAuthorizedForActionsOnNamespace(profileNss, ActionType::find)) {
+            return;
+        }
+
+        flushProfileEntries(txn, nss.db());
+    }
+
     static bool receivedQuery(OperationContext* txn,
                               Client& c,
                               DbResponse& dbresponse,
@@ -268,6 +309,7 @@ namespace mongo {
                 audit::logQueryAuthzCheck(client, ns, q.query, status.code());
                 uassertStatusOK(status);
             }
+            flushProfileEntriesBeforeRead(txn, ns, q.query);
             dbresponse.exhaustNS = newRunQuery(txn, m, q, op, *resp, fromDBDirectClient);
             verify( !resp->empty() );
         }
@@ -365,7 +407,6 @@ namespace mongo {
 
         if ( op == dbQuery ) {
             const char *ns = dbmsg.getns();
-
             if (strstr(ns, ".$cmd")) {
                 isCommand = true;
                 opwrite(m);
@@ -433,6 +474,7 @@ namespace mongo {
 
         CurOp& currentOp = *currentOpP;
         currentOp.reset(remote,op);
+        currentOp.resources().startLockWaits(*txn->lockState());
 
         OpDebug& debug = currentOp.debug();
         debug.op = op;
@@ -531,6 +573,8 @@ namespace mongo {
         currentOp.ensureStarted();
         currentOp.done();
         debug.executionTime = currentOp.totalTimeMillis();
+        currentOp.resources().finishLockWaits(*txn->lockState());
+        currentOp.recordResourceUsage();
 
         logThreshold += currentOp.getExpectedLatencyMs();
 
@@ -704,7 +748,8 @@ namespace mongo {
         scoped_ptr<Timer> timer;
         int pass = 0;
         bool exhaust = false;
-        QueryResult::View msgdata = 0;
+        auto_ptr<Message> resp( new Message() );
+        AwaitDataState awaitDataState;
         OpTime last;
         while( 1 ) {
             bool isCursorAuthorized = false;
@@ -730,15 +775,17 @@ namespace mongo {
                     }
                 }
 
-                msgdata = newGetMore(txn,
-                                     ns,
-                                     ntoreturn,
-                                     cursorid,
-                                     curop,
-                                     pass,
-                                     exhaust,
-                                     &isCursorAuthorized,
-                                     fromDBDirectClient);
+                newGetMore(txn,
+                           ns,
+                           ntoreturn,
+                           cursorid,
+                           curop,
+                           pass,
+                           exhaust,
+                           &isCursorAuthorized,
+                           fromDBDirectClient,
+                           &awaitDataState,
+                           resp.get());
             }
             catch ( AssertionException& e ) {
                 if ( isCursorAuthorized ) {
@@ -754,7 +801,7 @@ namespace mongo {
                 break;
             }
             
-            if (msgdata.view2ptr() == 0) {
+            if (resp->empty()) {
                 // this should only happen with QueryOption_AwaitData
                 exhaust = false;
                 massert(13073, "shutting down", !inShutdown() );
@@ -769,7 +816,17 @@ namespace mongo {
                     }
                 }
                 pass++;
-                if (debug)
+                if ( awaitDataState.notifier ) {
+                    // Sleep until something is inserted, but wake up now and then to notice
+                    // shutdown and killOp, and not past the point where we return anyway.
+                    if ( pass < 1000 ) {
+                        const int waitMillis =
+                            std::min( 1000, std::max( 0, 4000 - timer->millis() ) );
+                        awaitDataState.notifier->waitForInsert( awaitDataState.notifierVersion,
+                                                                waitMillis );
+                    }
+                }
+                else if (debug)
                     sleepmillis(20);
                 else
                     sleepmillis(2);
@@ -796,12 +853,11 @@ namespace mongo {
             return ok;
         }
 
-        Message *resp = new Message();
-        resp->setData(msgdata.view2ptr(), true);
+        QueryResult::View msgdata = resp->header().view2ptr();
         curop.debug().responseLength = resp->header().dataLen();
         curop.debug().nreturned = msgdata.getNReturned();
 
-        dbresponse.response = resp;
+        dbresponse.response = resp.release();
         dbresponse.responseTo = m.header().getId();
         
         if( exhaust ) {
@@ -1017,6 +1073,12 @@ namespace mongo {
                 txn = new OperationContextImpl();
             }
 
+            // The profile writer may be waiting for a database lock, so write the entries it
+            // has not gotten to before taking the global lock.
+            if (!txn->lockState()->isLocked()) {
+                drainProfileEntries(txn);
+            }
+
             Lock::GlobalWrite lk(txn->lockState());
             log() << "now exiting" << endl;
 
@@ -1048,6 +1110,7 @@ namespace mongo {
         audit::logShutdown(currentClient.get());
 
         log() << "dbexit: " << why << " rc: " << rc;
+        logger::AsyncFileWriter::flushAll();
 
 #ifdef _WIN32
         // Windows Service Controller wants to be told when we are down,
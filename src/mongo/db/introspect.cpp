@@ -30,16 +30,30 @@
 
 #include "mongo/pch.h"
 
+#include <boost/thread/condition.hpp>
+#include <deque>
+#include <map>
+
+#include "mongo/base/counter.h"
 #include "mongo/bson/util/builder.h"
 #include "mongo/db/auth/authorization_manager.h"
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/auth/user_set.h"
+#include "mongo/db/client.h"
+#include "mongo/db/commands/fsync.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/catalog/database_holder.h"
 #include "mongo/db/introspect.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/operation_context_impl.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/storage_options.h"
 #include "mongo/db/catalog/collection.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/background.h"
+#include "mongo/util/concurrency/mutex.h"
+#include "mongo/util/fail_point_service.h"
 #include "mongo/util/goodies.h"
 #include "mongo/util/log.h"
 
@@ -49,6 +63,14 @@ namespace {
 
 namespace mongo {
 
+    // Profile entries that arrive while this many bytes of entries are already queued are
+    // dropped.
+    MONGO_EXPORT_SERVER_PARAMETER(profileQueueMaxBytes, int, 16*1024*1024);
+
+    // Stops the profile writer from taking entries off the queue.  Reads of system.profile
+    // still insert the entries they need.
+    MONGO_FP_DECLARE(pauseProfileWriter);
+
 namespace {
     void _appendUserInfo(const CurOp& c,
                          BSONObjBuilder& builder,
@@ -77,15 +99,209 @@ namespace {
         builder.append("user", bestUser.getUser().empty() ? "" : bestUser.getFullName());
 
     }
-} // namespace
 
-    static void _profile(OperationContext* txn,
-                         const Client& c,
-                         Database* db,
-                         CurOp& currentOp,
-                         BufBuilder& profileBufBuilder) {
-        dassert( db );
+    struct ProfileEntry {
+        std::string dbname;
+        BSONObj obj;
+    };
+
+    /**
+     * Profile entries waiting to be inserted into system.profile.
+     *
+     * Only one thread writes entries at a time: usually the ProfileWriter, but also any thread
+     * that is about to read a system.profile collection and so needs its queued entries in place
+     * first.  This keeps each database's entries in the order they were queued.
+     */
+    class ProfileQueue {
+    public:
+        ProfileQueue() : _mutex("ProfileQueue"), _bytes(0), _writing(false) {}
+
+        /** Returns false, and doesn't queue 'entry', if the queue is full. */
+        bool push(const ProfileEntry& entry) {
+            scoped_lock lk(_mutex);
+            if (_bytes + entry.obj.objsize() > static_cast<size_t>(profileQueueMaxBytes)) {
+                return false;
+            }
+            _entries.push_back(entry);
+            _bytes += entry.obj.objsize();
+            _numPending.fetchAndAdd(1);
+            _changed.notify_all();
+            return true;
+        }
+
+        /** The number of entries that are queued or being written. */
+        unsigned numPending() const {
+            return _numPending.load();
+        }
+
+        /**
+         * Waits up to 'maxSecondsToWait' for queued entries and for any other writer to finish,
+         * then makes the caller the writer and moves all the queued entries into 'out'.  Returns
+         * false if it timed out; the caller is not the writer then.
+         */
+        bool takeAll(int maxSecondsToWait, std::vector<ProfileEntry>* out) {
+            boost::xtime xt;
+            boost::xtime_get(&xt, MONGO_BOOST_TIME_UTC);
+            xt.sec += maxSecondsToWait;
+
+            scoped_lock lk(_mutex);
+            while (_writing || _entries.empty()) {
+                if (!_changed.timed_wait(lk.boost(), xt)) {
+                    return false;
+                }
+            }
+
+            out->assign(_entries.begin(), _entries.end());
+            _entries.clear();
+            _bytes = 0;
+            _writing = true;
+            return true;
+        }
+
+        /**
+         * Waits for any other writer to finish, then makes the caller the writer and moves the
+         * queued entries for 'dbname' into 'out'.  Every entry for 'dbname' queued before this
+         * call is either in 'out' or already written once it returns.
+         */
+        void takeDatabase(const StringData& dbname, std::vector<ProfileEntry>* out) {
+            scoped_lock lk(_mutex);
+            while (_writing) {
+                _changed.wait(lk.boost());
+            }
+
+            std::deque<ProfileEntry> rest;
+            for (std::deque<ProfileEntry>::const_iterator it = _entries.begin();
+                 it != _entries.end();
+                 ++it) {
+                if (it->dbname == dbname) {
+                    out->push_back(*it);
+                    _bytes -= it->obj.objsize();
+                }
+                else {
+                    rest.push_back(*it);
+                }
+            }
+            _entries.swap(rest);
+            _writing = true;
+        }
+
+        /**
+         * Waits for any other writer to finish, then makes the caller the writer and moves every
+         * queued entry into 'out'.
+         */
+        void takeRemaining(std::vector<ProfileEntry>* out) {
+            scoped_lock lk(_mutex);
+            while (_writing) {
+                _changed.wait(lk.boost());
+            }
+
+            out->assign(_entries.begin(), _entries.end());
+            _entries.clear();
+            _bytes = 0;
+            _writing = true;
+        }
+
+        /** Called by the writer once the 'numWritten' entries it took have been written. */
+        void doneWriting(size_t numWritten) {
+            scoped_lock lk(_mutex);
+            _writing = false;
+            _numPending.fetchAndSubtract(numWritten);
+            _changed.notify_all();
+        }
 
+    private:
+        mongo::mutex _mutex;
+        boost::condition _changed;
+        std::deque<ProfileEntry> _entries;
+        size_t _bytes;
+        bool _writing;
+        AtomicUInt32 _numPending;
+    };
+
+    ProfileQueue profileQueue;
+
+    Counter64 profileEntriesDropped;
+    ServerStatusMetricField<Counter64> displayProfileEntriesDropped("profile.dropped",
+                                                                    &profileEntriesDropped);
+
+    /** Inserts 'entries' into the system.profile collections of their databases. */
+    void writeProfileEntries(OperationContext* txn, const std::vector<ProfileEntry>& entries) {
+        // Keep each database's entries in order, and lock each database once.
+        std::map<std::string, std::vector<BSONObj> > byDatabase;
+        for (size_t i = 0; i < entries.size(); i++) {
+            byDatabase[entries[i].dbname].push_back(entries[i].obj);
+        }
+
+        for (std::map<std::string, std::vector<BSONObj> >::const_iterator it = byDatabase.begin();
+             it != byDatabase.end();
+             ++it) {
+            const std::string& dbname = it->first;
+            try {
+                Lock::DBLock lk(txn->lockState(), dbname, MODE_X);
+                Database* db = dbHolder().get(txn, dbname);
+                if (db == NULL) {
+                    mongo::log() << "note: not profiling because db went away - probably a close on: "
+                                 << dbname << endl;
+                    continue;
+                }
+
+                // We are ok with the profiling happening in a different WUOW from the actual op.
+                WriteUnitOfWork wunit(txn);
+                // write: not replicated
+                // get or create the profiling collection
+                Collection* profileCollection = getOrCreateProfileCollection(txn, db);
+                if (profileCollection) {
+                    for (size_t i = 0; i < it->second.size(); i++) {
+                        profileCollection->insertDocument(txn, it->second[i], false);
+                    }
+                }
+                wunit.commit();
+            }
+            catch (const AssertionException& assertionEx) {
+                warning() << "Caught Assertion while trying to write " << it->second.size()
+                          << " profile entries for " << dbname
+                          << ": " << assertionEx.toString() << endl;
+            }
+        }
+    }
+
+    /**
+     * Writes queued profile entries in batches, so that profiled operations don't wait for the
+     * insert into system.profile.
+     */
+    class ProfileWriter : public BackgroundJob {
+    public:
+        virtual std::string name() const { return "ProfileWriter"; }
+
+        virtual void run() {
+            Client::initThread(name().c_str());
+            cc().getAuthorizationSession()->grantInternalAuthorization();
+
+            while (!inShutdown()) {
+                if (MONGO_FAIL_POINT(pauseProfileWriter)) {
+                    sleepmillis(100);
+                    continue;
+                }
+
+                std::vector<ProfileEntry> entries;
+                if (!profileQueue.takeAll(1, &entries)) {
+                    continue;
+                }
+
+                OperationContextImpl txn;
+                writeProfileEntries(&txn, entries);
+                profileQueue.doneWriting(entries.size());
+            }
+
+            cc().shutdown();
+        }
+    };
+
+} // namespace
+
+    static BSONObj _buildProfileObject(const Client& c,
+                                       CurOp& currentOp,
+                                       BufBuilder& profileBufBuilder) {
         // build object
         BSONObjBuilder b(profileBufBuilder);
 
@@ -121,41 +337,61 @@ namespace {
             p = b.done();
         }
 
-        // write: not replicated
-        // get or create the profiling collection
-        Collection* profileCollection = getOrCreateProfileCollection(txn, db);
-        if ( profileCollection ) {
-            profileCollection->insertDocument( txn, p, false );
-        }
+        return p.getOwned();
     }
 
     void profile(OperationContext* txn, const Client& c, int op, CurOp& currentOp) {
         // initialize with 1kb to start, to avoid realloc later
-        // doing this outside the dblock to improve performance
         BufBuilder profileBufBuilder(1024);
 
-        try {
-            // NOTE: It's kind of weird that we lock the op's namespace, but have to for now
-            // since we're sometimes inside the lock already
-            const string dbname(nsToDatabase(currentOp.getNS()));
-            Lock::DBLock lk(txn->lockState(), dbname, MODE_X);
-            if (dbHolder().get(txn, dbname) != NULL) {
-                // We are ok with the profiling happening in a different WUOW from the actual op.
-                WriteUnitOfWork wunit(txn);
-                Client::Context cx(txn, currentOp.getNS(), false);
-                _profile(txn, c, cx.db(), currentOp, profileBufBuilder);
-                wunit.commit();
-            }
-            else {
-                mongo::log() << "note: not profiling because db went away - probably a close on: "
-                             << currentOp.getNS() << endl;
+        ProfileEntry entry;
+        entry.dbname = nsToDatabase(currentOp.getNS());
+        entry.obj = _buildProfileObject(c, currentOp, profileBufBuilder);
+
+        if (!profileQueue.push(entry)) {
+            profileEntriesDropped.increment();
+            RARELY {
+                warning() << "dropping profile entries for " << opToString(op)
+                          << " because too many are waiting to be written" << endl;
             }
         }
-        catch (const AssertionException& assertionEx) {
-            warning() << "Caught Assertion while trying to profile " << opToString(op)
-                      << " against " << currentOp.getNS()
-                      << ": " << assertionEx.toString() << endl;
+    }
+
+    bool profileEntriesPending() {
+        return profileQueue.numPending() != 0;
+    }
+
+    void flushProfileEntries(OperationContext* txn, const StringData& dbname) {
+        if (!profileEntriesPending()) {
+            return;
+        }
+
+        // The writer could be waiting for an fsync lock to be released; don't wait with it.
+        if (lockedForWriting()) {
+            return;
+        }
+
+        std::vector<ProfileEntry> entries;
+        profileQueue.takeDatabase(dbname, &entries);
+        writeProfileEntries(txn, entries);
+        profileQueue.doneWriting(entries.size());
+    }
+
+    void drainProfileEntries(OperationContext* txn) {
+        if (!profileEntriesPending() || lockedForWriting()) {
+            return;
         }
+
+        std::vector<ProfileEntry> entries;
+        profileQueue.takeRemaining(&entries);
+        log() << "shutdown: writing " << entries.size() << " queued profile entries" << endl;
+        writeProfileEntries(txn, entries);
+        profileQueue.doneWriting(entries.size());
+    }
+
+    void startProfileWriter() {
+        ProfileWriter* writer = new ProfileWriter();
+        writer->go();
     }
 
     Collection* getOrCreateProfileCollection(OperationContext* txn,
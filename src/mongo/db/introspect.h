@@ -46,8 +46,31 @@ namespace mongo {
        do when database->profile is set
     */
 
+    /**
+     * Builds the profile entry for 'currentOp' and queues it to be inserted into its database's
+     * system.profile by the profile writer thread.  The entry is dropped, and counted in
+     * metrics.profile.dropped, if too many entries are already waiting.
+     */
     void profile(OperationContext* txn, const Client& c, int op, CurOp& currentOp);
 
+    /**
+     * Inserts the queued profile entries for 'dbname' now, so that a read of its system.profile
+     * sees every operation profiled so far.  Must be called without any locks held.
+     */
+    void flushProfileEntries(OperationContext* txn, const StringData& dbname);
+
+    /**
+     * Inserts every queued profile entry.  Called once at shutdown, before the global lock is
+     * taken, so that entries for operations that already finished are not lost.
+     */
+    void drainProfileEntries(OperationContext* txn);
+
+    /** True if any profile entries are queued or being written. */
+    bool profileEntriesPending();
+
+    /** Starts the thread that writes queued profile entries. */
+    void startProfileWriter();
+
     /**
      * Get (or create) the profile collection
      *
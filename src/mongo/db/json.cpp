@@ -56,8 +56,8 @@ namespace mongo {
         ID_RESERVE_SIZE = 64,
         PAT_RESERVE_SIZE = 4096,
         OPT_RESERVE_SIZE = 64,
-        FIELD_RESERVE_SIZE = 4096,
-        STRINGVAL_RESERVE_SIZE = 4096,
+        FIELD_RESERVE_SIZE = 64,
+        STRINGVAL_RESERVE_SIZE = 64,
         BINDATA_RESERVE_SIZE = 4096,
         BINDATATYPE_RESERVE_SIZE = 4096,
         NS_RESERVE_SIZE = 64,
@@ -90,12 +90,33 @@ namespace mongo {
         ossmsg << ": offset:";
         ossmsg << offset();
         ossmsg << " of:";
-        ossmsg << _buf;
+        ossmsg << StringData(_buf, _input_end - _buf);
         return Status(ErrorCodes::FailedToParse, ossmsg.str());
     }
 
     Status JParse::value(const StringData& fieldName, BSONObjBuilder& builder) {
         MONGO_JSON_DEBUG("fieldName: " << fieldName);
+
+        // Numbers and strings are by far the most common values, so recognize them by their
+        // first character rather than trying every other token first.
+        skipWhitespace();
+        if (_input < _input_end) {
+            const char next = *_input;
+            if (isdigit(static_cast<unsigned char>(next))) {
+                return number(fieldName, builder);
+            }
+            if (next == '"' || next == '\'') {
+                std::string valueString;
+                valueString.reserve(STRINGVAL_RESERVE_SIZE);
+                Status ret = quotedString(&valueString);
+                if (ret != Status::OK()) {
+                    return ret;
+                }
+                builder.append(fieldName, valueString);
+                return Status::OK();
+            }
+        }
+
         if (peekToken(LBRACE)) {
             Status ret = object(fieldName, builder);
             if (ret != Status::OK()) {
@@ -971,6 +992,12 @@ namespace mongo {
     }
 
     Status JParse::number(const StringData& fieldName, BSONObjBuilder& builder) {
+        // integer() never consumes the last character of the input, so the trailing number
+        // check below only applies to the slow path.
+        if (integer(fieldName, builder)) {
+            return Status::OK();
+        }
+
         char* endptrll;
         char* endptrd;
         long long retll;
@@ -1016,6 +1043,42 @@ namespace mongo {
         return Status::OK();
     }
 
+    bool JParse::integer(const StringData& fieldName, BSONObjBuilder& builder) {
+        const char* q = _input;
+        const bool negative = (q < _input_end && *q == '-');
+        if (negative) {
+            ++q;
+        }
+
+        // 18 decimal digits always fit in a long long.
+        const char* const digitsStart = q;
+        long long val = 0;
+        while (q < _input_end && q - digitsStart < 18 && isdigit(static_cast<unsigned char>(*q))) {
+            val = val * 10 + (*q - '0');
+            ++q;
+        }
+
+        // Leave exponents, fractions, hex and anything too long to strtod and strtoll.
+        if (q == digitsStart || q >= _input_end
+                || isalnum(static_cast<unsigned char>(*q)) || *q == '.') {
+            return false;
+        }
+
+        if (negative) {
+            val = -val;
+        }
+        if (val == static_cast<int>(val)) {
+            MONGO_JSON_DEBUG("Type: 32 bit int");
+            builder.append(fieldName, static_cast<int>(val));
+        }
+        else {
+            MONGO_JSON_DEBUG("Type: 64 bit int");
+            builder.append(fieldName, val);
+        }
+        _input = q;
+        return true;
+    }
+
     Status JParse::field(std::string* result) {
         MONGO_JSON_DEBUG("");
         if (peekToken(DOUBLEQUOTE) || peekToken(SINGLEQUOTE)) {
@@ -1025,13 +1088,7 @@ namespace mongo {
         }
         else {
             // Unquoted key
-            // 'isspace()' takes an 'int' (signed), so (default signed) 'char's get sign-extended
-            // and therefore 'corrupted' unless we force them to be unsigned ... 0x80 becomes
-            // 0xffffff80 as seen by isspace when sign-extended ... we want it to be 0x00000080
-            while (_input < _input_end &&
-                   isspace(*reinterpret_cast<const unsigned char*>(_input))) {
-                ++_input;
-            }
+            skipWhitespace();
             if (_input >= _input_end) {
                 return parseError("Field name expected");
             }
@@ -1079,8 +1136,26 @@ namespace mongo {
             return parseError("Unexpected end of input");
         }
         const char* q = _input;
+
+        // A quoted string is mostly characters that need no escaping or checking beyond their
+        // not being the closing quote, so copy each run of those in one go.
+        const bool singleTerminal = (terminalSet[0] != '\0' && terminalSet[1] == '\0');
+        const char terminal = terminalSet[0];
+
         while (q < _input_end && !match(*q, terminalSet)) {
             MONGO_JSON_DEBUG("q: " << q);
+            if (singleTerminal && allowedSet == NULL) {
+                const char* runEnd = q;
+                while (runEnd < _input_end && *runEnd != terminal && *runEnd != '\\'
+                       && !(0x00 <= *runEnd && *runEnd <= 0x1F)) {
+                    ++runEnd;
+                }
+                if (runEnd != q) {
+                    result->append(q, runEnd);
+                    q = runEnd;
+                    continue;
+                }
+            }
             if (allowedSet != NULL) {
                 if (!match(*q, allowedSet)) {
                     _input = q;
@@ -1175,18 +1250,22 @@ namespace mongo {
         return readTokenImpl(token, true);
     }
 
+    inline void JParse::skipWhitespace() {
+        // 'isspace()' takes an 'int' (signed), so (default signed) 'char's get sign-extended
+        // and therefore 'corrupted' unless we force them to be unsigned ... 0x80 becomes
+        // 0xffffff80 as seen by isspace when sign-extended ... we want it to be 0x00000080
+        while (_input < _input_end && isspace(*reinterpret_cast<const unsigned char*>(_input))) {
+            ++_input;
+        }
+    }
+
     bool JParse::readTokenImpl(const char* token, bool advance) {
         MONGO_JSON_DEBUG("token: " << token);
-        const char* check = _input;
         if (token == NULL) {
             return false;
         }
-        // 'isspace()' takes an 'int' (signed), so (default signed) 'char's get sign-extended
-        // and therefore 'corrupted' unless we force them to be unsigned ... 0x80 becomes
-        // 0xffffff80 as seen by isspace when sign-extended ... we want it to be 0x00000080
-        while (check < _input_end && isspace(*reinterpret_cast<const unsigned char*>(check))) {
-            ++check;
-        }
+        skipWhitespace();
+        const char* check = _input;
         while (*token != '\0') {
             if (check >= _input_end) {
                 return false;
@@ -1249,6 +1328,11 @@ namespace mongo {
         return peekToken(LBRACKET);
     }
 
+    bool JParse::atEnd() {
+        skipWhitespace();
+        return _input >= _input_end;
+    }
+
     BSONObj fromjson(const char* jsonString, int* len) {
         MONGO_JSON_DEBUG("jsonString: " << jsonString);
         if (jsonString[0] == '\0') {
@@ -1280,6 +1364,54 @@ namespace mongo {
         return fromjson( str.c_str() );
     }
 
+    Status fromjsonLines(const StringData& input, std::vector<BSONObj>* docs, size_t* consumed) {
+        // JParse needs a null terminated buffer, so each line is copied here first.
+        std::string line;
+        size_t lineNumber = 0;
+        size_t pos = 0;
+        while (pos < input.size()) {
+            size_t lineEnd = input.find('\n', pos);
+            if (lineEnd == std::string::npos) {
+                if (consumed) {
+                    break;
+                }
+                lineEnd = input.size();
+            }
+            ++lineNumber;
+            line.assign(input.rawData() + pos, lineEnd - pos);
+            pos = std::min(lineEnd + 1, input.size());
+
+            JParse jparse(line);
+            if (jparse.atEnd()) {
+                continue;
+            }
+
+            BSONObjBuilder builder;
+            Status ret = Status::OK();
+            try {
+                ret = jparse.object("UNUSED", builder, false);
+            }
+            catch(std::exception& e) {
+                ret = Status(ErrorCodes::FailedToParse,
+                             str::stream() << "caught exception from within JSON parser: "
+                                           << e.what());
+            }
+            if (ret.isOK() && !jparse.atEnd()) {
+                ret = Status(ErrorCodes::FailedToParse, "Expecting end of line after object");
+            }
+            if (!ret.isOK()) {
+                return Status(ErrorCodes::FailedToParse,
+                              str::stream() << "line " << lineNumber << ": " << ret.reason());
+            }
+            docs->push_back(builder.obj());
+        }
+
+        if (consumed) {
+            *consumed = pos;
+        }
+        return Status::OK();
+    }
+
     std::string tojson(const BSONObj& obj, JsonStringFormat format, bool pretty) {
         return obj.jsonString(format, pretty);
     }
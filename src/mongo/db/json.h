@@ -29,6 +29,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "mongo/bson/bsonobj.h"
 #include "mongo/base/status.h"
@@ -54,6 +55,22 @@ namespace mongo {
     /** @param len will be size of JSON object in text chars. */
     MONGO_CLIENT_API BSONObj fromjson(const char* str, int* len=NULL);
 
+    /**
+     * Parses newline-delimited JSON: one JSON object per line of 'str', as written by
+     * mongoexport.  Each object is appended to 'docs'; blank lines are skipped.
+     *
+     * To convert a stream a buffer at a time, pass 'consumed'.  A last line without its
+     * terminating newline is then left unparsed and '*consumed' is set to the offset where it
+     * begins, so that the caller can pass it again at the start of the next buffer.  Without
+     * 'consumed' the last line is parsed whether or not it ends in a newline.
+     *
+     * @return FailedToParse naming the line that could not be parsed.  The objects on the lines
+     * before it will have been appended to 'docs'.
+     */
+    MONGO_CLIENT_API Status fromjsonLines(const StringData& str,
+                                          std::vector<BSONObj>* docs,
+                                          size_t* consumed=NULL);
+
     /**
      * Tests whether the JSON string is an Array.
      *
@@ -170,6 +187,11 @@ namespace mongo {
             Status parse(BSONObjBuilder& builder);
             bool isArray();
 
+            /**
+             * @return true if nothing but whitespace is left in our buffer
+             */
+            bool atEnd();
+
         private:
             /* The following functions are called with the '{' and the first
              * field already parsed since they are both implied given the
@@ -350,6 +372,13 @@ namespace mongo {
              */
             Status number(const StringData& fieldName, BSONObjBuilder&);
 
+            /**
+             * Fast path for number(): appends a plain decimal integer of at most 18 digits, which
+             * is what most numbers are.  Returns false without consuming any input if the number
+             * is anything else.
+             */
+            bool integer(const StringData& fieldName, BSONObjBuilder&);
+
             /*
              * FIELD :
              *     STRING
@@ -417,7 +446,7 @@ namespace mongo {
             /**
              * @return true if the given token matches the next non whitespace
              * sequence in our buffer, and false if the token doesn't match or
-             * we reach the end of our buffer.  Do not update the pointer to our
+             * we reach the end of our buffer.  Only skips the whitespace in our
              * buffer (same as calling readTokenImpl with advance=false).
              */
             inline bool peekToken(const char* token);
@@ -433,11 +462,16 @@ namespace mongo {
             /**
              * @return true if the given token matches the next non whitespace
              * sequence in our buffer, and false if the token doesn't match or
-             * we reach the end of our buffer.  Do not update the pointer to our
+             * we reach the end of our buffer.  Only skips the whitespace in our
              * buffer if advance is false.
              */
             bool readTokenImpl(const char* token, bool advance=true);
 
+            /**
+             * Advances the pointer to our buffer past any whitespace.
+             */
+            inline void skipWhitespace();
+
             /**
              * @return true if the next field in our stream matches field.
              * Handles single quoted, double quoted, and unquoted field names
@@ -179,6 +179,29 @@ namespace mongo {
         ASSERT( !andOp.matchesBSON( BSON( "a" << 10 << "b" << 6 ), NULL ) );
     }
 
+    TEST( AndOp, MatchesManyClausesOnWideDocument ) {
+        // Enough clauses and fields that the document's fields are looked up through an index.
+        BSONObj operand = BSON( "$lt" << 100 );
+        AndMatchExpression andOp;
+        for ( int i = 0; i < 10; i++ ) {
+            auto_ptr<ComparisonMatchExpression> sub( new LTMatchExpression() );
+            ASSERT( sub->init( BSONObjBuilder::numStr( i * 7 ), operand[ "$lt" ] ).isOK() );
+            andOp.add( sub.release() );
+        }
+
+        BSONObjBuilder matching;
+        BSONObjBuilder notMatching;
+        for ( int i = 0; i < 100; i++ ) {
+            matching.append( BSONObjBuilder::numStr( i ), i );
+            notMatching.append( BSONObjBuilder::numStr( i ), i == 63 ? 100 : i );
+        }
+        // Only the first of two fields with the same name is matched.
+        matching.append( "0", 100 );
+
+        ASSERT( andOp.matchesBSON( matching.obj(), NULL ) );
+        ASSERT( !andOp.matchesBSON( notMatching.obj(), NULL ) );
+    }
+
     TEST( AndOp, ElemMatchKey ) {
         BSONObj baseOperand1 = BSON( "a" << 1 );
         BSONObj baseOperand2 = BSON( "b" << 2 );
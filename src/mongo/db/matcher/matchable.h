@@ -78,13 +78,13 @@ namespace mongo {
         BSONMatchableDocument( const BSONObj& obj );
         virtual ~BSONMatchableDocument();
 
-        virtual BSONObj toBSON() const { return _obj; }
+        virtual BSONObj toBSON() const { return _fieldIndex.getObj(); }
 
         virtual ElementIterator* allocateIterator( const ElementPath* path ) const {
             if ( _iteratorUsed )
-                return new BSONElementIterator( path, _obj );
+                return new BSONElementIterator( path, _fieldIndex.getObj(), &_fieldIndex );
             _iteratorUsed = true;
-            _iterator.reset( path, _obj );
+            _iterator.reset( path, _fieldIndex.getObj(), &_fieldIndex );
             return &_iterator;
         }
 
@@ -98,7 +98,8 @@ namespace mongo {
         }
 
     private:
-        BSONObj _obj;
+        // Expressions with many clauses look up many fields of the same document.
+        mutable BSONFieldIndex _fieldIndex;
         mutable BSONElementIterator _iterator;
         mutable bool _iteratorUsed;
     };
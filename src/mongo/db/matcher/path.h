@@ -34,6 +34,7 @@
 
 #include "mongo/base/status.h"
 #include "mongo/base/string_data.h"
+#include "mongo/bson/bson_field_index.h"
 #include "mongo/bson/bsonobj.h"
 #include "mongo/bson/bsonobjiterator.h"
 #include "mongo/db/field_ref.h"
@@ -116,11 +117,20 @@ namespace mongo {
     class BSONElementIterator : public ElementIterator {
     public:
         BSONElementIterator();
-        BSONElementIterator( const ElementPath* path, const BSONObj& context );
+
+        /**
+         * If 'contextIndex' is not NULL it must index 'context', and is used to find the first
+         * part of the path.
+         */
+        BSONElementIterator( const ElementPath* path,
+                             const BSONObj& context,
+                             BSONFieldIndex* contextIndex = NULL );
 
         virtual ~BSONElementIterator();
 
-        void reset( const ElementPath* path, const BSONObj& context );
+        void reset( const ElementPath* path,
+                    const BSONObj& context,
+                    BSONFieldIndex* contextIndex = NULL );
 
         bool more();
         Context next();
@@ -128,6 +138,7 @@ namespace mongo {
     private:
         const ElementPath* _path;
         BSONObj _context;
+        BSONFieldIndex* _contextIndex;
 
         enum State { BEGIN, IN_ARRAY, DONE } _state;
         Context _next;
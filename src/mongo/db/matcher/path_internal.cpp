@@ -42,7 +42,8 @@ namespace mongo {
 
     BSONElement getFieldDottedOrArray( const BSONObj& doc,
                                        const FieldRef& path,
-                                       size_t* idxPath ) {
+                                       size_t* idxPath,
+                                       BSONFieldIndex* docIndex ) {
         if ( path.numParts() == 0 )
             return doc.getField( "" );
 
@@ -53,7 +54,10 @@ namespace mongo {
         size_t partNum = 0;
         while ( partNum < path.numParts() && !stop ) {
 
-            res = curr.getField( path.getPart( partNum ) );
+            if ( partNum == 0 && docIndex )
+                res = docIndex->getField( path.getPart( partNum ) );
+            else
+                res = curr.getField( path.getPart( partNum ) );
 
             switch ( res.type() ) {
 
@@ -0,0 +1,332 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/pch.h"
+
+#include "mongo/db/pipeline/columnar_expression.h"
+
+namespace mongo {
+
+    using std::vector;
+
+    namespace {
+        /**
+         * Returns 'column' as doubles, converting Int and Long columns into 'scratch' the same way
+         * Value::coerceToDouble() would.
+         */
+        template <typename Column>
+        const vector<double>& asDoubles(const Column& column, vector<double>* scratch) {
+            if (column.type == NumberDouble)
+                return column.doubles;
+
+            const size_t n = column.longs.size();
+            const long long* in = &column.longs[0];
+            scratch->resize(n);
+            double* out = &(*scratch)[0];
+            for (size_t i = 0; i < n; ++i)
+                out[i] = static_cast<double>(in[i]);
+            return *scratch;
+        }
+
+        /**
+         * Types an integral result computed from Int operands.  Value::createIntOrLong() would
+         * make each row an Int if it fits and a Long otherwise, so this fails unless every row
+         * comes out the same way.
+         */
+        template <typename Column>
+        bool narrowIntResult(Column* column) {
+            const size_t n = column->longs.size();
+            const long long* values = &column->longs[0];
+            size_t fit = 0;
+            for (size_t i = 0; i < n; ++i)
+                fit += (static_cast<int>(values[i]) == values[i]);
+
+            if (fit == n) {
+                column->type = NumberInt;
+                return true;
+            }
+            if (fit == 0) {
+                column->type = NumberLong;
+                return true;
+            }
+            return false;
+        }
+    }
+
+    ColumnarExpression* ColumnarExpression::compile(const intrusive_ptr<Expression>& expr) {
+        // A lone field path or constant gains nothing from being loaded into a column.
+        if (!dynamic_cast<ExpressionNary*>(expr.get()))
+            return NULL;
+
+        std::auto_ptr<ColumnarExpression> columnar(new ColumnarExpression());
+        if (!compileInto(expr, &columnar->_program))
+            return NULL;
+        return columnar.release();
+    }
+
+    bool ColumnarExpression::compileInto(const intrusive_ptr<Expression>& expr,
+                                         vector<Instruction>* program) {
+        Instruction insn;
+
+        if (dynamic_cast<ExpressionFieldPath*>(expr.get())) {
+            insn.op = LOAD;
+            insn.load = expr;
+            program->push_back(insn);
+            return true;
+        }
+
+        if (ExpressionConstant* constant = dynamic_cast<ExpressionConstant*>(expr.get())) {
+            if (!constant->getValue().numeric())
+                return false;
+            insn.op = CONSTANT;
+            insn.constant = constant->getValue();
+            program->push_back(insn);
+            return true;
+        }
+
+        if (dynamic_cast<ExpressionAdd*>(expr.get()))
+            insn.op = ADD;
+        else if (dynamic_cast<ExpressionSubtract*>(expr.get()))
+            insn.op = SUBTRACT;
+        else if (dynamic_cast<ExpressionMultiply*>(expr.get()))
+            insn.op = MULTIPLY;
+        else if (dynamic_cast<ExpressionDivide*>(expr.get()))
+            insn.op = DIVIDE;
+        else
+            return false;
+
+        const vector<intrusive_ptr<Expression> >& operands =
+            static_cast<ExpressionNary*>(expr.get())->getOperands();
+        for (size_t i = 0; i < operands.size(); ++i) {
+            if (!compileInto(operands[i], program))
+                return false;
+            insn.operands.push_back(program->size() - 1);
+        }
+
+        program->push_back(insn);
+        return true;
+    }
+
+    bool ColumnarExpression::evaluate(const vector<Document>& batch,
+                                      Variables* vars,
+                                      vector<Value>* results) const {
+        results->clear();
+        if (batch.empty())
+            return true;
+
+        vector<Column> columns(_program.size());
+        for (size_t i = 0; i < _program.size(); ++i) {
+            if (!execute(_program[i], batch, vars, columns, &columns[i]))
+                return false;
+        }
+
+        const Column& result = columns.back();
+        const size_t n = batch.size();
+        results->reserve(n);
+        switch (result.type) {
+        case NumberInt:
+            for (size_t i = 0; i < n; ++i)
+                results->push_back(Value(static_cast<int>(result.longs[i])));
+            break;
+        case NumberLong:
+            for (size_t i = 0; i < n; ++i)
+                results->push_back(Value(result.longs[i]));
+            break;
+        case NumberDouble:
+            for (size_t i = 0; i < n; ++i)
+                results->push_back(Value(result.doubles[i]));
+            break;
+        default:
+            verify(false);
+        }
+        return true;
+    }
+
+    bool ColumnarExpression::execute(const Instruction& insn,
+                                     const vector<Document>& batch,
+                                     Variables* vars,
+                                     const vector<Column>& columns,
+                                     Column* out) const {
+        const size_t n = batch.size();
+
+        switch (insn.op) {
+        case LOAD: {
+            for (size_t i = 0; i < n; ++i) {
+                vars->setRoot(batch[i]);
+                const Value val = insn.load->evaluateInternal(vars);
+                if (!val.numeric() || (i > 0 && val.getType() != out->type)) {
+                    vars->clearRoot();
+                    return false;
+                }
+
+                out->type = val.getType();
+                if (out->type == NumberDouble)
+                    out->doubles.push_back(val.getDouble());
+                else
+                    out->longs.push_back(val.coerceToLong());
+            }
+            vars->clearRoot();
+            return true;
+        }
+
+        case CONSTANT:
+            out->type = insn.constant.getType();
+            if (out->type == NumberDouble)
+                out->doubles.assign(n, insn.constant.getDouble());
+            else
+                out->longs.assign(n, insn.constant.coerceToLong());
+            return true;
+
+        case ADD:
+        case MULTIPLY: {
+            // Accumulate in operand order starting from the identity, as the scalar $add and
+            // $multiply do, so that double results round identically.
+            const bool isAdd = insn.op == ADD;
+            BSONType type = NumberInt;
+            for (size_t j = 0; j < insn.operands.size(); ++j)
+                type = Value::getWidestNumeric(type, columns[insn.operands[j]].type);
+
+            if (type == NumberDouble) {
+                out->type = NumberDouble;
+                out->doubles.assign(n, isAdd ? 0.0 : 1.0);
+                double* acc = &out->doubles[0];
+                vector<double> scratch;
+                for (size_t j = 0; j < insn.operands.size(); ++j) {
+                    const double* in = &asDoubles(columns[insn.operands[j]], &scratch)[0];
+                    if (isAdd) {
+                        for (size_t i = 0; i < n; ++i)
+                            acc[i] += in[i];
+                    }
+                    else {
+                        for (size_t i = 0; i < n; ++i)
+                            acc[i] *= in[i];
+                    }
+                }
+                return true;
+            }
+
+            out->type = type;
+            out->longs.assign(n, isAdd ? 0 : 1);
+            long long* acc = &out->longs[0];
+            for (size_t j = 0; j < insn.operands.size(); ++j) {
+                const long long* in = &columns[insn.operands[j]].longs[0];
+                if (isAdd) {
+                    for (size_t i = 0; i < n; ++i)
+                        acc[i] += in[i];
+                }
+                else {
+                    for (size_t i = 0; i < n; ++i)
+                        acc[i] *= in[i];
+                }
+            }
+            return type == NumberLong || narrowIntResult(out);
+        }
+
+        case SUBTRACT: {
+            const Column& lhs = columns[insn.operands[0]];
+            const Column& rhs = columns[insn.operands[1]];
+            const BSONType type = Value::getWidestNumeric(lhs.type, rhs.type);
+
+            if (type == NumberDouble) {
+                vector<double> lhsScratch;
+                vector<double> rhsScratch;
+                const double* left = &asDoubles(lhs, &lhsScratch)[0];
+                const double* right = &asDoubles(rhs, &rhsScratch)[0];
+                out->type = NumberDouble;
+                out->doubles.resize(n);
+                double* diff = &out->doubles[0];
+                for (size_t i = 0; i < n; ++i)
+                    diff[i] = left[i] - right[i];
+                return true;
+            }
+
+            const long long* left = &lhs.longs[0];
+            const long long* right = &rhs.longs[0];
+            out->type = type;
+            out->longs.resize(n);
+            long long* diff = &out->longs[0];
+            for (size_t i = 0; i < n; ++i)
+                diff[i] = left[i] - right[i];
+            return type == NumberLong || narrowIntResult(out);
+        }
+
+        case DIVIDE: {
+            vector<double> numerScratch;
+            vector<double> denomScratch;
+            const double* numer = &asDoubles(columns[insn.operands[0]], &numerScratch)[0];
+            const double* denom = &asDoubles(columns[insn.operands[1]], &denomScratch)[0];
+
+            // Leave reporting division by zero to the scalar $divide.
+            size_t zeros = 0;
+            for (size_t i = 0; i < n; ++i)
+                zeros += (denom[i] == 0);
+            if (zeros)
+                return false;
+
+            out->type = NumberDouble;
+            out->doubles.resize(n);
+            double* quot = &out->doubles[0];
+            for (size_t i = 0; i < n; ++i)
+                quot[i] = numer[i] / denom[i];
+            return true;
+        }
+        }
+
+        verify(false);
+        return false;
+    }
+
+    ExpressionColumnarField::ExpressionColumnarField(const intrusive_ptr<Expression>& original,
+                                                     ColumnarExpression* columnar,
+                                                     const size_t* row)
+        : _original(original)
+        , _columnar(columnar)
+        , _row(row)
+        , _haveResults(false)
+    { }
+
+    void ExpressionColumnarField::evaluateBatch(const vector<Document>& batch, Variables* vars) {
+        _haveResults = _columnar->evaluate(batch, vars, &_results);
+    }
+
+    void ExpressionColumnarField::addDependencies(DepsTracker* deps,
+                                                  vector<string>* path) const {
+        _original->addDependencies(deps, path);
+    }
+
+    Value ExpressionColumnarField::evaluateInternal(Variables* vars) const {
+        if (_haveResults)
+            return _results[*_row];
+        return _original->evaluateInternal(vars);
+    }
+
+    Value ExpressionColumnarField::serialize(bool explain) const {
+        return _original->serialize(explain);
+    }
+
+}
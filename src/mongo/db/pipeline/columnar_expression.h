@@ -0,0 +1,141 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/scoped_ptr.hpp>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/expression.h"
+#include "mongo/db/pipeline/value.h"
+
+namespace mongo {
+
+    /**
+     * Evaluates an arithmetic Expression over a whole batch of Documents at once.
+     *
+     * Only field paths, numeric constants, $add, $subtract, $multiply and $divide are supported.
+     * The operands are pulled out of the Documents into typed columns up front, and each operator
+     * is then a plain loop over contiguous doubles or longs that the compiler can vectorize,
+     * rather than a tree walk per Document that boxes every intermediate result in a Value.
+     *
+     * Results are exactly those of evaluating the Expression on each Document, including the
+     * Int/Long/Double typing rules.  When a batch can't be handled that way (a non-numeric or
+     * missing operand, an operand whose numeric type differs between Documents, a zero divisor,
+     * or an int result that overflows to long for only some Documents), evaluate() rejects the
+     * whole batch and the caller falls back to evaluating the Documents one at a time.
+     */
+    class ColumnarExpression {
+        MONGO_DISALLOW_COPYING(ColumnarExpression);
+    public:
+        /**
+         * Returns NULL if 'expr' isn't an arithmetic operator or contains anything that can't be
+         * evaluated over columns.  The caller owns the result.
+         */
+        static ColumnarExpression* compile(const intrusive_ptr<Expression>& expr);
+
+        /**
+         * Evaluates the Expression with each Document of 'batch' as the root of 'vars'.  Returns
+         * true and puts one result per Document in 'results', or returns false if the batch has
+         * to be evaluated one Document at a time.
+         */
+        bool evaluate(const std::vector<Document>& batch,
+                      Variables* vars,
+                      std::vector<Value>* results) const;
+
+    private:
+        enum OpCode {
+            LOAD,       // evaluate a field path per Document
+            CONSTANT,
+            ADD,
+            SUBTRACT,
+            MULTIPLY,
+            DIVIDE
+        };
+
+        struct Instruction {
+            OpCode op;
+            intrusive_ptr<Expression> load;     // for LOAD
+            Value constant;                     // for CONSTANT
+            std::vector<size_t> operands;       // indexes of earlier instructions
+        };
+
+        // A column of numbers all of one type.  Int and Long columns are held in 'longs'.
+        struct Column {
+            BSONType type;
+            std::vector<long long> longs;
+            std::vector<double> doubles;
+        };
+
+        ColumnarExpression() {}
+
+        static bool compileInto(const intrusive_ptr<Expression>& expr,
+                                std::vector<Instruction>* program);
+
+        bool execute(const Instruction& insn,
+                     const std::vector<Document>& batch,
+                     Variables* vars,
+                     const std::vector<Column>& columns,
+                     Column* out) const;
+
+        // Operands come before the instructions using them; the last one is the result.
+        std::vector<Instruction> _program;
+    };
+
+    /**
+     * Stands in for a top-level computed field of a $project whose Expression compiled to a
+     * ColumnarExpression.  DocumentSourceProject calls evaluateBatch() on each batch it pulls and
+     * then projects the Documents one by one as usual, with 'row' giving the position within the
+     * batch.  evaluateInternal() returns the precomputed result for that row, or evaluates the
+     * original Expression if the batch was rejected.  Serializes as the original Expression.
+     */
+    class ExpressionColumnarField : public Expression {
+    public:
+        ExpressionColumnarField(const intrusive_ptr<Expression>& original,
+                                ColumnarExpression* columnar,
+                                const size_t* row);
+
+        void evaluateBatch(const std::vector<Document>& batch, Variables* vars);
+
+        // virtuals from Expression
+        virtual void addDependencies(DepsTracker* deps, std::vector<std::string>* path=NULL) const;
+        virtual Value evaluateInternal(Variables* vars) const;
+        virtual Value serialize(bool explain) const;
+
+    private:
+        intrusive_ptr<Expression> _original;
+        boost::scoped_ptr<ColumnarExpression> _columnar;
+        const size_t* _row;
+
+        bool _haveResults;
+        std::vector<Value> _results;
+    };
+
+}
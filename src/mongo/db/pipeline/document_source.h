@@ -37,6 +37,7 @@
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/matcher.h"
+#include "mongo/db/pipeline/columnar_expression.h"
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/dependencies.h"
 #include "mongo/db/pipeline/expression_context.h"
@@ -55,6 +56,7 @@ namespace mongo {
     class ExpressionFieldPath;
     class ExpressionObject;
     class DocumentSourceLimit;
+    class DocumentSourceUnwind;
     class PlanExecutor;
 
     class DocumentSource : public IntrusiveCounterUnsigned {
@@ -463,6 +465,16 @@ namespace mongo {
         /// Tell this source if it is doing a merge from shards. Defaults to false.
         void setDoingMerge(bool doingMerge) { _doingMerge = doingMerge; }
 
+        /**
+         * Takes over the work of 'unwind', which must immediately precede this stage, so that
+         * whole documents are pulled from the $unwind's source and their arrays unwound as they
+         * are grouped.  The $unwind should then be removed from the pipeline.
+         */
+        void fuseUnwind(const intrusive_ptr<DocumentSourceUnwind>& unwind);
+
+        /// Also serializes a fused $unwind, as the stage before this one.
+        virtual void serializeToArray(std::vector<Value>& array, bool explain = false) const;
+
         /**
           Create a grouping DocumentSource from BSON.
 
@@ -542,6 +554,9 @@ namespace mongo {
 
         Document makeDocument(const Value& id, const Accumulators& accums, bool mergeableOutput);
 
+        // A preceding $unwind fused into this stage by fuseUnwind(), or NULL.
+        intrusive_ptr<DocumentSourceUnwind> _unwind;
+
         bool _doingMerge;
         bool _spilled;
         const bool _extSortAllowed;
@@ -600,6 +615,12 @@ namespace mongo {
         static bool isTextQuery(const BSONObj& query);
         bool isTextQuery() const { return _isTextQuery; }
 
+        /** Returns true if the query refers to no fields other than 'path' and its subfields. */
+        bool dependsOnlyOnPath(const std::string& path) const;
+
+        /** Returns true if 'obj' matches the query. */
+        bool matches(const BSONObj& obj) const { return matcher->matches(obj); }
+
     private:
         DocumentSourceMatch(const BSONObj &query,
             const intrusive_ptr<ExpressionContext> &pExpCtx);
@@ -749,14 +770,32 @@ namespace mongo {
         /** projection as specified by the user */
         BSONObj getRaw() const { return _raw; }
 
+        /** Number of documents pulled at a time when some fields are computed over columns. */
+        static const size_t kBatchSize = 256;
+
     private:
         DocumentSourceProject(const intrusive_ptr<ExpressionContext>& pExpCtx,
                               const intrusive_ptr<ExpressionObject>& exprObj);
 
+        /**
+         * Swaps every top-level computed field that ColumnarExpression can handle for an
+         * ExpressionColumnarField.  Done on the first getNext() so that it follows optimize().
+         */
+        void prepareColumnarFields();
+
+        /** Next input document, from _batch if there are columnar fields. */
+        boost::optional<Document> nextInput();
+
         // configuration state
         boost::scoped_ptr<Variables> _variables;
         intrusive_ptr<ExpressionObject> pEO;
         BSONObj _raw;
+
+        // batched evaluation state
+        bool _columnarPrepared;
+        std::vector<intrusive_ptr<ExpressionColumnarField> > _columnarFields;
+        std::vector<Document> _batch;
+        size_t _batchRow;
     };
 
     class DocumentSourceRedact :
@@ -1020,9 +1059,22 @@ namespace mongo {
         virtual boost::optional<Document> getNext();
         virtual const char *getSourceName() const;
         virtual Value serialize(bool explain = false) const;
+        virtual bool coalesce(const intrusive_ptr<DocumentSource>& nextSource);
+
+        /// Also serializes a $match coalesced into this stage, after this one.
+        virtual void serializeToArray(std::vector<Value>& array, bool explain = false) const;
 
         virtual GetDepsReturn getDependencies(DepsTracker* deps) const;
 
+        /**
+         * Returns the next document unwound from the documents of 'source'.  getNext() does this
+         * on pSource; a $group that this stage has been fused into does it on its own source.
+         */
+        boost::optional<Document> unwindNext(DocumentSource* source);
+
+        /// Whether a $match has been coalesced into this stage.
+        bool hasElementMatch() const { return _elementMatch.get() != NULL; }
+
         /**
           Create a new projection DocumentSource from BSON.
 
@@ -1048,6 +1100,10 @@ namespace mongo {
         // Configuration state.
         scoped_ptr<FieldPath> _unwindPath;
 
+        // A following $match that only looks at the unwound field, applied to each array element
+        // before a document is made for it.
+        intrusive_ptr<DocumentSourceMatch> _elementMatch;
+
         // Iteration state.
         class Unwinder;
         scoped_ptr<Unwinder> _unwinder;
@@ -170,7 +170,21 @@ namespace mongo {
         return Value(DOC(getSourceName() << insides.freeze()));
     }
 
+    void DocumentSourceGroup::serializeToArray(vector<Value>& array, bool explain) const {
+        if (_unwind)
+            _unwind->serializeToArray(array, explain);
+        DocumentSource::serializeToArray(array, explain);
+    }
+
+    void DocumentSourceGroup::fuseUnwind(const intrusive_ptr<DocumentSourceUnwind>& unwind) {
+        verify(!_unwind && !populated);
+        _unwind = unwind;
+    }
+
     DocumentSource::GetDepsReturn DocumentSourceGroup::getDependencies(DepsTracker* deps) const {
+        if (_unwind)
+            _unwind->getDependencies(deps);
+
         // add the _id
         for (size_t i = 0; i < _idExpressions.size(); i++) {
             _idExpressions[i]->addDependencies(deps);
@@ -356,7 +370,9 @@ namespace mongo {
         int memoryUsageBytes = 0;
 
         // This loop consumes all input from pSource and buckets it based on pIdExpression.
-        while (boost::optional<Document> input = pSource->getNext()) {
+        // With a fused $unwind, the arrays in pSource's documents are unwound right here.
+        while (boost::optional<Document> input = _unwind ? _unwind->unwindNext(pSource)
+                                                         : pSource->getNext()) {
             if (memoryUsageBytes > _maxMemoryUsageBytes) {
                 uassert(16945, "Exceeded memory limit for $group, but didn't allow external sort."
                                " Pass allowDiskUse:true to opt in.",
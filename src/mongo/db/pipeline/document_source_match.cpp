@@ -292,6 +292,39 @@ namespace {
         return redactSafePortionTopLevel(getQuery()).toBson();
     }
 
+    namespace {
+        bool queryDependsOnlyOnPath(const BSONObj& query, StringData path) {
+            BSONForEach(e, query) {
+                const StringData fieldName = e.fieldNameStringData();
+                if (fieldName == "$and" || fieldName == "$or" || fieldName == "$nor") {
+                    if (e.type() != Array)
+                        return false;
+                    BSONForEach(clause, e.Obj()) {
+                        if (clause.type() != Object
+                                || !queryDependsOnlyOnPath(clause.Obj(), path))
+                            return false;
+                    }
+                    continue;
+                }
+
+                // Other top level operators such as $where may look at the whole document.
+                if (fieldName.startsWith("$"))
+                    return false;
+
+                if (fieldName == path)
+                    continue;
+                if (fieldName.startsWith(path) && fieldName[path.size()] == '.')
+                    continue;
+                return false;
+            }
+            return true;
+        }
+    }
+
+    bool DocumentSourceMatch::dependsOnlyOnPath(const string& path) const {
+        return queryDependsOnlyOnPath(getQuery(), path);
+    }
+
     void DocumentSourceMatch::setSource(DocumentSource* source) {
         uassert(17313, "$match with $text is only allowed as the first pipeline stage",
                 !_isTextQuery);
@@ -37,11 +37,14 @@
 namespace mongo {
 
     const char DocumentSourceProject::projectName[] = "$project";
+    const size_t DocumentSourceProject::kBatchSize;
 
     DocumentSourceProject::DocumentSourceProject(const intrusive_ptr<ExpressionContext>& pExpCtx,
                                                  const intrusive_ptr<ExpressionObject>& exprObj)
         : DocumentSource(pExpCtx)
         , pEO(exprObj)
+        , _columnarPrepared(false)
+        , _batchRow(0)
     { }
 
     const char *DocumentSourceProject::getSourceName() const {
@@ -51,7 +54,10 @@ namespace mongo {
     boost::optional<Document> DocumentSourceProject::getNext() {
         pExpCtx->checkForInterrupt();
 
-        boost::optional<Document> input = pSource->getNext();
+        if (!_columnarPrepared)
+            prepareColumnarFields();
+
+        boost::optional<Document> input = nextInput();
         if (!input)
             return boost::none;
 
@@ -73,6 +79,50 @@ namespace mongo {
         return out.freeze();
     }
 
+    void DocumentSourceProject::prepareColumnarFields() {
+        _columnarPrepared = true;
+
+        const ExpressionObject::FieldMap& fields = pEO->getChildExpressions();
+        for (ExpressionObject::FieldMap::const_iterator it = fields.begin();
+                it != fields.end(); ++it) {
+            // Inclusions and subobjects depend on the shape of each input document.
+            if (!it->second || dynamic_cast<ExpressionObject*>(it->second.get()))
+                continue;
+
+            ColumnarExpression* columnar = ColumnarExpression::compile(it->second);
+            if (!columnar)
+                continue;
+
+            _columnarFields.push_back(
+                new ExpressionColumnarField(it->second, columnar, &_batchRow));
+            pEO->replaceChildExpression(it->first, _columnarFields.back());
+        }
+    }
+
+    boost::optional<Document> DocumentSourceProject::nextInput() {
+        if (_columnarFields.empty())
+            return pSource->getNext();
+
+        if (++_batchRow >= _batch.size()) {
+            _batch.clear();
+            _batchRow = 0;
+            while (_batch.size() < kBatchSize) {
+                boost::optional<Document> next = pSource->getNext();
+                if (!next)
+                    break;
+                _batch.push_back(*next);
+            }
+
+            if (_batch.empty())
+                return boost::none;
+
+            for (size_t i = 0; i < _columnarFields.size(); ++i)
+                _columnarFields[i]->evaluateBatch(_batch, _variables.get());
+        }
+
+        return _batch[_batchRow];
+    }
+
     void DocumentSourceProject::optimize() {
         intrusive_ptr<Expression> pE(pEO->optimize());
         pEO = dynamic_pointer_cast<ExpressionObject>(pE);
@@ -52,9 +52,21 @@ namespace mongo {
          */
         boost::optional<Document> getNext();
 
+        /**
+         * Only unwind array elements matched by 'elementMatch', which must only depend on the
+         * unwound field.  Pass NULL to unwind every element.
+         */
+        void setElementMatch(const DocumentSourceMatch* elementMatch) {
+            _elementMatch = elementMatch;
+        }
+
     private:
+        /** Whether 'element' would be matched once set at the unwind path of a document. */
+        bool elementMatches(const Value& element) const;
+
         // Path to the array to unwind.
         const FieldPath _unwindPath;
+        const DocumentSourceMatch* _elementMatch;
 
         Value _inputArray;
         MutableDocument _output;
@@ -66,7 +78,8 @@ namespace mongo {
     };
 
     DocumentSourceUnwind::Unwinder::Unwinder(const FieldPath& unwindPath):
-        _unwindPath(unwindPath) {
+        _unwindPath(unwindPath),
+        _elementMatch(NULL) {
     }
 
     void DocumentSourceUnwind::Unwinder::resetDocument(const Document& document) {
@@ -93,7 +106,14 @@ namespace mongo {
     }
 
     boost::optional<Document> DocumentSourceUnwind::Unwinder::getNext() {
-        if (_inputArray.missing() || _index == _inputArray.getArrayLength())
+        if (_inputArray.missing())
+            return boost::none;
+
+        const size_t length = _inputArray.getArrayLength();
+        while (_index < length && _elementMatch && !elementMatches(_inputArray[_index]))
+            _index++;
+
+        if (_index == length)
             return boost::none;
 
         // If needed, this will automatically clone all the documents along the
@@ -108,6 +128,31 @@ namespace mongo {
         return _output.peek();
     }
 
+    namespace {
+        /** Appends 'value' to 'builder' nested at 'path', starting from its 'level'th field. */
+        void appendAtPath(BSONObjBuilder* builder,
+                          const FieldPath& path,
+                          size_t level,
+                          const Value& value) {
+            if (level + 1 == path.getPathLength()) {
+                value.addToBsonObj(builder, path.getFieldName(level));
+                return;
+            }
+
+            BSONObjBuilder sub(builder->subobjStart(path.getFieldName(level)));
+            appendAtPath(&sub, path, level + 1, value);
+            sub.done();
+        }
+    }
+
+    bool DocumentSourceUnwind::Unwinder::elementMatches(const Value& element) const {
+        // The match only looks at the unwound field, so rather than converting the whole
+        // document to BSON, build {a: {b: element}} for an unwind path of "a.b".
+        BSONObjBuilder builder;
+        appendAtPath(&builder, _unwindPath, 0, element);
+        return _elementMatch->matches(builder.done());
+    }
+
     const char DocumentSourceUnwind::unwindName[] = "$unwind";
 
     DocumentSourceUnwind::DocumentSourceUnwind(
@@ -122,11 +167,15 @@ namespace mongo {
     boost::optional<Document> DocumentSourceUnwind::getNext() {
         pExpCtx->checkForInterrupt();
 
+        return unwindNext(pSource);
+    }
+
+    boost::optional<Document> DocumentSourceUnwind::unwindNext(DocumentSource* source) {
         boost::optional<Document> out = _unwinder->getNext();
         while (!out) {
             // No more elements in array currently being unwound. This will loop if the input
-            // document is missing the unwind field or has an empty array.
-            boost::optional<Document> input = pSource->getNext();
+            // document is missing the unwind field, has an empty array or no element is matched.
+            boost::optional<Document> input = source->getNext();
             if (!input)
                 return boost::none; // input exhausted
 
@@ -143,6 +192,25 @@ namespace mongo {
         return Value(DOC(getSourceName() << _unwindPath->getPath(true)));
     }
 
+    bool DocumentSourceUnwind::coalesce(const intrusive_ptr<DocumentSource>& nextSource) {
+        DocumentSourceMatch* match = dynamic_cast<DocumentSourceMatch*>(nextSource.get());
+        if (!match || !match->dependsOnlyOnPath(_unwindPath->getPath(false)))
+            return false;
+
+        if (_elementMatch)
+            return _elementMatch->coalesce(nextSource);
+
+        _elementMatch = match;
+        _unwinder->setElementMatch(match);
+        return true;
+    }
+
+    void DocumentSourceUnwind::serializeToArray(vector<Value>& array, bool explain) const {
+        DocumentSource::serializeToArray(array, explain);
+        if (_elementMatch)
+            _elementMatch->serializeToArray(array, explain);
+    }
+
     DocumentSource::GetDepsReturn DocumentSourceUnwind::getDependencies(DepsTracker* deps) const {
         deps->fields.insert(_unwindPath->getPath(false));
         return SEE_NEXT;
@@ -1270,6 +1270,13 @@ namespace {
         return Value(evaluateDocument(vars));
     }
 
+    void ExpressionObject::replaceChildExpression(const std::string& fieldName,
+                                                  const intrusive_ptr<Expression>& pExpression) {
+        FieldMap::iterator it = _expressions.find(fieldName);
+        verify(it != _expressions.end() && it->second && pExpression);
+        it->second = pExpression;
+    }
+
     void ExpressionObject::addField(const FieldPath &fieldPath,
                                     const intrusive_ptr<Expression> &pExpression) {
         const string fieldPart = fieldPath.getFieldName(0);
@@ -321,6 +321,8 @@ namespace mongo {
             BSONElement bsonExpr,
             const VariablesParseState& vps);
 
+        const ExpressionVector& getOperands() const { return vpOperand; }
+
     protected:
         ExpressionNary() {}
 
@@ -858,12 +860,19 @@ namespace mongo {
 
         void excludeId(bool b) { _excludeId = b; }
 
-    private:
-        ExpressionObject(bool atRoot);
-
         // Mapping from fieldname to the Expression that generates its value.
         // NULL expression means inclusion from source document.
         typedef std::map<std::string, intrusive_ptr<Expression> > FieldMap;
+
+        const FieldMap& getChildExpressions() const { return _expressions; }
+
+        /** Replaces the Expression computing an existing field, keeping its output position. */
+        void replaceChildExpression(const std::string& fieldName,
+                                    const intrusive_ptr<Expression>& pExpression);
+
+    private:
+        ExpressionObject(bool atRoot);
+
         FieldMap _expressions;
 
         // this is used to maintain order for generated fields not in the source document
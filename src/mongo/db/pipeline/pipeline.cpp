@@ -215,6 +215,7 @@ namespace mongo {
         Optimizations::Local::coalesceAdjacent(pPipeline.get());
         Optimizations::Local::optimizeEachDocumentSource(pPipeline.get());
         Optimizations::Local::duplicateMatchBeforeInitalRedact(pPipeline.get());
+        Optimizations::Local::fuseUnwindIntoGroup(pPipeline.get());
 
         return pPipeline;
     }
@@ -319,6 +320,21 @@ namespace mongo {
         }
     }
 
+    void Pipeline::Optimizations::Local::fuseUnwindIntoGroup(Pipeline* pipeline) {
+        SourceContainer& sources = pipeline->sources;
+        for (SourceContainer::iterator it(sources.begin()); it != sources.end(); ++it) {
+            intrusive_ptr<DocumentSourceUnwind> unwind =
+                dynamic_cast<DocumentSourceUnwind*>(it->get());
+            if (!unwind || it + 1 == sources.end())
+                continue;
+
+            if (DocumentSourceGroup* group = dynamic_cast<DocumentSourceGroup*>((it + 1)->get())) {
+                group->fuseUnwind(unwind);
+                it = sources.erase(it);
+            }
+        }
+    }
+
     void Pipeline::addRequiredPrivileges(Command* commandTemplate,
                                          const string& db,
                                          BSONObj cmdObj,
@@ -392,8 +408,13 @@ namespace mongo {
 
     void Pipeline::Optimizations::Sharded::moveFinalUnwindFromShardsToMerger(Pipeline* shardPipe,
                                                                              Pipeline* mergePipe) {
-        while (!shardPipe->sources.empty()
-                && dynamic_cast<DocumentSourceUnwind*>(shardPipe->sources.back().get())) {
+        while (!shardPipe->sources.empty()) {
+            DocumentSourceUnwind* unwind =
+                dynamic_cast<DocumentSourceUnwind*>(shardPipe->sources.back().get());
+            // An $unwind that also filters the array elements is best left on the shards.
+            if (!unwind || unwind->hasElementMatch())
+                break;
+
             mergePipe->sources.push_front(shardPipe->sources.back());
             shardPipe->sources.pop_back();
         }
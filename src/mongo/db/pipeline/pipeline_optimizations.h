@@ -87,6 +87,17 @@ namespace mongo {
          * BSONObjs converted to Documents.
          */
         static void duplicateMatchBeforeInitalRedact(Pipeline* pipeline);
+
+        /**
+         * Fuses each $unwind immediately followed by a $group into the $group.
+         *
+         * The $group then unwinds the arrays itself as it groups, saving a pass through the
+         * pipeline per array element. Run after coalesceAdjacent() so that a $match on the unwound
+         * field between the two has already been coalesced into the $unwind.
+         *
+         * NOTE: uses DocumentSourceGroup::fuseUnwind()
+         */
+        static void fuseUnwindIntoGroup(Pipeline* pipeline);
     };
 
     /**
@@ -109,7 +120,7 @@ namespace mongo {
         /**
          * If the final stage on shards is to unwind an array, move that stage to the merger. This
          * cuts down on network traffic and allows us to take advantage of reduced copying in
-         * unwind.
+         * unwind. An $unwind that has a $match coalesced into it stays on the shards.
          */
         static void moveFinalUnwindFromShardsToMerger(Pipeline* shardPipe, Pipeline* mergePipe);
 
@@ -307,6 +307,25 @@ namespace mongo {
                 bob->appendNumber("alreadyHasObj", spec->alreadyHasObj);
             }
         }
+        else if (STAGE_GEO_NEAR_2D == stats.stageType
+                 || STAGE_GEO_NEAR_2DSPHERE == stats.stageType) {
+            NearStats* spec = static_cast<NearStats*>(stats.specific.get());
+
+            bob->append("keyPattern", spec->keyPattern);
+
+            if (verbosity >= ExplainCommon::EXEC_STATS) {
+                BSONArrayBuilder intervalsBob(bob->subarrayStart("searchIntervals"));
+                for (vector<IntervalStats>::const_iterator it = spec->intervalStats.begin();
+                     it != spec->intervalStats.end(); ++it) {
+                    BSONObjBuilder intervalBob(intervalsBob.subobjStart());
+                    intervalBob.append("minDistance", it->minDistanceAllowed);
+                    intervalBob.append("maxDistance", it->maxDistanceAllowed);
+                    intervalBob.appendBool("maxInclusive", it->inclusiveMaxDistanceAllowed);
+                    intervalBob.appendNumber("nResultsFound", it->numResultsFound);
+                    intervalBob.appendNumber("nResultsBuffered", it->numResultsBuffered);
+                }
+            }
+        }
         else if (STAGE_GROUP == stats.stageType) {
             GroupStats* spec = static_cast<GroupStats*>(stats.specific.get());
             if (verbosity >= ExplainCommon::EXEC_STATS) {
@@ -409,6 +428,9 @@ namespace mongo {
 
             bob->append("indexPrefix", spec->indexPrefix);
             bob->append("parsedTextQuery", spec->parsedTextQuery);
+            if (0 != spec->limit) {
+                bob->appendNumber("limit", spec->limit);
+            }
         }
         else if (STAGE_UPDATE == stats.stageType) {
             UpdateStats* spec = static_cast<UpdateStats*>(stats.specific.get());
@@ -44,4 +44,10 @@ namespace mongo {
      */
     extern int internalGeoNearQuery2DMaxCoveringCells;
 
+    /**
+     * The number of $geoWithin/$geoIntersects coverings the planner remembers.  Zero disables
+     * the cache.  Read when the cache is first used.
+     */
+    extern int internalGeoCoveringCacheSize;
+
 }  // namespace mongo
@@ -0,0 +1,150 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/db/query/geo_covering_cache.h"
+
+#include <algorithm>
+#include <boost/functional/hash.hpp>
+#include <boost/thread/locks.hpp>
+
+#include "mongo/base/counter.h"
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/query/expression_index_knobs.h"
+#include "mongo/platform/atomic_word.h"
+
+namespace mongo {
+
+    namespace {
+
+        Counter64 hitCounter;
+        Counter64 missCounter;
+
+        ServerStatusMetricField<Counter64> displayHits("query.geoCoveringCache.hits",
+                                                       &hitCounter);
+        ServerStatusMetricField<Counter64> displayMisses("query.geoCoveringCache.misses",
+                                                         &missCounter);
+
+        boost::mutex globalCacheMutex;
+        boost::scoped_ptr<GeoCoveringCache> globalCache;
+        AtomicUInt32 globalCacheInitialized;
+
+    }  // namespace
+
+    const size_t GeoCoveringCache::kDefaultNumStripes;
+
+    GeoCoveringCache::GeoCoveringCache(size_t maxSize, size_t numStripes) {
+        invariant(numStripes > 0);
+        const size_t stripeSize = std::max(size_t(1), (maxSize + numStripes - 1) / numStripes);
+        for (size_t i = 0; i < numStripes; i++) {
+            _stripes.push_back(new Stripe(stripeSize));
+        }
+    }
+
+    GeoCoveringCache::Stripe* GeoCoveringCache::_stripeFor(const std::string& key) const {
+        return _stripes[boost::hash<std::string>()(key) % _stripes.size()];
+    }
+
+    // static
+    std::string GeoCoveringCache::makeKey(const BSONObj& geoRawObj,
+                                          const BSONObj& indexInfoObj,
+                                          int maxCoveringCells) {
+        BSONObjBuilder bob;
+
+        // geoRawObj is {path: {$operator: geometry}}.  Only the geometry decides the covering.
+        BSONElement section = geoRawObj.firstElement();
+        if (Object == section.type() && !section.Obj().isEmpty()) {
+            bob.appendAs(section.Obj().firstElement(), "g");
+        }
+        else {
+            bob.append("g", geoRawObj);
+        }
+
+        bob.append("i", indexInfoObj);
+        bob.append("c", maxCoveringCells);
+
+        BSONObj key = bob.done();
+        return std::string(key.objdata(), key.objsize());
+    }
+
+    bool GeoCoveringCache::get(const std::string& key, OrderedIntervalList* oilOut) {
+        Stripe* stripe = _stripeFor(key);
+        boost::lock_guard<boost::mutex> lock(stripe->mutex);
+
+        Intervals* intervals;
+        if (!stripe->cache.get(key, &intervals).isOK()) {
+            missCounter.increment();
+            return false;
+        }
+
+        hitCounter.increment();
+        oilOut->intervals.insert(oilOut->intervals.end(), intervals->begin(), intervals->end());
+        return true;
+    }
+
+    void GeoCoveringCache::add(const std::string& key, const OrderedIntervalList& oil) {
+        std::auto_ptr<Intervals> intervals(new Intervals(oil.intervals));
+
+        Stripe* stripe = _stripeFor(key);
+        boost::lock_guard<boost::mutex> lock(stripe->mutex);
+        stripe->cache.add(key, intervals.release());
+    }
+
+    size_t GeoCoveringCache::size() const {
+        size_t total = 0;
+        for (size_t i = 0; i < _stripes.size(); i++) {
+            boost::lock_guard<boost::mutex> lock(_stripes[i]->mutex);
+            total += _stripes[i]->cache.size();
+        }
+        return total;
+    }
+
+    void GeoCoveringCache::clear() {
+        for (size_t i = 0; i < _stripes.size(); i++) {
+            boost::lock_guard<boost::mutex> lock(_stripes[i]->mutex);
+            _stripes[i]->cache.clear();
+        }
+    }
+
+    // static
+    GeoCoveringCache* GeoCoveringCache::getGlobal() {
+        // Every geo bounds build calls this, so only the first calls take the mutex.
+        if (globalCacheInitialized.load()) {
+            return globalCache.get();
+        }
+
+        boost::lock_guard<boost::mutex> lock(globalCacheMutex);
+        if (!globalCacheInitialized.load()) {
+            if (internalGeoCoveringCacheSize > 0) {
+                globalCache.reset(new GeoCoveringCache(internalGeoCoveringCacheSize));
+            }
+            globalCacheInitialized.store(1);
+        }
+        return globalCache.get();
+    }
+
+}  // namespace mongo
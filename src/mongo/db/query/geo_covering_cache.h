@@ -0,0 +1,107 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/owned_pointer_vector.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/query/index_bounds.h"
+#include "mongo/db/query/lru_key_value.h"
+
+namespace mongo {
+
+    /**
+     * Remembers the index intervals computed for $geoWithin and $geoIntersects regions, so that
+     * queries repeating the same region skip the region coverer during planning.
+     *
+     * Entries are keyed by the query geometry (with the operator stripped, since $geoWithin and
+     * $geoIntersects over one region cover it the same way), the spec of the index, and the
+     * covering cell limit.
+     *
+     * Thread safe.  Keys are split by hash over a number of stripes, each an LRU cache with its
+     * own lock and an equal share of the entries, so that concurrent planners rarely contend.
+     * Least recently used entries are evicted from each stripe.
+     */
+    class GeoCoveringCache {
+        MONGO_DISALLOW_COPYING(GeoCoveringCache);
+    public:
+        static const size_t kDefaultNumStripes = 16;
+
+        explicit GeoCoveringCache(size_t maxSize, size_t numStripes = kDefaultNumStripes);
+
+        /**
+         * Returns the cache key for the geo predicate 'geoRawObj', e.g.
+         * {loc: {$geoWithin: {$geometry: ...}}}, answered by the index described by
+         * 'indexInfoObj'.
+         */
+        static std::string makeKey(const BSONObj& geoRawObj,
+                                   const BSONObj& indexInfoObj,
+                                   int maxCoveringCells);
+
+        /**
+         * If 'key' is cached, appends its intervals to 'oilOut' and returns true.  Otherwise
+         * returns false.
+         */
+        bool get(const std::string& key, OrderedIntervalList* oilOut);
+
+        /**
+         * Caches the intervals of 'oil' under 'key'.
+         */
+        void add(const std::string& key, const OrderedIntervalList& oil);
+
+        size_t size() const;
+
+        void clear();
+
+        /**
+         * The cache used by the query planner, sized by internalGeoCoveringCacheSize when
+         * first used.  Returns NULL if the cache is disabled.
+         */
+        static GeoCoveringCache* getGlobal();
+
+    private:
+        typedef std::vector<Interval> Intervals;
+
+        struct Stripe {
+            explicit Stripe(size_t maxSize) : cache(maxSize) { }
+
+            mutable boost::mutex mutex;
+            LRUKeyValue<std::string, Intervals> cache;
+        };
+
+        Stripe* _stripeFor(const std::string& key) const;
+
+        OwnedPointerVector<Stripe> _stripes;
+    };
+
+}  // namespace mongo
@@ -0,0 +1,134 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+/**
+ * This file contains tests for mongo/db/query/geo_covering_cache.cpp
+ */
+
+#include "mongo/db/query/geo_covering_cache.h"
+
+#include "mongo/db/json.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/mongoutils/str.h"
+
+using namespace mongo;
+
+namespace {
+
+    const BSONObj indexInfo = fromjson("{v: 1, key: {loc: '2dsphere'}, name: 'loc_2dsphere'}");
+
+    std::string keyFor(const char* query, const BSONObj& info = indexInfo) {
+        return GeoCoveringCache::makeKey(fromjson(query), info, 16);
+    }
+
+    OrderedIntervalList makeOil(int start, int end) {
+        OrderedIntervalList oil("loc");
+        oil.intervals.push_back(Interval(BSON("" << start << "" << end), true, true));
+        return oil;
+    }
+
+    TEST(GeoCoveringCacheTest, KeyIgnoresOperator) {
+        ASSERT_EQUALS(keyFor("{loc: {$geoWithin: {$box: [[0, 0], [1, 1]]}}}"),
+                      keyFor("{loc: {$geoIntersects: {$box: [[0, 0], [1, 1]]}}}"));
+    }
+
+    TEST(GeoCoveringCacheTest, KeyDependsOnGeometry) {
+        ASSERT_NOT_EQUALS(keyFor("{loc: {$geoWithin: {$box: [[0, 0], [1, 1]]}}}"),
+                          keyFor("{loc: {$geoWithin: {$box: [[0, 0], [1, 2]]}}}"));
+    }
+
+    TEST(GeoCoveringCacheTest, KeyDependsOnIndex) {
+        BSONObj otherInfo = fromjson("{v: 1, key: {loc: '2dsphere'}, name: 'loc_2dsphere', "
+                                     "coarsestIndexedLevel: 3}");
+        ASSERT_NOT_EQUALS(keyFor("{loc: {$geoWithin: {$box: [[0, 0], [1, 1]]}}}"),
+                          keyFor("{loc: {$geoWithin: {$box: [[0, 0], [1, 1]]}}}", otherInfo));
+        ASSERT_NOT_EQUALS(GeoCoveringCache::makeKey(fromjson("{loc: {$geoWithin: {$center: "
+                                                             "[[0, 0], 1]}}}"), indexInfo, 8),
+                          GeoCoveringCache::makeKey(fromjson("{loc: {$geoWithin: {$center: "
+                                                             "[[0, 0], 1]}}}"), indexInfo, 16));
+    }
+
+    TEST(GeoCoveringCacheTest, GetAfterAdd) {
+        GeoCoveringCache cache(10);
+        OrderedIntervalList out("loc");
+        ASSERT_FALSE(cache.get("a", &out));
+        ASSERT_EQUALS(0U, out.intervals.size());
+
+        cache.add("a", makeOil(1, 2));
+        ASSERT_TRUE(cache.get("a", &out));
+        ASSERT_EQUALS(1U, out.intervals.size());
+        ASSERT_EQUALS(Interval::INTERVAL_EQUALS,
+                      out.intervals[0].compare(makeOil(1, 2).intervals[0]));
+    }
+
+    TEST(GeoCoveringCacheTest, EvictsLeastRecentlyUsed) {
+        GeoCoveringCache cache(2, 1);
+        cache.add("a", makeOil(1, 2));
+        cache.add("b", makeOil(3, 4));
+
+        OrderedIntervalList out("loc");
+        ASSERT_TRUE(cache.get("a", &out));
+
+        cache.add("c", makeOil(5, 6));
+        ASSERT_EQUALS(2U, cache.size());
+        ASSERT_TRUE(cache.get("a", &out));
+        ASSERT_FALSE(cache.get("b", &out));
+        ASSERT_TRUE(cache.get("c", &out));
+
+        cache.clear();
+        ASSERT_EQUALS(0U, cache.size());
+    }
+
+    TEST(GeoCoveringCacheTest, StripesShareMaxSize) {
+        GeoCoveringCache cache(8, 4);
+        for (int i = 0; i < 100; i++) {
+            cache.add(mongoutils::str::stream() << "key" << i, makeOil(i, i + 1));
+        }
+        // Each of the 4 stripes holds at most 2 entries.
+        ASSERT_LESS_THAN_OR_EQUALS(cache.size(), 8U);
+        ASSERT_GREATER_THAN(cache.size(), 0U);
+
+        cache.clear();
+        ASSERT_EQUALS(0U, cache.size());
+    }
+
+    TEST(GeoCoveringCacheTest, GetAfterAddAcrossStripes) {
+        GeoCoveringCache cache(1000);
+        for (int i = 0; i < 50; i++) {
+            cache.add(mongoutils::str::stream() << "key" << i, makeOil(i, i + 1));
+        }
+        ASSERT_EQUALS(50U, cache.size());
+        for (int i = 0; i < 50; i++) {
+            OrderedIntervalList out("loc");
+            ASSERT_TRUE(cache.get(mongoutils::str::stream() << "key" << i, &out));
+            ASSERT_EQUALS(Interval::INTERVAL_EQUALS,
+                          out.intervals[0].compare(makeOil(i, i + 1).intervals[0]));
+        }
+    }
+
+}  // namespace
@@ -33,6 +33,7 @@
 #include "mongo/db/matcher/expression_geo.h"
 #include "mongo/db/query/expression_index.h"
 #include "mongo/db/query/expression_index_knobs.h"
+#include "mongo/db/query/geo_covering_cache.h"
 #include "mongo/db/query/indexability.h"
 #include "mongo/db/query/qlog.h"
 #include "mongo/db/query/query_knobs.h"
@@ -568,6 +569,20 @@ namespace mongo {
 
             const GeoMatchExpression* gme = static_cast<const GeoMatchExpression*>(expr);
 
+            // Covering a complex region is the bulk of planning such a query, and the same
+            // regions tend to be queried over and over.
+            GeoCoveringCache* coveringCache = GeoCoveringCache::getGlobal();
+            string coveringKey;
+            if (NULL != coveringCache) {
+                coveringKey = GeoCoveringCache::makeKey(gme->getRawObj(),
+                                                        index.infoObj,
+                                                        internalGeoPredicateQuery2DMaxCoveringCells);
+                if (coveringCache->get(coveringKey, oilOut)) {
+                    *tightnessOut = IndexBoundsBuilder::INEXACT_FETCH;
+                    return;
+                }
+            }
+
             if (mongoutils::str::equals("2dsphere", elt.valuestrsafe())) {
                 verify(gme->getGeoExpression().getGeometry().hasS2Region());
                 const S2Region& region = gme->getGeoExpression().getGeometry().getS2Region();
@@ -590,6 +605,10 @@ namespace mongo {
                           << " index element.";
                 verify(0);
             }
+
+            if (NULL != coveringCache) {
+                coveringCache->add(coveringKey, *oilOut);
+            }
         }
         else {
             warning() << "Planner error, trying to build bounds for expression: "
@@ -58,6 +58,7 @@
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/net/segmented_buf_builder.h"
 
 namespace mongo {
     // The .h for this in find_constants.h.
@@ -167,15 +168,17 @@ namespace mongo {
      *        when this method returns an empty result, incrementing pass on each call.  
      *        Thus, pass == 0 indicates this is the first "attempt" before any 'awaiting'.
      */
-    QueryResult::View newGetMore(OperationContext* txn,
-                            const char* ns,
-                            int ntoreturn,
-                            long long cursorid,
-                            CurOp& curop,
-                            int pass,
-                            bool& exhaust,
-                            bool* isCursorAuthorized,
-                            bool fromDBDirectClient) {
+    void newGetMore(OperationContext* txn,
+                    const char* ns,
+                    int ntoreturn,
+                    long long cursorid,
+                    CurOp& curop,
+                    int pass,
+                    bool& exhaust,
+                    bool* isCursorAuthorized,
+                    bool fromDBDirectClient,
+                    AwaitDataState* awaitDataState,
+                    Message* result) {
 
         // For testing, we may want to fail if we receive a getmore.
         if (MONGO_FAIL_POINT(failReceivedGetmore)) {
@@ -223,10 +226,9 @@ namespace mongo {
         int numResults = 0;
         int startingResult = 0;
 
-        const int InitialBufSize =
-            512 + sizeof(QueryResult::Value) + MaxBytesToReturnToClientAtOnce;
-
-        BufBuilder bb(InitialBufSize);
+        // Batches can be several megabytes, so they are built in pooled segments which are sent
+        // with a single gathering write, rather than in one buffer that grows by reallocation.
+        SegmentedBufBuilder bb;
         bb.skip(sizeof(QueryResult::Value));
 
         if (NULL == cc) {
@@ -248,8 +250,7 @@ namespace mongo {
                 ruSwapper.reset(new ScopedRecoveryUnitSwapper(cc, txn));
             }
 
-            // Reset timeout timer on the cursor since the cursor is still in use.
-            cc->setIdleTime(0);
+            // The cursor's idle timeout restarts when it is unpinned.
 
             // TODO: fail point?
 
@@ -279,6 +280,21 @@ namespace mongo {
             PlanExecutor* exec = cc->getExecutor();
             const int queryOptions = cc->queryOptions();
 
+            // Note where the collection is before reading it, so that the caller's wait for
+            // inserts can't miss one that commits after we hit EOF.
+            if ((queryOptions & QueryOption_CursorTailable)
+                && (queryOptions & QueryOption_AwaitData)) {
+                boost::shared_ptr<CappedInsertNotifier> notifier =
+                    collection->getCappedInsertNotifier();
+                if (notifier != awaitDataState->notifier) {
+                    awaitDataState->waiter.reset(
+                        notifier ? new CappedInsertNotifier::Waiter(notifier) : NULL);
+                    awaitDataState->notifier = notifier;
+                }
+                if (notifier)
+                    awaitDataState->notifierVersion = notifier->getVersion();
+            }
+
             // Get results out of the executor.
             exec->restoreState(txn);
 
@@ -311,7 +327,7 @@ namespace mongo {
                 // If the cursor is tailable we don't kill it if it's eof.  We let it try to get
                 // data some # of times first.
                 exec->saveState();
-                return 0;
+                return;
             }
 
             // We save the client cursor when there might be more results, and hence we may receive
@@ -389,15 +405,13 @@ namespace mongo {
         }
 
         QueryResult::View qr = bb.buf();
-        qr.msgdata().setLen(bb.len());
         qr.msgdata().setOperation(opReply);
         qr.setResultFlags(resultFlags);
         qr.setCursorId(cursorid);
         qr.setStartingFrom(startingResult);
         qr.setNReturned(numResults);
-        bb.decouple();
+        bb.releaseTo(result);
         QLOG() << "getMore returned " << numResults << " results\n";
-        return qr;
     }
 
     Status getOplogStartHack(OperationContext* txn,
@@ -664,7 +678,7 @@ namespace mongo {
         // bb is used to hold query results
         // this buffer should contain either requested documents per query or
         // explain information, but not both
-        BufBuilder bb(32768);
+        SegmentedBufBuilder bb;
         bb.skip(sizeof(QueryResult::Value));
 
         // How many results have we obtained from the executor?
@@ -845,8 +859,7 @@ namespace mongo {
         }
 
         // Add the results from the query into the output buffer.
-        result.appendData(bb.buf(), bb.len());
-        bb.decouple();
+        bb.releaseTo(&result);
 
         // Fill out the output buffer's header.
         QueryResult::View qr = result.header().view2ptr();
@@ -28,8 +28,11 @@
 
 #pragma once
 
+#include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
 #include <string>
 
+#include "mongo/db/catalog/capped_insert_notifier.h"
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/dbmessage.h"
@@ -55,18 +58,41 @@ namespace mongo {
                              CanonicalQuery* cq,
                              PlanExecutor** execOut);
 
+    /**
+     * What the caller of newGetMore() waits on when a tailable cursor with the AwaitData option
+     * has nothing to return yet.
+     */
+    struct AwaitDataState {
+        AwaitDataState() : notifierVersion(0) {}
+
+        // Set if the cursor's collection is capped.
+        boost::shared_ptr<CappedInsertNotifier> notifier;
+
+        // Registers the getMore with 'notifier' until the getMore returns.
+        boost::scoped_ptr<CappedInsertNotifier::Waiter> waiter;
+
+        // The version of 'notifier' before the getMore looked for results.
+        uint64_t notifierVersion;
+    };
+
     /**
      * Called from the getMore entry point in ops/query.cpp.
+     *
+     * Places the reply in 'result', which must be empty. 'result' is left empty if a tailable
+     * cursor with the AwaitData option has nothing to return yet; '*awaitDataState' then says
+     * what to wait on before trying again.
      */
-    QueryResult::View newGetMore(OperationContext* txn,
-                            const char* ns,
-                            int ntoreturn,
-                            long long cursorid,
-                            CurOp& curop,
-                            int pass,
-                            bool& exhaust,
-                            bool* isCursorAuthorized,
-                            bool fromDBDirectClient);
+    void newGetMore(OperationContext* txn,
+                    const char* ns,
+                    int ntoreturn,
+                    long long cursorid,
+                    CurOp& curop,
+                    int pass,
+                    bool& exhaust,
+                    bool* isCursorAuthorized,
+                    bool fromDBDirectClient,
+                    AwaitDataState* awaitDataState,
+                    Message* result);
 
     /**
      * Run the query 'q' and place the result in 'result'.
@@ -246,6 +246,18 @@ namespace mongo {
             return false;
         }
 
+        /**
+         * Returns true if 'sortObj' sorts only by text score, e.g. {s: {$meta: "textScore"}}.
+         */
+        bool isTextScoreSort(const BSONObj& sortObj) {
+            BSONObjIterator it(sortObj);
+            if (!it.more()) {
+                return false;
+            }
+            BSONElement elt = it.next();
+            return !it.more() && LiteParsedQuery::isTextScoreMeta(elt);
+        }
+
     }  // namespace
 
     // static
@@ -502,6 +514,13 @@ namespace mongo {
                 orn->children.push_back(sortClone);
                 solnRoot = orn;
             }
+
+            // A limited sort on text score directly over a text node only needs the text
+            // node's top results, which it can find without scoring every matching document.
+            if (STAGE_TEXT == sort->children[0]->getType() && isTextScoreSort(sortObj)) {
+                TextNode* textNode = static_cast<TextNode*>(sort->children[0]);
+                textNode->limit = sort->limit;
+            }
         }
         else {
             sort->limit = 0;
@@ -216,7 +216,7 @@ namespace mongo {
     };
 
     struct TextNode : public QuerySolutionNode {
-        TextNode() { }
+        TextNode() : limit(0) { }
         virtual ~TextNode() { }
 
         virtual StageType getType() const { return STAGE_TEXT; }
@@ -241,6 +241,10 @@ namespace mongo {
         // text node while creating the text leaf node and convert them into a BSONObj index prefix
         // when we finish the text leaf node.
         BSONObj indexPrefix;
+
+        // Set when the text node feeds a limited sort on text score, in which case only the
+        // top 'limit' results need to be produced.
+        size_t limit;
     };
 
     struct CollectionScanNode : public QuerySolutionNode {
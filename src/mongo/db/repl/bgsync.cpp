@@ -45,6 +45,7 @@
 #include "mongo/db/repl/rs_rollback.h"
 #include "mongo/db/repl/rs_sync.h"
 #include "mongo/db/repl/rslog.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/stats/timer_stats.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
@@ -61,6 +62,15 @@ namespace {
 
     MONGO_FP_DECLARE(rsBgSyncProduce);
 
+    // Tail the sync source's oplog with an exhaust cursor, so that it pushes batches as they
+    // become available instead of waiting for a getMore round trip per batch.
+    MONGO_EXPORT_SERVER_PARAMETER(replExhaustOplogTailing, bool, true);
+
+    // While streaming, stop reading from the sync source once the buffer holds this percentage
+    // of its maximum size, and resume once it has drained to half of that.  Unread batches back
+    // up on the socket, which throttles the sync source.
+    MONGO_EXPORT_SERVER_PARAMETER(replExhaustBufferHighWaterPercent, int, 50);
+
     BackgroundSync* BackgroundSync::s_instance = 0;
     boost::mutex BackgroundSync::s_mutex;
 
@@ -69,6 +79,11 @@ namespace {
     static ServerStatusMetricField<TimerStats> displayBatchesRecieved(
                                                     "repl.network.getmores",
                                                     &getmoreReplStats );
+    //The number and time spent waiting for the buffer to drain while streaming
+    static TimerStats flowControlReplStats;
+    static ServerStatusMetricField<TimerStats> displayFlowControl(
+                                                    "repl.network.flowControlWaits",
+                                                    &flowControlReplStats );
     //The oplog entries read via the oplog reader
     static Counter64 opsReadStats;
     static ServerStatusMetricField<Counter64> displayOpsRead( "repl.network.ops",
@@ -236,6 +251,14 @@ namespace {
             _syncSourceHost = _syncSourceReader.getHost();
         }
 
+        int tailingQueryOptions = _syncSourceReader.getTailingQueryOptions();
+        if (replExhaustOplogTailing) {
+            tailingQueryOptions |= QueryOption_Exhaust;
+        }
+        else {
+            tailingQueryOptions &= ~QueryOption_Exhaust;
+        }
+        _syncSourceReader.setTailingQueryOptions(tailingQueryOptions);
         _syncSourceReader.tailingQueryGTE(rsoplog, lastOpTimeFetched);
 
         // if target cut connections between connecting and querying (for
@@ -255,8 +278,10 @@ namespace {
                 // (whenever we run out of items in the
                 // current cursor batch)
 
+                // a streaming sync source sends batches whether or not we wait, so the
+                // small-batch pause below would only add latency.
                 int bs = _syncSourceReader.currentBatchMessageSize();
-                if( bs > 0 && bs < BatchIsSmallish ) {
+                if( bs > 0 && bs < BatchIsSmallish && !_syncSourceReader.isStreaming() ) {
                     // on a very low latency network, if we don't wait a little, we'll be 
                     // getting ops to write almost one at a time.  this will both be expensive
                     // for the upstream server as well as potentially defeating our parallel 
@@ -280,6 +305,10 @@ namespace {
                     return;
                 }
 
+                if (_syncSourceReader.isStreaming() && !_waitForBufferToDrain()) {
+                    return;
+                }
+
                 {
                     //record time for each getmore
                     TimerHolder batchTimer(&getmoreReplStats);
@@ -338,6 +367,31 @@ namespace {
         }
     }
 
+    bool BackgroundSync::_waitForBufferToDrain() {
+        const size_t highWater = _buffer.maxSize() / 100 * replExhaustBufferHighWaterPercent;
+        if (_buffer.size() < highWater) {
+            return true;
+        }
+
+        LOG(2) << "replSet bgsync buffer has " << _buffer.size()
+               << " bytes, pausing reads from sync source" << rsLog;
+        TimerHolder flowControlTimer(&flowControlReplStats);
+        // The timeout only bounds how long a shutdown or pause goes unnoticed; every pop by the
+        // applier wakes us.
+        while (!_buffer.waitForSizeAtMost(highWater / 2, 100)) {
+            if (inShutdown()) {
+                return false;
+            }
+            {
+                boost::unique_lock<boost::mutex> lock(_mutex);
+                if (_pause) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
     bool BackgroundSync::shouldChangeSyncSource() {
         // is it even still around?
         if (getSyncTarget().empty() || _syncSourceReader.getHost().empty()) {
@@ -392,6 +446,8 @@ namespace {
 
         if (!r.more()) {
             try {
+                // a streaming cursor may still be live; free the connection for the query.
+                r.resetCursor();
                 BSONObj theirLastOp = r.getLastOp(rsoplog);
                 if (theirLastOp.isEmpty()) {
                     log() << "replSet error empty query result from " << hn << " oplog" << rsLog;
@@ -160,6 +160,9 @@ namespace repl {
         // Checks the criteria for rolling back and executes a rollback if warranted.
         bool _rollbackIfNeeded(OperationContext* txn, OplogReader& r);
 
+        // Blocks while the buffer is above its streaming high-water mark.  Returns false if
+        // syncing should stop instead.
+        bool _waitForBufferToDrain();
         // Evaluate if the current sync target is still good
         bool shouldChangeSyncSource();
         // check lastOpTimeWritten against the remote's earliest op, filling in remoteOldestOp.
@@ -50,6 +50,7 @@
 #include "mongo/db/repl/rslog.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
 
@@ -80,6 +81,7 @@ namespace repl {
         
         /* TODO: slaveOk maybe shouldn't use? */
         _tailingQueryOptions |= QueryOption_AwaitData;
+        _exhaustCursor = false;
 
         readersCreatedStats.increment();
     }
@@ -104,6 +106,21 @@ namespace repl {
         return true;
     }
 
+    void OplogReader::resetCursor() {
+        if (_exhaustCursor && cursor.get() && !cursor->isDead()) {
+            HostAndPort host = _host;
+            LOG(2) << "repl: dropping connection to " << host << " with a live exhaust cursor";
+            resetConnection();
+            uassert(ErrorCodes::HostUnreachable,
+                    str::stream() << "repl: could not reconnect to " << host.toString()
+                                  << " after dropping an exhaust cursor",
+                    connect(host));
+            return;
+        }
+        cursor.reset();
+        _exhaustCursor = false;
+    }
+
     void OplogReader::tailCheck() {
         if( cursor.get() && cursor->isDead() ) {
             log() << "repl: old cursor isDead, will initiate a new one" << std::endl;
@@ -116,15 +133,18 @@ namespace repl {
                             int nToReturn,
                             int nToSkip,
                             const BSONObj* fields) {
+        resetCursor();
         cursor.reset(
             _conn->query(ns, query, nToReturn, nToSkip, fields, QueryOption_SlaveOk).release()
         );
+        _exhaustCursor = false;
     }
 
     void OplogReader::tailingQuery(const char *ns, const BSONObj& query, const BSONObj* fields ) {
         verify( !haveCursor() );
         LOG(2) << "repl: " << ns << ".find(" << query.toString() << ')' << endl;
         cursor.reset( _conn->query( ns, query, 0, 0, fields, _tailingQueryOptions ).release() );
+        _exhaustCursor = haveCursor() && (_tailingQueryOptions & QueryOption_Exhaust);
     }
 
     void OplogReader::tailingQueryGTE(const char *ns, OpTime optime, const BSONObj* fields ) {
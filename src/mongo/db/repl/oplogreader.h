@@ -59,15 +59,28 @@ namespace repl {
         shared_ptr<DBClientCursor> cursor;
         int _tailingQueryOptions;
 
+        // True while 'cursor' was opened with QueryOption_Exhaust and the sync source may still
+        // be pushing batches for it on _conn.
+        bool _exhaustCursor;
+
         // If _conn was actively connected, _host represents the current HostAndPort of the
         // connection.
         HostAndPort _host;
     public:
         OplogReader();
         ~OplogReader() { }
-        void resetCursor() { cursor.reset(); }
+
+        /**
+         * Discards the current cursor.  If it is an exhaust cursor that the sync source is still
+         * streaming, the connection cannot carry any other request until the stream ends, so it
+         * is replaced with a fresh connection to the same host.  Throws a DBException if that
+         * host cannot be reached, leaving the reader without a connection.
+         */
+        void resetCursor();
+
         void resetConnection() {
             cursor.reset();
+            _exhaustCursor = false;
             _conn.reset();
             _host = HostAndPort();
         }
@@ -105,6 +118,12 @@ namespace repl {
             return tailingQueryGTE(ns, t, &fields);
         }
 
+        /**
+         * Returns true if the current cursor is an exhaust cursor, in which case more() waits
+         * for the next batch the sync source pushes instead of sending a getMore.
+         */
+        bool isStreaming() const { return _exhaustCursor; }
+
         bool more() {
             uassert( 15910, "Doesn't have cursor for reading oplog", cursor.get() );
             return cursor->more();
@@ -734,10 +734,9 @@ namespace {
         FixUpInfo how;
         log() << "rollback 1";
         {
-            oplogreader->resetCursor();
-
             log() << "rollback 2 FindCommonPoint";
             try {
+                oplogreader->resetCursor();
                 syncRollbackFindCommonPoint(txn, oplogreader->conn(), how);
             }
             catch (RSFatalException& e) {
@@ -30,17 +30,17 @@
 #pragma once
 
 #include "mongo/pch.h"
+#include "mongo/base/counter.h"
 #include "mongo/db/jsobj.h"
-#include "mongo/platform/atomic_word.h"
 #include "mongo/util/net/message.h"
 #include "mongo/util/processinfo.h"
-#include "mongo/util/concurrency/spin_lock.h"
 
 namespace mongo {
 
     /**
      * for storing operation counters
-     * note: not thread safe.  ok with that for speed
+     * the counters are sharded per thread, so reading them is much more expensive than bumping
+     * them
      */
     class OpCounters {
     public:
@@ -59,24 +59,21 @@ namespace mongo {
         BSONObj getObj() const;
         
         // thse are used by snmp, and other things, do not remove
-        const AtomicUInt32 * getInsert() const { return &_insert; }
-        const AtomicUInt32 * getQuery() const { return &_query; }
-        const AtomicUInt32 * getUpdate() const { return &_update; }
-        const AtomicUInt32 * getDelete() const { return &_delete; }
-        const AtomicUInt32 * getGetMore() const { return &_getmore; }
-        const AtomicUInt32 * getCommand() const { return &_command; }
+        // each call sums the sharded counter, so the value is current but not free to read
+        long long getInsertValue() const { return _insert.get(); }
+        long long getQueryValue() const { return _query.get(); }
+        long long getUpdateValue() const { return _update.get(); }
+        long long getDeleteValue() const { return _delete.get(); }
+        long long getGetMoreValue() const { return _getmore.get(); }
+        long long getCommandValue() const { return _command.get(); }
 
     private:
-        void _checkWrap();
-        
-        // todo: there will be a lot of cache line contention on these.  need to do something 
-        //       else eventually.
-        AtomicUInt32 _insert;
-        AtomicUInt32 _query;
-        AtomicUInt32 _update;
-        AtomicUInt32 _delete;
-        AtomicUInt32 _getmore;
-        AtomicUInt32 _command;
+        ShardedCounter64 _insert;
+        ShardedCounter64 _query;
+        ShardedCounter64 _update;
+        ShardedCounter64 _delete;
+        ShardedCounter64 _getmore;
+        ShardedCounter64 _command;
     };
 
     extern OpCounters globalOpCounters;
@@ -84,17 +81,12 @@ namespace mongo {
 
     class NetworkCounter {
     public:
-        NetworkCounter() : _bytesIn(0), _bytesOut(0), _requests(0), _overflows(0) {}
         void hit( long long bytesIn , long long bytesOut );
         void append( BSONObjBuilder& b );
     private:
-        long long _bytesIn;
-        long long _bytesOut;
-        long long _requests;
-
-        long long _overflows;
-
-        SpinLock _lock;
+        ShardedCounter64 _bytesIn;
+        ShardedCounter64 _bytesOut;
+        ShardedCounter64 _requests;
     };
 
     extern NetworkCounter networkCounter;
@@ -0,0 +1,144 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/operation_latency_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/db/jsobj.h"
+
+namespace mongo {
+
+    namespace {
+        /** Index of the highest set bit of a non-zero value. */
+        int highestBit( uint64_t value ) {
+            int bit = 0;
+            for ( int shift = 32; shift > 0; shift >>= 1 ) {
+                if ( value >> shift ) {
+                    value >>= shift;
+                    bit += shift;
+                }
+            }
+            return bit;
+        }
+    }  // namespace
+
+    const uint64_t OperationLatencyHistogram::kMaxMicros;
+
+    OperationLatencyHistogram::OperationLatencyHistogram()
+        : _count(0), _totalMicros(0), _maxMicros(0) {
+    }
+
+    void OperationLatencyHistogram::_allocateBuckets() {
+        if ( _buckets.empty() )
+            _buckets.resize( kNumBuckets, 0 );
+    }
+
+    int OperationLatencyHistogram::bucketFor( uint64_t micros ) {
+        if ( micros < static_cast<uint64_t>(kSubBuckets) )
+            return static_cast<int>( micros );
+        if ( micros >= kMaxMicros )
+            return kNumBuckets - 1;
+
+        const int exponent = highestBit( micros );
+        const int subBucket = static_cast<int>( micros >> ( exponent - kSubBucketBits ) )
+                              & ( kSubBuckets - 1 );
+        return ( exponent - kSubBucketBits + 1 ) * kSubBuckets + subBucket;
+    }
+
+    uint64_t OperationLatencyHistogram::bucketLowerBound( int bucket ) {
+        if ( bucket < kSubBuckets )
+            return bucket;
+
+        const int exponent = bucket / kSubBuckets + kSubBucketBits - 1;
+        const uint64_t subBucket = bucket % kSubBuckets;
+        return ( kSubBuckets + subBucket ) << ( exponent - kSubBucketBits );
+    }
+
+    void OperationLatencyHistogram::record( uint64_t micros ) {
+        _allocateBuckets();
+        _buckets[bucketFor( micros )]++;
+        _count++;
+        _totalMicros += micros;
+        _maxMicros = std::max( _maxMicros, micros );
+    }
+
+    void OperationLatencyHistogram::add( const OperationLatencyHistogram& other ) {
+        if ( other._count == 0 )
+            return;
+
+        _allocateBuckets();
+        for ( int i = 0; i < kNumBuckets; i++ )
+            _buckets[i] += other._buckets[i];
+        _count += other._count;
+        _totalMicros += other._totalMicros;
+        _maxMicros = std::max( _maxMicros, other._maxMicros );
+    }
+
+    uint64_t OperationLatencyHistogram::percentile( double fraction ) const {
+        if ( _count == 0 )
+            return 0;
+
+        const uint64_t rank = std::max( static_cast<uint64_t>( std::ceil( fraction * _count ) ),
+                                        static_cast<uint64_t>( 1 ) );
+        uint64_t seen = 0;
+        for ( int i = 0; i < kNumBuckets - 1; i++ ) {
+            seen += _buckets[i];
+            if ( seen >= rank )
+                return std::min( bucketLowerBound( i + 1 ) - 1, _maxMicros );
+        }
+        return _maxMicros;
+    }
+
+    void OperationLatencyHistogram::append( bool withBuckets, BSONObjBuilder* builder ) const {
+        builder->append( "ops", static_cast<long long>( _count ) );
+        builder->append( "latency", static_cast<long long>( _totalMicros ) );
+        builder->append( "max", static_cast<long long>( _maxMicros ) );
+        builder->append( "p50", static_cast<long long>( percentile( 0.5 ) ) );
+        builder->append( "p99", static_cast<long long>( percentile( 0.99 ) ) );
+        builder->append( "p999", static_cast<long long>( percentile( 0.999 ) ) );
+
+        if ( !withBuckets )
+            return;
+
+        BSONArrayBuilder histogram( builder->subarrayStart( "histogram" ) );
+        for ( int i = 0; i < static_cast<int>( _buckets.size() ); i++ ) {
+            if ( _buckets[i] == 0 )
+                continue;
+            BSONObjBuilder bucket( histogram.subobjStart() );
+            bucket.append( "micros", static_cast<long long>( bucketLowerBound( i ) ) );
+            bucket.append( "count", static_cast<long long>( _buckets[i] ) );
+            bucket.doneFast();
+        }
+        histogram.doneFast();
+    }
+
+}  // namespace mongo
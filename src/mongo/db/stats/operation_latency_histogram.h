@@ -0,0 +1,102 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "mongo/platform/cstdint.h"
+
+namespace mongo {
+
+    class BSONObjBuilder;
+
+    /**
+     * A log-linear histogram of operation latencies in microseconds.
+     *
+     * Latencies below kSubBuckets get a bucket each.  Above that, every power of two is split into
+     * kSubBuckets equal buckets, so a bucket's width is at most 1/kSubBuckets of its lower bound
+     * and percentiles are reported to within that relative error.  Latencies of kMaxMicros or more
+     * share the last bucket.
+     *
+     * The buckets are only allocated once something is recorded, so that the histograms Top
+     * keeps for each collection and operation type cost little while unused.
+     *
+     * Not thread safe; Top keeps one per thread and merges them with add().
+     */
+    class OperationLatencyHistogram {
+    public:
+        enum {
+            kSubBucketBits = 3,
+            kSubBuckets = 1 << kSubBucketBits,
+            kMaxExponent = 40,
+            kNumBuckets = (kMaxExponent - kSubBucketBits + 1) * kSubBuckets
+        };
+
+        static const uint64_t kMaxMicros = 1ULL << kMaxExponent;
+
+        OperationLatencyHistogram();
+
+        void record( uint64_t micros );
+
+        /** Adds the operations recorded in 'other' to this histogram. */
+        void add( const OperationLatencyHistogram& other );
+
+        uint64_t count() const { return _count; }
+
+        uint64_t totalMicros() const { return _totalMicros; }
+
+        uint64_t maxMicros() const { return _maxMicros; }
+
+        /**
+         * The smallest bucket upper bound that at least 'fraction' of the recorded operations fall
+         * under, capped at the largest latency seen.  Returns 0 if nothing has been recorded.
+         */
+        uint64_t percentile( double fraction ) const;
+
+        /**
+         * Appends ops, latency (the total), max and percentiles to 'builder'.  If 'withBuckets'
+         * is set, also appends a "histogram" array of the non-empty buckets.
+         */
+        void append( bool withBuckets, BSONObjBuilder* builder ) const;
+
+        static int bucketFor( uint64_t micros );
+
+        static uint64_t bucketLowerBound( int bucket );
+
+    private:
+        void _allocateBuckets();
+
+        // empty until the first operation is recorded, then kNumBuckets long
+        std::vector<uint64_t> _buckets;
+        uint64_t _count;
+        uint64_t _totalMicros;
+        uint64_t _maxMicros;
+    };
+
+}  // namespace mongo
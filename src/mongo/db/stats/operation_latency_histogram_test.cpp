@@ -0,0 +1,154 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/operation_latency_histogram.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+    typedef OperationLatencyHistogram Histogram;
+
+    TEST(OperationLatencyHistogram, BucketBounds) {
+        for (uint64_t micros = 0; micros < 100000; micros++) {
+            int bucket = Histogram::bucketFor(micros);
+            ASSERT_LESS_THAN_OR_EQUALS(Histogram::bucketLowerBound(bucket), micros);
+            ASSERT_GREATER_THAN(Histogram::bucketLowerBound(bucket + 1), micros);
+        }
+        for (int bucket = 0; bucket < Histogram::kNumBuckets; bucket++) {
+            ASSERT_EQUALS(bucket, Histogram::bucketFor(Histogram::bucketLowerBound(bucket)));
+        }
+        ASSERT_EQUALS(Histogram::kNumBuckets - 1, Histogram::bucketFor(Histogram::kMaxMicros));
+        ASSERT_EQUALS(Histogram::kNumBuckets - 1, Histogram::bucketFor(~0ULL));
+    }
+
+    TEST(OperationLatencyHistogram, BucketWidthIsRelative) {
+        for (int bucket = Histogram::kSubBuckets; bucket < Histogram::kNumBuckets - 1; bucket++) {
+            uint64_t lower = Histogram::bucketLowerBound(bucket);
+            uint64_t width = Histogram::bucketLowerBound(bucket + 1) - lower;
+            ASSERT_LESS_THAN_OR_EQUALS(width * Histogram::kSubBuckets, lower);
+        }
+    }
+
+    TEST(OperationLatencyHistogram, Empty) {
+        Histogram histogram;
+        ASSERT_EQUALS(0U, histogram.count());
+        ASSERT_EQUALS(0U, histogram.percentile(0.5));
+
+        Histogram other;
+        histogram.add(other);
+        ASSERT_EQUALS(0U, histogram.count());
+
+        BSONObjBuilder builder;
+        histogram.append(true, &builder);
+        BSONObj obj = builder.obj();
+        ASSERT_EQUALS(0, obj["ops"].numberLong());
+        ASSERT_EQUALS(0U, obj["histogram"].Array().size());
+
+        // Adding into an empty histogram allocates its buckets.
+        other.record(42);
+        histogram.add(other);
+        ASSERT_EQUALS(1U, histogram.count());
+        ASSERT_EQUALS(42U, histogram.percentile(0.5));
+    }
+
+    TEST(OperationLatencyHistogram, Percentiles) {
+        Histogram histogram;
+        for (uint64_t micros = 1; micros <= 1000; micros++) {
+            histogram.record(micros);
+        }
+        ASSERT_EQUALS(1000U, histogram.count());
+        ASSERT_EQUALS(500500U, histogram.totalMicros());
+        ASSERT_EQUALS(1000U, histogram.maxMicros());
+
+        // Each percentile is reported to within the width of its bucket.
+        uint64_t p50 = histogram.percentile(0.5);
+        ASSERT_GREATER_THAN_OR_EQUALS(p50, 500U);
+        ASSERT_LESS_THAN(p50, 500U + 500U / Histogram::kSubBuckets);
+        uint64_t p99 = histogram.percentile(0.99);
+        ASSERT_GREATER_THAN_OR_EQUALS(p99, 990U);
+        ASSERT_LESS_THAN_OR_EQUALS(p99, 1000U);
+        ASSERT_EQUALS(1000U, histogram.percentile(1.0));
+        ASSERT_EQUALS(1U, histogram.percentile(0.0));
+    }
+
+    TEST(OperationLatencyHistogram, PercentileIsCappedAtMax) {
+        Histogram histogram;
+        histogram.record(1025);
+        ASSERT_EQUALS(1025U, histogram.percentile(0.5));
+        histogram.record(Histogram::kMaxMicros * 2);
+        ASSERT_EQUALS(Histogram::kMaxMicros * 2, histogram.percentile(1.0));
+    }
+
+    TEST(OperationLatencyHistogram, Add) {
+        Histogram a;
+        Histogram b;
+        Histogram both;
+        for (uint64_t micros = 0; micros < 5000; micros += 7) {
+            (micros % 2 ? a : b).record(micros);
+            both.record(micros);
+        }
+        a.add(b);
+        ASSERT_EQUALS(both.count(), a.count());
+        ASSERT_EQUALS(both.totalMicros(), a.totalMicros());
+        ASSERT_EQUALS(both.maxMicros(), a.maxMicros());
+        ASSERT_EQUALS(both.percentile(0.5), a.percentile(0.5));
+        ASSERT_EQUALS(both.percentile(0.999), a.percentile(0.999));
+    }
+
+    TEST(OperationLatencyHistogram, Append) {
+        Histogram histogram;
+        histogram.record(3);
+        histogram.record(3);
+        histogram.record(100);
+
+        BSONObjBuilder builder;
+        histogram.append(true, &builder);
+        BSONObj obj = builder.obj();
+        ASSERT_EQUALS(3, obj["ops"].numberLong());
+        ASSERT_EQUALS(106, obj["latency"].numberLong());
+        ASSERT_EQUALS(100, obj["max"].numberLong());
+        ASSERT_EQUALS(3, obj["p50"].numberLong());
+
+        std::vector<BSONElement> buckets = obj["histogram"].Array();
+        ASSERT_EQUALS(2U, buckets.size());
+        ASSERT_EQUALS(3, buckets[0]["micros"].numberLong());
+        ASSERT_EQUALS(2, buckets[0]["count"].numberLong());
+        ASSERT_EQUALS(1, buckets[1]["count"].numberLong());
+
+        BSONObjBuilder summary;
+        histogram.append(false, &summary);
+        ASSERT_FALSE(summary.obj().hasField("histogram"));
+    }
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,139 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/operation_resources.h"
+
+#include <algorithm>
+
+#include "mongo/db/concurrency/locker.h"
+#include "mongo/db/jsobj.h"
+
+namespace mongo {
+
+    ResourceTotals::ResourceTotals() : cpuMicros(0), docBytesRead(0), docBytesWritten(0) {
+        for ( int i = 0; i < RESOURCE_LAST; i++ )
+            lockWaitMicros[i] = 0;
+    }
+
+    void ResourceTotals::add( const ResourceTotals& other ) {
+        cpuMicros += other.cpuMicros;
+        docBytesRead += other.docBytesRead;
+        docBytesWritten += other.docBytesWritten;
+        for ( int i = 0; i < RESOURCE_LAST; i++ )
+            lockWaitMicros[i] += other.lockWaitMicros[i];
+    }
+
+    void ResourceTotals::append( BSONObjBuilder* builder ) const {
+        if ( ThreadCpuTimer::isSupported() )
+            builder->appendNumber( "cpuMicros", cpuMicros );
+        builder->appendNumber( "docBytesRead", docBytesRead );
+        builder->appendNumber( "docBytesWritten", docBytesWritten );
+
+        BSONObjBuilder waits( builder->subobjStart( "lockWaitMicros" ) );
+        for ( int i = 0; i < RESOURCE_LAST; i++ ) {
+            if ( lockWaitMicros[i] )
+                waits.appendNumber( resourceTypeName( static_cast<ResourceType>( i ) ),
+                                    lockWaitMicros[i] );
+        }
+        waits.done();
+    }
+
+    OperationResources::OperationResources() {
+        reset();
+    }
+
+    void OperationResources::reset() {
+        _cpuTimer.reset();
+        _docBytesRead.store( 0 );
+        _docBytesWritten.store( 0 );
+        for ( int i = 0; i < RESOURCE_LAST; i++ ) {
+            _lockWaitMicros[i].store( 0 );
+            _lockWaitMicrosAtStart[i] = 0;
+        }
+        _nested = ResourceTotals();
+    }
+
+    void OperationResources::addNested( const OperationResources& nested ) {
+        _nested.add( nested.totals() );
+        _inc( &_docBytesRead, nested._docBytesRead.load() );
+        _inc( &_docBytesWritten, nested._docBytesWritten.load() );
+    }
+
+    void OperationResources::startLockWaits( const Locker& locker ) {
+        for ( int i = 0; i < RESOURCE_LAST; i++ )
+            _lockWaitMicrosAtStart[i] = locker.getLockWaitMicros( static_cast<ResourceType>( i ) );
+    }
+
+    void OperationResources::finishLockWaits( const Locker& locker ) {
+        for ( int i = 0; i < RESOURCE_LAST; i++ ) {
+            const long long total = locker.getLockWaitMicros( static_cast<ResourceType>( i ) );
+            _lockWaitMicros[i].store( total - _lockWaitMicrosAtStart[i] );
+        }
+    }
+
+    ResourceTotals OperationResources::totals() const {
+        ResourceTotals t;
+        t.cpuMicros = std::max( 0LL, _cpuTimer.micros() );
+        t.docBytesRead = _docBytesRead.load();
+        t.docBytesWritten = _docBytesWritten.load();
+        for ( int i = 0; i < RESOURCE_LAST; i++ )
+            t.lockWaitMicros[i] = _lockWaitMicros[i].load();
+        return t;
+    }
+
+    ResourceTotals OperationResources::ownTotals() const {
+        ResourceTotals t = totals();
+        t.cpuMicros = std::max( 0LL, t.cpuMicros - _nested.cpuMicros );
+        t.docBytesRead -= _nested.docBytesRead;
+        t.docBytesWritten -= _nested.docBytesWritten;
+        for ( int i = 0; i < RESOURCE_LAST; i++ )
+            t.lockWaitMicros[i] = std::max( 0LL, t.lockWaitMicros[i] - _nested.lockWaitMicros[i] );
+        return t;
+    }
+
+    void OperationResources::report( StringBuilder& builder ) const {
+        const ResourceTotals t = totals();
+        if ( ThreadCpuTimer::isSupported() )
+            builder << "cpuMicros:" << t.cpuMicros << ' ';
+        builder << "docBytesRead:" << t.docBytesRead << " docBytesWritten:" << t.docBytesWritten;
+
+        bool anyWaits = false;
+        for ( int i = 0; i < RESOURCE_LAST; i++ ) {
+            if ( !t.lockWaitMicros[i] )
+                continue;
+            if ( !anyWaits )
+                builder << " lockWait(micros)";
+            anyWaits = true;
+            builder << ' ' << resourceTypeName( static_cast<ResourceType>( i ) )
+                    << ':' << t.lockWaitMicros[i];
+        }
+    }
+
+}  // namespace mongo
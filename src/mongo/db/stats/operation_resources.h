@@ -0,0 +1,124 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/util/builder.h"
+#include "mongo/db/concurrency/resource_id.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/thread_cpu_timer.h"
+
+namespace mongo {
+
+    class BSONObjBuilder;
+    class Locker;
+
+    /**
+     * Resources used by one or more operations: CPU time, bytes of documents read and written,
+     * and time spent waiting for locks, by the type of the resource locked.
+     *
+     * Document bytes are the BSON sizes of the documents fetched, inserted and updated through
+     * Collection, which every query, update, delete and insert goes through.  They are not bytes
+     * moved to or from storage, and records read straight from a RecordStore (by dataSize,
+     * validate, or storage engine internals) are not counted.
+     */
+    struct ResourceTotals {
+        ResourceTotals();
+
+        long long cpuMicros;
+        long long docBytesRead;
+        long long docBytesWritten;
+        long long lockWaitMicros[RESOURCE_LAST];
+
+        void add( const ResourceTotals& other );
+
+        /** appends the totals as fields of 'builder'; lock waits only for types waited on */
+        void append( BSONObjBuilder* builder ) const;
+    };
+
+    /**
+     * The resources used by the operation a CurOp describes.
+     *
+     * Only the operation's own thread records usage, but currentOp reads it from other threads,
+     * so the counts are atomic.  They are updated with plain loads and stores, since there is
+     * only one writer.
+     */
+    class OperationResources {
+        MONGO_DISALLOW_COPYING(OperationResources);
+    public:
+        OperationResources();
+
+        /** forgets all usage, and starts measuring the CPU time of the calling thread */
+        void reset();
+
+        void recordDocBytesRead( long long bytes ) { _inc( &_docBytesRead, bytes ); }
+        void recordDocBytesWritten( long long bytes ) { _inc( &_docBytesWritten, bytes ); }
+
+        /**
+         * Lock waits are counted by the operation's Locker, and read from it when the operation
+         * finishes: startLockWaits() notes the locker's totals as the operation starts, and
+         * finishLockWaits() records how much they have grown since.
+         */
+        void startLockWaits( const Locker& locker );
+        void finishLockWaits( const Locker& locker );
+
+        /**
+         * Adds in the usage of a nested operation that ran on this thread.  Its CPU time, and
+         * the lock waits of its locker, which it shares with us, are already part of ours.
+         */
+        void addNested( const OperationResources& nested );
+
+        /** the usage of this operation, including that of the nested operations it ran */
+        ResourceTotals totals() const;
+
+        /**
+         * The usage of this operation less that of its nested operations.  Nested operations
+         * record their own usage in Top, so this is what the operation itself adds there.
+         */
+        ResourceTotals ownTotals() const;
+
+        /** for the slow operation log */
+        void report( StringBuilder& builder ) const;
+
+    private:
+        static void _inc( AtomicInt64* counter, long long n ) {
+            counter->store( counter->load() + n );
+        }
+
+        ThreadCpuTimer _cpuTimer;
+        AtomicInt64 _docBytesRead;
+        AtomicInt64 _docBytesWritten;
+        AtomicInt64 _lockWaitMicros[RESOURCE_LAST];
+        long long _lockWaitMicrosAtStart[RESOURCE_LAST];
+
+        // what addNested() added, CPU time included; only read by the operation's own thread
+        ResourceTotals _nested;
+    };
+
+}  // namespace mongo
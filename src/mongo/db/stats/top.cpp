@@ -39,13 +39,20 @@
 #include "mongo/util/log.h"
 #include "mongo/util/net/message.h"
 #include "mongo/db/commands.h"
+#include "mongo/db/commands/server_status.h"
 
 namespace mongo {
 
-    Top::UsageData::UsageData( const UsageData& older , const UsageData& newer ) {
+    namespace {
         // this won't be 100% accurate on rollovers and drop(), but at least it won't be negative
-        time  = (newer.time  >= older.time)  ? (newer.time  - older.time)  : newer.time;
-        count = (newer.count >= older.count) ? (newer.count - older.count) : newer.count;
+        long long diffTotal( long long older , long long newer ) {
+            return newer >= older ? newer - older : newer;
+        }
+    }
+
+    Top::UsageData::UsageData( const UsageData& older , const UsageData& newer ) {
+        time  = diffTotal( older.time , newer.time );
+        count = diffTotal( older.count , newer.count );
     }
 
     Top::CollectionData::CollectionData( const CollectionData& older , const CollectionData& newer )
@@ -57,25 +64,147 @@ namespace mongo {
           insert( older.insert , newer.insert ) ,
           update( older.update , newer.update ) ,
           remove( older.remove , newer.remove ),
-          commands( older.commands , newer.commands ) {
+          commands( older.commands , newer.commands ),
+          resources( newer.resources ) {
+
+        const ResourceTotals& o = older.resources;
+        resources.cpuMicros = diffTotal( o.cpuMicros , resources.cpuMicros );
+        resources.docBytesRead = diffTotal( o.docBytesRead , resources.docBytesRead );
+        resources.docBytesWritten = diffTotal( o.docBytesWritten , resources.docBytesWritten );
+        for ( int i = 0; i < RESOURCE_LAST; i++ )
+            resources.lockWaitMicros[i] = diffTotal( o.lockWaitMicros[i] ,
+                                                     resources.lockWaitMicros[i] );
+    }
 
+    void Top::CollectionData::add( const CollectionData& other ) {
+        total.add( other.total );
+        readLock.add( other.readLock );
+        writeLock.add( other.writeLock );
+        queries.add( other.queries );
+        getmore.add( other.getmore );
+        insert.add( other.insert );
+        update.add( other.update );
+        remove.add( other.remove );
+        commands.add( other.commands );
+        resources.add( other.resources );
     }
 
+    Top::Top() : _lock("Top"), _threadUsage( &Top::_threadExited ) { }
+
     void Top::record( const StringData& ns , int op , int lockType , long long micros , bool command ) {
         if ( ns[0] == '?' )
             return;
 
         //cout << "record: " << ns << "\t" << op << "\t" << command << endl;
-        SimpleMutex::scoped_lock lk(_lock);
+        ThreadUsage* usage = _getThreadUsage();
+        {
+            SimpleMutex::scoped_lock lk( usage->lock );
+
+            if ( ( command || op == dbQuery ) && ns == usage->lastDropped ) {
+                usage->lastDropped = "";
+                return;
+            }
+
+            CollectionData& coll = usage->usage[ns];
+            _record( coll , op , lockType , micros , command );
+            _record( usage->global , op , lockType , micros , command );
+
+            LatencyType type = _latencyType( op , command );
+            if ( type == kNumLatencyTypes )
+                return;
 
-        if ( ( command || op == dbQuery ) && ns == _lastDropped ) {
-            _lastDropped = "";
+            usage->latencies[ns].micros[type].push_back( micros );
+            if ( ++usage->numLatencies < kMaxPendingLatencies )
+                return;
+        }
+
+        // Nobody has read top for a while; don't let this thread's latencies pile up.
+        SimpleMutex::scoped_lock lk( _lock );
+        _mergeThreadUsage_inlock( usage );
+    }
+
+    void Top::recordResources( const StringData& ns , const ResourceTotals& totals ) {
+        if ( ns.empty() || ns[0] == '?' )
             return;
+
+        ThreadUsage* usage = _getThreadUsage();
+        SimpleMutex::scoped_lock lk( usage->lock );
+        usage->usage[ns].resources.add( totals );
+        usage->global.resources.add( totals );
+    }
+
+    Top::LatencyType Top::_latencyType( int op , bool command ) {
+        switch ( op ) {
+        case dbQuery:
+            return command ? kCommands : kReads;
+        case dbGetMore:
+            return kGetMores;
+        case dbInsert:
+        case dbUpdate:
+        case dbDelete:
+            return kWrites;
+        default:
+            return kNumLatencyTypes;
+        }
+    }
+
+    Top::ThreadUsage* Top::_getThreadUsage() {
+        ThreadUsage* usage = _threadUsage.get();
+        if ( usage )
+            return usage;
+
+        usage = new ThreadUsage( this );
+        {
+            SimpleMutex::scoped_lock lk( _lock );
+            _threads.insert( usage );
         }
+        _threadUsage.reset( usage );
+        return usage;
+    }
 
-        CollectionData& coll = _usage[ns];
-        _record( coll , op , lockType , micros , command );
-        _record( _global , op , lockType , micros , command );
+    void Top::_mergeThreadUsage_inlock() const {
+        for ( std::set<ThreadUsage*>::const_iterator it = _threads.begin();
+              it != _threads.end();
+              ++it ) {
+            _mergeThreadUsage_inlock( *it );
+        }
+    }
+
+    void Top::_mergeThreadUsage_inlock( ThreadUsage* usage ) const {
+        SimpleMutex::scoped_lock lk( usage->lock );
+
+        for ( UsageMap::const_iterator i = usage->usage.begin(); i != usage->usage.end(); ++i ) {
+            _usage[i->first].add( i->second );
+        }
+        _global.add( usage->global );
+
+        for ( StringMap<PendingLatencies>::const_iterator i = usage->latencies.begin();
+              i != usage->latencies.end();
+              ++i ) {
+            LatencyData& coll = _latency[i->first];
+            for ( int type = 0; type < kNumLatencyTypes; type++ ) {
+                const std::vector<long long>& micros = i->second.micros[type];
+                for ( size_t j = 0; j < micros.size(); j++ ) {
+                    coll.histograms[type].record( micros[j] );
+                    _globalLatency.histograms[type].record( micros[j] );
+                }
+            }
+        }
+
+        usage->usage = UsageMap();
+        usage->global = CollectionData();
+        usage->latencies = StringMap<PendingLatencies>();
+        usage->numLatencies = 0;
+    }
+
+    void Top::_threadExited( ThreadUsage* usage ) {
+        Top* top = usage->top;
+        {
+            SimpleMutex::scoped_lock lk( top->_lock );
+            top->_mergeThreadUsage_inlock( usage );
+            top->_threads.erase( usage );
+        }
+        delete usage;
     }
 
     void Top::_record( CollectionData& c , int op , int lockType , long long micros , bool command ) {
@@ -121,18 +250,78 @@ namespace mongo {
     }
 
     void Top::collectionDropped( const StringData& ns ) {
+        ThreadUsage* usage = _getThreadUsage();
+
         SimpleMutex::scoped_lock lk(_lock);
+        _mergeThreadUsage_inlock();
         _usage.erase(ns);
-        _lastDropped = ns.toString();
+        _latency.erase(ns);
+
+        SimpleMutex::scoped_lock threadLock( usage->lock );
+        usage->lastDropped = ns.toString();
     }
 
     void Top::cloneMap(Top::UsageMap& out) const {
         SimpleMutex::scoped_lock lk(_lock);
+        _mergeThreadUsage_inlock();
         out = _usage;
     }
 
+    Top::CollectionData Top::getGlobalData() const {
+        SimpleMutex::scoped_lock lk(_lock);
+        _mergeThreadUsage_inlock();
+        return _global;
+    }
+
+    Top::LatencyData Top::getGlobalLatencyData() const {
+        SimpleMutex::scoped_lock lk(_lock);
+        _mergeThreadUsage_inlock();
+        return _globalLatency;
+    }
+
+    void Top::appendLatencyStats( bool byNamespace , bool withBuckets , BSONObjBuilder* builder ) const {
+        SimpleMutex::scoped_lock lk( _lock );
+        _mergeThreadUsage_inlock();
+
+        {
+            BSONObjBuilder global( builder->subobjStart( "global" ) );
+            _globalLatency.append( withBuckets , &global );
+            global.doneFast();
+        }
+
+        if ( !byNamespace )
+            return;
+
+        vector<string> names;
+        for ( LatencyMap::const_iterator i = _latency.begin(); i != _latency.end(); ++i ) {
+            names.push_back( i->first );
+        }
+        std::sort( names.begin(), names.end() );
+
+        BSONObjBuilder namespaces( builder->subobjStart( "namespaces" ) );
+        for ( size_t i = 0; i < names.size(); i++ ) {
+            BSONObjBuilder coll( namespaces.subobjStart( names[i] ) );
+            _latency.find( names[i] )->second.append( withBuckets , &coll );
+            coll.doneFast();
+        }
+        namespaces.doneFast();
+    }
+
+    void Top::LatencyData::append( bool withBuckets , BSONObjBuilder* builder ) const {
+        static const char* const names[kNumLatencyTypes] = {
+            "reads", "writes", "commands", "getMores"
+        };
+
+        for ( int type = 0; type < kNumLatencyTypes; type++ ) {
+            BSONObjBuilder bb( builder->subobjStart( names[type] ) );
+            histograms[type].append( withBuckets , &bb );
+            bb.doneFast();
+        }
+    }
+
     void Top::append( BSONObjBuilder& b ) {
         SimpleMutex::scoped_lock lk( _lock );
+        _mergeThreadUsage_inlock();
         _appendToUsageMap( b , _usage );
     }
 
@@ -163,6 +352,10 @@ namespace mongo {
             _appendStatsEntry( b , "remove" , coll.remove );
             _appendStatsEntry( b , "commands" , coll.commands );
 
+            BSONObjBuilder resources( b.subobjStart( "resources" ) );
+            coll.resources.append( &resources );
+            resources.done();
+
             bb.done();
         }
     }
@@ -201,6 +394,47 @@ namespace mongo {
 
     } topCmd;
 
+    class LatencyStatsCmd : public Command {
+    public:
+        LatencyStatsCmd() : Command( "latencyStats" ) {}
+
+        virtual bool slaveOk() const { return true; }
+        virtual bool adminOnly() const { return true; }
+        virtual bool isWriteCommandForConfigServer() const { return false; }
+        virtual void help( stringstream& help ) const {
+            help << "latency histograms of reads, writes, commands and getMores, in micros\n"
+                 << "{ latencyStats : 1 , namespaces : <bool> , histograms : <bool> }";
+        }
+        virtual void addRequiredPrivileges(const std::string& dbname,
+                                           const BSONObj& cmdObj,
+                                           std::vector<Privilege>* out) {
+            ActionSet actions;
+            actions.addAction(ActionType::top);
+            out->push_back(Privilege(ResourcePattern::forClusterResource(), actions));
+        }
+        virtual bool run(OperationContext* txn, const string& , BSONObj& cmdObj, int, string& errmsg, BSONObjBuilder& result, bool fromRepl) {
+            bool byNamespace = cmdObj["namespaces"].trueValue();
+            bool withBuckets = cmdObj["histograms"].trueValue();
+            result.append( "note" , "all times in microseconds" );
+            Top::global.appendLatencyStats( byNamespace , withBuckets , &result );
+            return true;
+        }
+
+    } latencyStatsCmd;
+
+    class OpLatenciesServerStatusSection : public ServerStatusSection {
+    public:
+        OpLatenciesServerStatusSection() : ServerStatusSection( "opLatencies" ) {}
+        virtual bool includeByDefault() const { return true; }
+
+        BSONObj generateSection(const BSONElement& configElement) const {
+            BSONObjBuilder b;
+            Top::global.getGlobalLatencyData().append( false , &b );
+            return b.obj();
+        }
+
+    } opLatenciesServerStatusSection;
+
     Top Top::global;
 
 }
@@ -30,19 +30,27 @@
 #pragma once
 
 #include <boost/date_time/posix_time/posix_time.hpp>
+#include <set>
+#include <vector>
 
+#include "mongo/db/stats/operation_latency_histogram.h"
+#include "mongo/db/stats/operation_resources.h"
 #include "mongo/util/concurrency/mutex.h"
+#include "mongo/util/concurrency/threadlocal.h"
 #include "mongo/util/string_map.h"
 
 namespace mongo {
 
     /**
-     * tracks usage by collection
+     * tracks usage and latency histograms by collection
+     *
+     * Each thread records into its own buffer, which is merged into the shared totals whenever
+     * they are read, so recording an operation does not contend with other threads.
      */
     class Top {
 
     public:
-        Top() : _lock("Top") { }
+        Top();
 
         struct UsageData {
             UsageData() : time(0) , count(0) {}
@@ -54,6 +62,11 @@ namespace mongo {
                 count++;
                 time += micros;
             }
+
+            void add( const UsageData& other ) {
+                count += other.count;
+                time += other.time;
+            }
         };
 
         struct CollectionData {
@@ -74,29 +87,106 @@ namespace mongo {
             UsageData update;
             UsageData remove;
             UsageData commands;
+
+            ResourceTotals resources;
+
+            void add( const CollectionData& other );
         };
 
         typedef StringMap<CollectionData> UsageMap;
 
+        enum LatencyType {
+            kReads,
+            kWrites,
+            kCommands,
+            kGetMores,
+            kNumLatencyTypes
+        };
+
+        struct LatencyData {
+            OperationLatencyHistogram histograms[kNumLatencyTypes];
+
+            void append( bool withBuckets , BSONObjBuilder* builder ) const;
+        };
+
     public:
         void record( const StringData& ns , int op , int lockType , long long micros , bool command );
+
+        /** adds the resources an operation on 'ns' used to the collection's totals */
+        void recordResources( const StringData& ns , const ResourceTotals& totals );
         void append( BSONObjBuilder& b );
         void cloneMap(UsageMap& out) const;
-        CollectionData getGlobalData() const { return _global; }
+        CollectionData getGlobalData() const;
         void collectionDropped( const StringData& ns );
 
+        /**
+         * Appends the latency histograms of all operations as "global" and, if 'byNamespace' is
+         * set, those of each collection under "namespaces".  Each histogram's non-empty buckets
+         * are listed only if 'withBuckets' is set.
+         */
+        void appendLatencyStats( bool byNamespace , bool withBuckets , BSONObjBuilder* builder ) const;
+
+        /** the latency histograms of all operations, by type */
+        LatencyData getGlobalLatencyData() const;
+
     public: // static stuff
         static Top global;
 
     private:
+        typedef StringMap<LatencyData> LatencyMap;
+
+        /**
+         * A thread's unmerged latencies for one collection, by LatencyType.  They are kept raw
+         * rather than as histograms so that an idle thread's buffer stays small.
+         */
+        struct PendingLatencies {
+            std::vector<long long> micros[kNumLatencyTypes];
+        };
+
+        /**
+         * Usage recorded by one thread since it was last merged into _usage.  Only the owning
+         * thread and a merging reader ever take its lock.
+         */
+        struct ThreadUsage {
+            ThreadUsage( Top* t ) : top( t ), lock( "Top::ThreadUsage" ), numLatencies( 0 ) {}
+
+            Top* const top;
+            SimpleMutex lock;
+            CollectionData global;
+            UsageMap usage;
+            StringMap<PendingLatencies> latencies;
+            size_t numLatencies;
+
+            // the namespace this thread last dropped, so that the drop itself is not recorded
+            std::string lastDropped;
+        };
+
+        ThreadUsage* _getThreadUsage();
+
+        /** merges every thread's buffered usage into _usage and _global; _lock must be held */
+        void _mergeThreadUsage_inlock() const;
+        void _mergeThreadUsage_inlock( ThreadUsage* usage ) const;
+
+        /** a thread merges its own buffer once it holds this many latencies */
+        static const size_t kMaxPendingLatencies = 4096;
+
+        /** the LatencyType of an operation, or kNumLatencyTypes if its latency is not tracked */
+        static LatencyType _latencyType( int op , bool command );
+
+        /** merges and forgets the buffer of a thread that is exiting */
+        static void _threadExited( ThreadUsage* usage );
+
         void _appendToUsageMap( BSONObjBuilder& b , const UsageMap& map ) const;
         void _appendStatsEntry( BSONObjBuilder& b , const char * statsName , const UsageData& map ) const;
         void _record( CollectionData& c , int op , int lockType , long long micros , bool command );
 
         mutable SimpleMutex _lock;
-        CollectionData _global;
-        UsageMap _usage;
-        std::string _lastDropped;
+        mutable CollectionData _global;
+        mutable UsageMap _usage;
+        mutable LatencyData _globalLatency;
+        mutable LatencyMap _latency;
+        std::set<ThreadUsage*> _threads;
+        thread_specific_ptr<ThreadUsage> _threadUsage;
     };
 
 } // namespace mongo
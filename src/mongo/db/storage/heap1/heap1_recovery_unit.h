@@ -55,7 +55,10 @@ namespace mongo {
             return true;
         }
 
+        // Changes can't be rolled back here, so commit them straight away.
         virtual void registerChange(Change* change) {
+            change->commit();
+            delete change;
         }
 
         virtual void* writingPtr(void* data, size_t len) {
@@ -207,17 +207,7 @@ namespace mongo {
                                                const char* damangeSource,
                                                const mutablebson::DamageVector& damages ) {
         HeapRecord* rec = recordFor( loc );
-        char* root = rec->data();
-
-        // All updates were in place. Apply them via durability and writing pointer.
-        mutablebson::DamageVector::const_iterator where = damages.begin();
-        const mutablebson::DamageVector::const_iterator end = damages.end();
-        for( ; where != end; ++where ) {
-            const char* sourcePtr = damangeSource + where->sourceOffset;
-            char* targetPtr = root + where->targetOffset;
-            std::memcpy(targetPtr, sourcePtr, where->size);
-        }
-
+        mutablebson::applyDamages( rec->data(), damangeSource, damages );
         return Status::OK();
     }
 
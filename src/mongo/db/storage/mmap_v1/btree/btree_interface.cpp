@@ -114,6 +114,19 @@ namespace mongo {
             return _btree->touch(txn);
         }
 
+        virtual bool sampleKeys(OperationContext* txn,
+                                const BSONObj& start,
+                                const BSONObj& end,
+                                std::vector<BSONObj>* keysOut,
+                                double* keysPerSampleOut) const {
+            return _btree->sampleKeys(txn,
+                                      start,
+                                      end,
+                                      kMaxLeavesToSample,
+                                      keysOut,
+                                      keysPerSampleOut);
+        }
+
         class Cursor : public SortedDataInterface::Cursor {
         public:
             Cursor(OperationContext* txn,
@@ -236,6 +249,9 @@ namespace mongo {
         }
 
     private:
+        // Number of leaf buckets read by sampleKeys() to estimate the average leaf fill.
+        static const int kMaxLeavesToSample = 32;
+
         scoped_ptr<BtreeLogic<OnDiskFormat> > _btree;
     };
 
@@ -2073,6 +2073,94 @@ namespace mongo {
         return _recordStore->touch( txn, NULL );
     }
 
+    template <class BtreeLayout>
+    bool BtreeLogic<BtreeLayout>::sampleKeys(OperationContext* txn,
+                                             const BSONObj& start,
+                                             const BSONObj& end,
+                                             int maxLeavesToRead,
+                                             std::vector<BSONObj>* keysOut,
+                                             double* keysPerSampleOut) const {
+        invariant(maxLeavesToRead > 0);
+        keysOut->clear();
+        *keysPerSampleOut = 0;
+
+        DiskLoc rootLoc = getRootLoc(txn);
+        BucketType* root = getBucket(txn, rootLoc);
+        if (NULL == root || childLocForPos(root, 0).isNull()) {
+            // The whole tree is one leaf, there are no separators to sample.
+            return false;
+        }
+
+        KeyDataOwnedType startKey(start);
+        KeyDataOwnedType endKey(end);
+        std::vector<DiskLoc> leaves;
+        _sampleKeys(txn, rootLoc, startKey, endKey, keysOut, &leaves);
+
+        if (keysOut->empty() || leaves.empty()) {
+            return false;
+        }
+
+        // Measure evenly spaced leaves rather than the first few, so that a range which was
+        // filled sequentially (and has a half-full right edge) is not over or under estimated.
+        const size_t toRead = std::min(leaves.size(), static_cast<size_t>(maxLeavesToRead));
+        long long usedKeys = 0;
+        for (size_t i = 0; i < toRead; ++i) {
+            BucketType* leaf = getBucket(txn, leaves[(i * leaves.size()) / toRead]);
+            for (int j = 0; j < leaf->n; ++j) {
+                if (getKeyHeader(leaf, j).isUsed()) {
+                    ++usedKeys;
+                }
+            }
+        }
+
+        *keysPerSampleOut = 1.0 + static_cast<double>(usedKeys) / toRead;
+        return true;
+    }
+
+    template <class BtreeLayout>
+    void BtreeLogic<BtreeLayout>::_sampleKeys(OperationContext* txn,
+                                              const DiskLoc bucketLoc,
+                                              const KeyDataType& start,
+                                              const KeyDataType& end,
+                                              std::vector<BSONObj>* keysOut,
+                                              std::vector<DiskLoc>* leavesOut) const {
+        BucketType* bucket = getBucket(txn, bucketLoc);
+
+        // In-order walk: child i holds the keys between key i-1 and key i, so visiting child i
+        // before key i emits internal keys in ascending order.
+        for (int i = 0; i <= bucket->n; i++) {
+            const bool beforeEnd = (0 == i)
+                || getFullKey(bucket, i - 1).data.woCompare(end, _ordering) < 0;
+            if (!beforeEnd) {
+                // Everything to the right of key i-1 is past the range.
+                return;
+            }
+
+            const bool afterStart = (bucket->n == i)
+                || getFullKey(bucket, i).data.woCompare(start, _ordering) >= 0;
+
+            DiskLoc childLoc = childLocForPos(bucket, i);
+            if (afterStart && !childLoc.isNull()) {
+                BucketType* child = getBucket(txn, childLoc);
+                if (childLocForPos(child, 0).isNull()) {
+                    leavesOut->push_back(childLoc);
+                }
+                else {
+                    _sampleKeys(txn, childLoc, start, end, keysOut, leavesOut);
+                }
+            }
+
+            if (bucket->n == i || !afterStart) {
+                continue;
+            }
+
+            FullKey fullKey = getFullKey(bucket, i);
+            if (fullKey.header.isUsed() && fullKey.data.woCompare(end, _ordering) < 0) {
+                keysOut->push_back(fullKey.data.toBson().getOwned());
+            }
+        }
+    }
+
     template <class BtreeLayout>
     long long BtreeLogic<BtreeLayout>::fullValidate(OperationContext* txn,
                                                     long long *unusedCount,
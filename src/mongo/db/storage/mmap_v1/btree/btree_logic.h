@@ -186,6 +186,25 @@ namespace mongo {
 
         Status touch(OperationContext* txn) const;
 
+        /**
+         * Collects, in ascending order, the used keys in [start, end) stored in the internal
+         * (non-leaf) buckets of the tree.  In key order exactly one leaf bucket lies between two
+         * consecutive internal keys, so each collected key is preceded by roughly one leaf worth
+         * of entries.  '*keysPerSampleOut' is set to that estimate: the average number of used
+         * keys per leaf, measured over at most 'maxLeavesToRead' leaves in the range, plus one.
+         *
+         * Only internal buckets intersecting the range and the measured leaves are read.
+         *
+         * Returns false if the tree has no internal keys in the range (e.g. it is a single
+         * bucket), in which case the caller should count the keys with a cursor instead.
+         */
+        bool sampleKeys(OperationContext* txn,
+                        const BSONObj& start,
+                        const BSONObj& end,
+                        int maxLeavesToRead,
+                        std::vector<BSONObj>* keysOut,
+                        double* keysPerSampleOut) const;
+
         //
         // Composite key navigation methods
         //
@@ -407,6 +426,13 @@ namespace mongo {
                         const DiskLoc& recordLoc,
                         const int direction) const;
 
+        void _sampleKeys(OperationContext* txn,
+                         const DiskLoc bucketLoc,
+                         const KeyDataType& start,
+                         const KeyDataType& end,
+                         std::vector<BSONObj>* keysOut,
+                         std::vector<DiskLoc>* leavesOut) const;
+
         long long _fullValidate(OperationContext* txn,
                                 const DiskLoc bucketLoc,
                                 long long *unusedCount,
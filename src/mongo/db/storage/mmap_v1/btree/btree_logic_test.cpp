@@ -2025,6 +2025,66 @@ namespace mongo {
         }
     };
 
+    template<class OnDiskFormat>
+    class SampleKeysSingleBucket : public BtreeLogicTestBase<OnDiskFormat> {
+    public:
+        void run() {
+            OperationContextNoop txn;
+            this->_helper.btree.initAsEmpty(&txn);
+
+            this->insert(simpleKey('a'), this->_helper.dummyDiskLoc);
+            this->insert(simpleKey('b'), this->_helper.dummyDiskLoc);
+
+            // Nothing to sample in a lone leaf, the caller has to count.
+            std::vector<BSONObj> keys;
+            double keysPerSample;
+            ASSERT_FALSE(this->_helper.btree.sampleKeys(&txn,
+                                                        BSON("" << ""),
+                                                        BSON("" << "z"),
+                                                        8,
+                                                        &keys,
+                                                        &keysPerSample));
+            ASSERT(keys.empty());
+        }
+    };
+
+    template<class OnDiskFormat>
+    class SampleKeys : public BtreeLogicTestBase<OnDiskFormat> {
+    public:
+        void run() {
+            OperationContextNoop txn;
+            ArtificialTreeBuilder<OnDiskFormat> builder(&txn, &this->_helper);
+
+            builder.makeTree("{d:{b:{a:null},bb:null,_:{c:null}},_:{f:{e:null},_:{g:null}}}");
+
+            // Whole tree: every internal key, in order, each following one single-key leaf.
+            std::vector<BSONObj> keys;
+            double keysPerSample;
+            ASSERT(this->_helper.btree.sampleKeys(&txn,
+                                                  BSON("" << ""),
+                                                  BSON("" << "z"),
+                                                  8,
+                                                  &keys,
+                                                  &keysPerSample));
+            ASSERT_EQUALS(4U, keys.size());
+            ASSERT_EQUALS(BSON("" << "b"), keys[0]);
+            ASSERT_EQUALS(BSON("" << "bb"), keys[1]);
+            ASSERT_EQUALS(BSON("" << "d"), keys[2]);
+            ASSERT_EQUALS(BSON("" << "f"), keys[3]);
+            ASSERT_EQUALS(2.0, keysPerSample);
+
+            // Sub-range [c, f): the end bound is exclusive.
+            ASSERT(this->_helper.btree.sampleKeys(&txn,
+                                                  BSON("" << "c"),
+                                                  BSON("" << "f"),
+                                                  8,
+                                                  &keys,
+                                                  &keysPerSample));
+            ASSERT_EQUALS(1U, keys.size());
+            ASSERT_EQUALS(BSON("" << "d"), keys[0]);
+        }
+    };
+
     /* This test requires the entire server to be linked-in and it is better implemented using
        the JS framework. Disabling here and will put in jsCore.
 
@@ -2252,6 +2312,9 @@ namespace mongo {
 
             add< LocateEmptyForward<OnDiskFormat> >();
             add< LocateEmptyReverse<OnDiskFormat> >();
+
+            add< SampleKeysSingleBucket<OnDiskFormat> >();
+            add< SampleKeys<OnDiskFormat> >();
         }
     };
 
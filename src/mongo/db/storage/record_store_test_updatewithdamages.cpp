@@ -101,6 +101,55 @@ namespace mongo {
         }
     }
 
+    // Insert a record and try to perform an in-place update on it with a DamageEvent
+    // that ends at the last byte of the record.
+    TEST( RecordStoreTestHarness, UpdateWithDamageAtEndOfRecord ) {
+        scoped_ptr<HarnessHelper> harnessHelper( newHarnessHelper() );
+        scoped_ptr<RecordStore> rs( harnessHelper->newNonCappedRecordStore() );
+
+        string data = "00010111";
+        DiskLoc loc;
+        {
+            scoped_ptr<OperationContext> opCtx( harnessHelper->newOperationContext() );
+            {
+                WriteUnitOfWork uow( opCtx.get() );
+                StatusWith<DiskLoc> res = rs->insertRecord( opCtx.get(),
+                                                            data.c_str(),
+                                                            data.size() + 1,
+                                                            false );
+                ASSERT_OK( res.getStatus() );
+                loc = res.getValue();
+                uow.commit();
+            }
+        }
+
+        {
+            scoped_ptr<OperationContext> opCtx( harnessHelper->newOperationContext() );
+            {
+                // Overwrite the last two characters and the terminating NUL.
+                string damages = "ab";
+                mutablebson::DamageVector dv( 1 );
+                dv[0].sourceOffset = 0;
+                dv[0].targetOffset = 6;
+                dv[0].size = 3;
+
+                WriteUnitOfWork uow( opCtx.get() );
+                ASSERT_OK( rs->updateWithDamages( opCtx.get(), loc, damages.c_str(), dv ) );
+                uow.commit();
+            }
+        }
+
+        data = "000101ab";
+        {
+            scoped_ptr<OperationContext> opCtx( harnessHelper->newOperationContext() );
+            {
+                RecordData record = rs->dataFor( opCtx.get(), loc );
+                ASSERT_EQUALS( data.size() + 1, static_cast<size_t>( record.size() ) );
+                ASSERT_EQUALS( data, record.data() );
+            }
+        }
+    }
+
     // Insert a record and try to perform an in-place update on it with a DamageVector
     // containing overlapping DamageEvents.
     TEST( RecordStoreTestHarness, UpdateWithOverlappingDamageEvents ) {
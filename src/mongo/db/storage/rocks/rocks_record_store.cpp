@@ -259,12 +259,9 @@ namespace mongo {
 
         // apply changes to our copy
         for( size_t i = 0; i < damages.size(); i++ ) {
-            mutablebson::DamageEvent event = damages[i];
-            const char* sourcePtr = damangeSource + event.sourceOffset;
-
-            invariant( event.targetOffset + event.size < value.length() );
-            value.replace( event.targetOffset, event.size, sourcePtr, event.size );
+            invariant( damages[i].targetOffset + damages[i].size <= value.length() );
         }
+        mutablebson::applyDamages( &value[0], damangeSource, damages );
 
         // write back
         ru->writeBatch()->Put(_columnFamily.get(), key, value);
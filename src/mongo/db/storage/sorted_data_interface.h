@@ -115,6 +115,22 @@ namespace mongo {
             return x;
         }
 
+        /**
+         * Estimates how the entries in [start, end) are distributed without visiting all of them.
+         * On success fills 'keysOut' with keys in ascending order such that roughly
+         * '*keysPerSampleOut' entries lie between consecutive keys, and returns true.
+         *
+         * Implementations that cannot do better than a full scan should return false; callers
+         * must then count entries with a Cursor.
+         */
+        virtual bool sampleKeys(OperationContext* txn,
+                                const BSONObj& start,
+                                const BSONObj& end,
+                                std::vector<BSONObj>* keysOut,
+                                double* keysPerSampleOut) const {
+            return false;
+        }
+
         /**
          * Navigation
          *
@@ -344,13 +344,7 @@ namespace mongo {
         std::string data(reinterpret_cast<const char *>(old_value.data), old_value.size);
 
         // apply changes to our copy
-        char* root = const_cast<char*>( data.c_str() );
-        for( size_t i = 0; i < damages.size(); i++ ) {
-            mutablebson::DamageEvent event = damages[i];
-            const char* sourcePtr = damangeSource + event.sourceOffset;
-            char* targetPtr = root + event.targetOffset;
-            std::memcpy(targetPtr, sourcePtr, event.size);
-        }
+        mutablebson::applyDamages( &data[0], damangeSource, damages );
 
         // write back
         WiredTigerItem value(data);
@@ -30,6 +30,7 @@
 
 #include "mongo/bson/util/builder.h"
 #include "mongo/db/field_ref.h"
+#include "mongo/db/field_ref_set.h"
 #include "mongo/db/update_index_data.h"
 
 namespace mongo {
@@ -98,6 +99,14 @@ namespace mongo {
         return false;
     }
 
+    bool UpdateIndexData::mightBeIndexed( const FieldRefSet& paths ) const {
+        for ( FieldRefSet::const_iterator i = paths.begin(); i != paths.end(); ++i ) {
+            if ( mightBeIndexed( (*i)->dottedField() ) )
+                return true;
+        }
+        return false;
+    }
+
     bool UpdateIndexData::_startsWith( const StringData& a, const StringData& b ) const {
         if ( !a.startsWith( b ) )
             return false;
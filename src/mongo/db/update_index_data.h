@@ -36,6 +36,8 @@
 
 namespace mongo {
 
+    class FieldRefSet;
+
     /**
      * a.$ -> a
      * @return true if out is set and we made a change
@@ -73,6 +75,11 @@ namespace mongo {
 
         bool mightBeIndexed( const StringData& path ) const;
 
+        /**
+         * Returns true if mightBeIndexed() holds for any of 'paths'.
+         */
+        bool mightBeIndexed( const FieldRefSet& paths ) const;
+
     private:
 
         bool _startsWith( const StringData& a, const StringData& b ) const;
@@ -29,6 +29,8 @@
 
 #include "mongo/unittest/unittest.h"
 
+#include "mongo/db/field_ref.h"
+#include "mongo/db/field_ref_set.h"
 #include "mongo/db/update_index_data.h"
 
 namespace mongo {
@@ -125,4 +127,34 @@ namespace mongo {
         ASSERT_FALSE( getCanonicalIndexField( "a.", &x ) );
     }
 
+    TEST( UpdateIndexDataTest, FieldRefSet1 ) {
+        UpdateIndexData a;
+        a.addPath( "a.b" );
+
+        FieldRef x( "c" );
+        FieldRef y( "a.c" );
+        FieldRefSet paths;
+        const FieldRef* conflict;
+        ASSERT_FALSE( a.mightBeIndexed( paths ) );
+        ASSERT_TRUE( paths.insert( &x, &conflict ) );
+        ASSERT_TRUE( paths.insert( &y, &conflict ) );
+        ASSERT_FALSE( a.mightBeIndexed( paths ) );
+
+        // a positional update resolved to an array element of an indexed path
+        FieldRef z( "a.3.b" );
+        ASSERT_TRUE( paths.insert( &z, &conflict ) );
+        ASSERT_TRUE( a.mightBeIndexed( paths ) );
+    }
+
+    TEST( UpdateIndexDataTest, FieldRefSetParent1 ) {
+        UpdateIndexData a;
+        a.addPath( "a.b.c" );
+
+        FieldRef x( "a" );
+        FieldRefSet paths;
+        const FieldRef* conflict;
+        ASSERT_TRUE( paths.insert( &x, &conflict ) );
+        ASSERT_TRUE( a.mightBeIndexed( paths ) );
+    }
+
 }
@@ -896,6 +896,81 @@ namespace DocumentSourceTests {
             string expectedResultSetString() { return "[{_id:[1,2,3],a:[[4,5,6]]}]"; }
         };
 
+        /**
+         * A $group with an $unwind fused into it, and a $match coalesced into that, produces the
+         * same groups as the three stages on their own.
+         */
+        class FusedUnwind : public Base {
+        public:
+            void run() {
+                BSONArrayBuilder data;
+                for (int i = 0; i < 10; ++i) {
+                    BSONArrayBuilder items;
+                    for (int j = 0; j < 1000; ++j) {
+                        if ( j % 100 == 0 )
+                            items << BSON( "sku" << j % 7 );
+                        else
+                            items << BSON( "sku" << j % 7 << "qty" << ( i + j ) % 11 );
+                    }
+                    data << BSON( "_id" << i << "a" << BSON( "items" << items.arr() ) );
+                }
+                data << BSON( "_id" << 10 );
+                data << BSON( "_id" << 11 << "a" << BSON( "items" << BSONArray() ) );
+                const BSONObj input = data.arr();
+
+                const vector<BSONObj> separate = groups( input, false );
+                const vector<BSONObj> fused = groups( input, true );
+                ASSERT_EQUALS( 7U, separate.size() );
+                ASSERT_EQUALS( separate.size(), fused.size() );
+                for (size_t i = 0; i < separate.size(); ++i) {
+                    ASSERT_EQUALS( separate[i], fused[i] );
+                }
+            }
+        private:
+            vector<BSONObj> groups( const BSONObj& input, bool fuse ) {
+                intrusive_ptr<DocumentSource> source =
+                        DocumentSourceBsonArray::create( input, ctx() );
+                intrusive_ptr<DocumentSource> unwind = mongo::DocumentSourceUnwind::createFromBson(
+                        BSON( "$unwind" << "$a.items" ).firstElement(), ctx() );
+                intrusive_ptr<DocumentSource> match = mongo::DocumentSourceMatch::createFromBson(
+                        fromjson( "{$match:{'a.items.qty':{$gte:5}}}" ).firstElement(), ctx() );
+                intrusive_ptr<DocumentSource> groupSource = DocumentSourceGroup::createFromBson(
+                        fromjson( "{$group:{_id:'$a.items.sku',n:{$sum:1},"
+                                  "qty:{$sum:'$a.items.qty'},ids:{$push:'$_id'}}}" )
+                            .firstElement(),
+                        ctx() );
+                intrusive_ptr<DocumentSourceGroup> group =
+                        dynamic_cast<DocumentSourceGroup*>( groupSource.get() );
+
+                if ( fuse ) {
+                    ASSERT( unwind->coalesce( match ) );
+                    group->fuseUnwind(
+                            dynamic_cast<mongo::DocumentSourceUnwind*>( unwind.get() ) );
+                    group->setSource( source.get() );
+
+                    // The fused stages still serialize as three.
+                    vector<Value> serialized;
+                    group->serializeToArray( serialized );
+                    ASSERT_EQUALS( 3U, serialized.size() );
+                    ASSERT( !serialized[0].getDocument()[ "$unwind" ].missing() );
+                    ASSERT( !serialized[1].getDocument()[ "$match" ].missing() );
+                    ASSERT( !serialized[2].getDocument()[ "$group" ].missing() );
+                }
+                else {
+                    unwind->setSource( source.get() );
+                    match->setSource( unwind.get() );
+                    group->setSource( match.get() );
+                }
+
+                vector<BSONObj> results;
+                while (boost::optional<Document> next = group->getNext()) {
+                    results.push_back( next->toBson() );
+                }
+                std::sort( results.begin(), results.end(), BSONObjCmp() );
+                return results;
+            }
+        };
+
     } // namespace DocumentSourceGroup
 
     namespace DocumentSourceProject {
@@ -1044,7 +1119,99 @@ namespace DocumentSourceTests {
                 ASSERT_EQUALS( true, dependencies.needTextScore );
             }
         };
-        
+
+        /**
+         * Arithmetic fields are computed a batch at a time over columns.  Check that the results,
+         * their types and the output field order match evaluating each document on its own,
+         * including for batches that can't be evaluated over columns.
+         */
+        class ColumnarComputedFields : public Base {
+        public:
+            void run() {
+                // One batch of ints, one of longs and doubles and a last, short one that mixes
+                // types, so that some batches are computed over columns and some are not.
+                const int batchSize = DocumentSourceProject::kBatchSize;
+                const int nDocs = 2 * batchSize + 10;
+                for (int i = 0; i < nDocs; ++i) {
+                    BSONObjBuilder bob;
+                    bob.append( "_id", i );
+                    if ( i < batchSize ) {
+                        bob.append( "a", i );
+                        bob.append( "b", 2 );
+                    }
+                    else if ( i < 2 * batchSize ) {
+                        bob.append( "a", static_cast<long long>( i ) * 1000000000LL );
+                        bob.append( "b", i % 7 + 1.5 );
+                    }
+                    else {
+                        if ( i % 2 )
+                            bob.append( "a", i );
+                        else
+                            bob.append( "a", i + 0.25 );
+                        // A missing field makes the results null.
+                        if ( i != nDocs - 1 )
+                            bob.append( "b", 3 );
+                    }
+                    bob.append( "c", "x" );
+                    client.insert( ns, bob.obj() );
+                }
+                createSource();
+                createProject( fromjson( "{c:true,"
+                                         " sum:{$add:['$a','$b',1]},"
+                                         " diff:{$subtract:['$a',{$multiply:['$b',2]}]},"
+                                         " ratio:{$divide:['$a','$b']},"
+                                         " x:'$c'}" ) );
+
+                BSONObj spec = fromjson( "{sum:{$add:['$a','$b',1]},"
+                                         " diff:{$subtract:['$a',{$multiply:['$b',2]}]},"
+                                         " ratio:{$divide:['$a','$b']}}" );
+                VariablesIdGenerator idGenerator;
+                VariablesParseState vps( &idGenerator );
+                Expression::ObjectCtx ctx( Expression::ObjectCtx::DOCUMENT_OK );
+                intrusive_ptr<Expression> expected = Expression::parseObject( spec, &ctx, vps );
+
+                for (int i = 0; i < nDocs; ++i) {
+                    boost::optional<Document> next = project()->getNext();
+                    ASSERT( bool( next ) );
+                    BSONObj input =
+                        client.findOne( ns, BSON( "_id" << next->getField( "_id" ).getInt() ) );
+                    Document want = expected->evaluate( Document( input ) ).getDocument();
+                    ASSERT_EQUALS( 6U, next->size() );
+                    FieldIterator fields( *next );
+                    ASSERT_EQUALS( "_id", fields.next().first );
+                    ASSERT_EQUALS( "c", fields.next().first );
+                    const char* computed[] = { "sum", "diff", "ratio" };
+                    for (size_t j = 0; j < 3; ++j) {
+                        Document::FieldPair field = fields.next();
+                        ASSERT_EQUALS( computed[j], field.first );
+                        ASSERT_EQUALS( want[computed[j]].getType(), field.second.getType() );
+                        ASSERT_EQUALS( want[computed[j]], field.second );
+                    }
+                    ASSERT_EQUALS( "x", fields.next().first );
+                }
+                assertExhausted();
+
+                // The projection still serializes as written.
+                vector<Value> arr;
+                project()->serializeToArray( arr );
+                ASSERT_EQUALS( fromjson( "{$add:['$a','$b',{$const:1}]}" ),
+                               arr[0].getDocument()["$project"]["sum"].getDocument().toBson() );
+            }
+        };
+
+        /** A zero divisor in a batch is still reported by $divide. */
+        class ColumnarDivideByZero : public Base {
+        public:
+            void run() {
+                client.insert( ns, BSON( "_id" << 0 << "a" << 1 << "b" << 2 ) );
+                client.insert( ns, BSON( "_id" << 1 << "a" << 1 << "b" << 0 ) );
+                createSource();
+                createProject( fromjson( "{q:{$divide:['$a','$b']}}" ) );
+                ASSERT_EQUALS( 0.5, project()->getNext()->getField( "q" ).getDouble() );
+                ASSERT_THROWS( project()->getNext(), UserException );
+            }
+        };
+
     } // namespace DocumentSourceProject
 
     namespace DocumentSourceSort {
@@ -1642,6 +1809,46 @@ namespace DocumentSourceTests {
             }
         };
 
+        /**
+         * A following $match on the unwound field is coalesced into the $unwind and applied to
+         * each array element, while a $match on any other field is not.
+         */
+        class CoalesceMatch : public Base {
+        public:
+            void run() {
+                client.insert( ns, fromjson( "{_id:0,a:{b:[{c:1},{c:5},{d:1},{c:7}]},e:1}" ) );
+                client.insert( ns, fromjson( "{_id:1,a:{b:[{c:9}]},e:2}" ) );
+                client.insert( ns, fromjson( "{_id:2,a:{b:[]}}" ) );
+                createSource();
+                createUnwind( "$a.b" );
+
+                ASSERT( !unwind()->coalesce( makeMatch( "{e:1}" ) ) );
+                ASSERT( !unwind()->coalesce( makeMatch( "{a:{$exists:true}}" ) ) );
+                ASSERT( unwind()->coalesce( makeMatch( "{'a.b.c':{$gt:2}}" ) ) );
+                ASSERT( unwind()->coalesce( makeMatch( "{'a.b.c':{$lt:8}}" ) ) );
+
+                vector<Value> serialized;
+                unwind()->serializeToArray( serialized );
+                ASSERT_EQUALS( 2U, serialized.size() );
+                ASSERT_EQUALS( fromjson( "{$match:{$and:[{'a.b.c':{$gt:2}},{'a.b.c':{$lt:8}}]}}" ),
+                               serialized[1].getDocument().toBson() );
+
+                BSONArrayBuilder results;
+                while (boost::optional<Document> next = unwind()->getNext()) {
+                    results << *next;
+                }
+                ASSERT_EQUALS( fromjson( "{'':[{_id:0,a:{b:{c:5}},e:1},{_id:0,a:{b:{c:7}},e:1}]}" )
+                                   .firstElement().Obj(),
+                               results.arr() );
+                assertExhausted();
+            }
+        private:
+            intrusive_ptr<DocumentSource> makeMatch( const string& queryJson ) {
+                BSONObj spec = BSON( "$match" << fromjson( queryJson ) );
+                return mongo::DocumentSourceMatch::createFromBson( spec.firstElement(), ctx() );
+            }
+        };
+
     } // namespace DocumentSourceUnwind
 
     namespace DocumentSourceGeoNear {
@@ -1876,6 +2083,23 @@ namespace DocumentSourceTests {
                                                                      "{c:1}]}"));
             }
         };
+
+        class DependsOnlyOnPath {
+        public:
+            void run() {
+                ASSERT(makeMatch("{}")->dependsOnlyOnPath("a.b"));
+                ASSERT(makeMatch("{'a.b': 1}")->dependsOnlyOnPath("a.b"));
+                ASSERT(makeMatch("{'a.b.c': {$gt: 1}, 'a.b.d': 2}")->dependsOnlyOnPath("a.b"));
+                ASSERT(makeMatch("{$or: [{'a.b.c': 1}, {$and: [{'a.b': 2}]}]}")
+                           ->dependsOnlyOnPath("a.b"));
+
+                ASSERT(!makeMatch("{a: 1}")->dependsOnlyOnPath("a.b"));
+                ASSERT(!makeMatch("{'a.bc': 1}")->dependsOnlyOnPath("a.b"));
+                ASSERT(!makeMatch("{'a.b.c': 1, d: 1}")->dependsOnlyOnPath("a.b"));
+                ASSERT(!makeMatch("{$nor: [{'a.b': 1}, {d: 1}]}")->dependsOnlyOnPath("a.b"));
+                ASSERT(!makeMatch("{'a.b': 1, $comment: 'x'}")->dependsOnlyOnPath("a.b"));
+            }
+        };
     } // namespace DocumentSourceMatch
 
     class All : public Suite {
@@ -1930,6 +2154,7 @@ namespace DocumentSourceTests {
             add<DocumentSourceGroup::Dependencies>();
             add<DocumentSourceGroup::StringConstantIdAndAccumulatorExpressions>();
             add<DocumentSourceGroup::ArrayConstantAccumulatorExpression>();
+            add<DocumentSourceGroup::FusedUnwind>();
 
             add<DocumentSourceProject::Inclusion>();
             add<DocumentSourceProject::Optimize>();
@@ -1939,6 +2164,8 @@ namespace DocumentSourceTests {
             add<DocumentSourceProject::InvalidSpec>();
             add<DocumentSourceProject::TwoDocuments>();
             add<DocumentSourceProject::Dependencies>();
+            add<DocumentSourceProject::ColumnarComputedFields>();
+            add<DocumentSourceProject::ColumnarDivideByZero>();
 
             add<DocumentSourceSort::Empty>();
             add<DocumentSourceSort::SingleValue>();
@@ -1978,11 +2205,13 @@ namespace DocumentSourceTests {
             add<DocumentSourceUnwind::SeveralDocuments>();
             add<DocumentSourceUnwind::SeveralMoreDocuments>();
             add<DocumentSourceUnwind::Dependencies>();
+            add<DocumentSourceUnwind::CoalesceMatch>();
 
             add<DocumentSourceGeoNear::LimitCoalesce>();
 
             add<DocumentSourceMatch::RedactSafePortion>();
             add<DocumentSourceMatch::Coalesce>();
+            add<DocumentSourceMatch::DependsOnlyOnPath>();
         }
     } myall;
 
@@ -2665,8 +2665,195 @@ namespace JsonTests {
             }
         };
 
+        // Plain integers of up to 18 digits are converted without strtod and strtoll.
+        class FastPathIntegers : public Base {
+        public:
+            void run() {
+                Base::run();
+
+                BSONObj o = fromjson(json());
+                ASSERT_EQUALS( bson(), o );
+
+                ASSERT_EQUALS( NumberInt, o["zero"].type() );
+                ASSERT_EQUALS( NumberInt, o["neg"].type() );
+                ASSERT_EQUALS( NumberInt, o["intMax"].type() );
+                ASSERT_EQUALS( NumberLong, o["intMaxPlus1"].type() );
+                ASSERT_EQUALS( NumberInt, o["intMin"].type() );
+                ASSERT_EQUALS( NumberLong, o["intMinMinus1"].type() );
+                ASSERT_EQUALS( NumberLong, o["digits18"].type() );
+                ASSERT_EQUALS( NumberInt, o["last"].type() );
+
+                ASSERT_EQUALS( 2147483648LL, o["intMaxPlus1"].numberLong() );
+                ASSERT_EQUALS( -2147483649LL, o["intMinMinus1"].numberLong() );
+                ASSERT_EQUALS( 999999999999999999LL, o["digits18"].numberLong() );
+            }
+
+            virtual BSONObj bson() const {
+                return BSON( "zero" << 0
+                             << "neg" << -7
+                             << "intMax" << 2147483647
+                             << "intMaxPlus1" << 2147483648LL
+                             << "intMin" << -2147483647 - 1
+                             << "intMinMinus1" << -2147483649LL
+                             << "digits18" << 999999999999999999LL
+                             << "last" << 12 );
+            }
+            virtual string json() const {
+                return "{ \"zero\" : 0, \"neg\" : -7, \"intMax\" : 2147483647, "
+                       "\"intMaxPlus1\" : 2147483648, \"intMin\" : -2147483648, "
+                       "\"intMinMinus1\" : -2147483649, \"digits18\" : 999999999999999999, "
+                       "\"last\":12}";
+            }
+        };
+
+        // Fractions, exponents and integers too long for the fast path still go through strtod
+        // and strtoll.
+        class SlowPathNumbers : public Base {
+        public:
+            void run() {
+                Base::run();
+
+                BSONObj o = fromjson(json());
+                ASSERT_EQUALS( bson(), o );
+
+                ASSERT_EQUALS( NumberLong, o["digits19"].type() );
+                ASSERT_EQUALS( NumberLong, o["longMin"].type() );
+                ASSERT_EQUALS( NumberDouble, o["tooLong"].type() );
+                ASSERT_EQUALS( NumberDouble, o["fraction"].type() );
+                ASSERT_EQUALS( NumberDouble, o["exponent"].type() );
+                ASSERT_EQUALS( NumberDouble, o["negExponent"].type() );
+
+                ASSERT_EQUALS( 1000000000000000000LL, o["digits19"].numberLong() );
+                ASSERT_EQUALS( std::numeric_limits<long long>::min(), o["longMin"].numberLong() );
+            }
+
+            virtual BSONObj bson() const {
+                return BSON( "digits19" << 1000000000000000000LL
+                             << "longMin" << std::numeric_limits<long long>::min()
+                             << "tooLong" << 1e19
+                             << "fraction" << 1.5
+                             << "exponent" << 1000.0
+                             << "negExponent" << -0.025 );
+            }
+            virtual string json() const {
+                return "{ \"digits19\" : 1000000000000000000, "
+                       "\"longMin\" : -9223372036854775808, "
+                       "\"tooLong\" : 10000000000000000000, \"fraction\" : 1.5, "
+                       "\"exponent\" : 1e3, \"negExponent\" : -2.5E-2 }";
+            }
+        };
+
+        class NumberAtEndOfInput : public Bad {
+            virtual string json() const {
+                return "{ \"a\" : 12";
+            }
+        };
+
+        // Runs of unescaped characters are copied at once, around any escapes.
+        class StringRuns : public Base {
+        public:
+            void run() {
+                Base::run();
+                ASSERT_EQUALS( bson(), fromjson( json() ) );
+            }
+
+            virtual BSONObj bson() const {
+                return BSON( "empty" << ""
+                             << "plain" << "no escapes at all"
+                             << "escapes" << "\"start, mid\\dle\nand end\t"
+                             << "single" << "it's \"quoted\""
+                             << "unicode" << "caf\xc3\xa9 au lait"
+                             << "long" << string( 200, 'x' ) + "\n" + string( 200, 'y' ) );
+            }
+            virtual string json() const {
+                return "{ \"empty\" : \"\", \"plain\" : \"no escapes at all\", "
+                       "\"escapes\" : \"\\\"start, mid\\\\dle\\nand end\\t\", "
+                       "'single' : 'it\\'s \"quoted\"', "
+                       "\"unicode\" : \"caf\\u00e9 au lait\", "
+                       "\"long\" : \"" + string( 200, 'x' ) + "\\n" + string( 200, 'y' ) + "\" }";
+            }
+        };
+
+        class StringAtEndOfInput : public Bad {
+            virtual string json() const {
+                return "{ \"a\" : \"abc";
+            }
+        };
+
     } // namespace FromJsonTests
 
+    namespace FromJsonLinesTests {
+
+        class Basic {
+        public:
+            void run() {
+                vector<BSONObj> docs;
+                ASSERT_OK( fromjsonLines( "{ a : 1 }\n\n  \n{ b : \"x\" }\r\n{ c : [ 1, 2 ] }",
+                                          &docs ) );
+                ASSERT_EQUALS( 3U, docs.size() );
+                ASSERT_EQUALS( BSON( "a" << 1 ), docs[0] );
+                ASSERT_EQUALS( BSON( "b" << "x" ), docs[1] );
+                ASSERT_EQUALS( BSON( "c" << BSON_ARRAY( 1 << 2 ) ), docs[2] );
+            }
+        };
+
+        class Streaming {
+        public:
+            void run() {
+                const string input = "{ a : 1 }\n{ b : 2 }\n{ c : 3 }";
+                vector<BSONObj> docs;
+                size_t consumed = 0;
+
+                // The last line may be incomplete, so it is left for the next buffer.
+                ASSERT_OK( fromjsonLines( StringData( input.data(), 15 ), &docs, &consumed ) );
+                ASSERT_EQUALS( 10U, consumed );
+                ASSERT_EQUALS( 1U, docs.size() );
+
+                ASSERT_OK( fromjsonLines( input.substr( consumed ), &docs, &consumed ) );
+                ASSERT_EQUALS( 10U, consumed );
+                ASSERT_EQUALS( 2U, docs.size() );
+
+                ASSERT_OK( fromjsonLines( "{ c : 3 }\n", &docs, &consumed ) );
+                ASSERT_EQUALS( 10U, consumed );
+                ASSERT_EQUALS( 3U, docs.size() );
+                ASSERT_EQUALS( BSON( "c" << 3 ), docs[2] );
+            }
+        };
+
+        class ExtendedJson {
+        public:
+            void run() {
+                vector<BSONObj> docs;
+                ASSERT_OK( fromjsonLines( "{ \"_id\" : { \"$oid\" : \"deadbeefdeadbeefdeadbeef\" } }\n"
+                                          "{ d : { \"$date\" : 1 }, n : NumberLong( 5 ) }\n",
+                                          &docs ) );
+                ASSERT_EQUALS( 2U, docs.size() );
+                ASSERT_EQUALS( fromjson( "{ \"_id\" : { \"$oid\" : \"deadbeefdeadbeefdeadbeef\" } }" ),
+                               docs[0] );
+                ASSERT_EQUALS( Date, docs[1]["d"].type() );
+                ASSERT_EQUALS( 5, docs[1]["n"].numberLong() );
+            }
+        };
+
+        class Bad {
+        public:
+            void run() {
+                vector<BSONObj> docs;
+                Status status = fromjsonLines( "{ a : 1 }\n{ a : }\n{ a : 3 }\n", &docs );
+                ASSERT_EQUALS( ErrorCodes::FailedToParse, status.code() );
+                ASSERT_EQUALS( 0U, status.reason().find( "line 2: " ) );
+                ASSERT_EQUALS( 1U, docs.size() );
+
+                // Each line holds exactly one object.
+                docs.clear();
+                ASSERT_NOT_OK( fromjsonLines( "{ a : 1 } { b : 2 }\n", &docs ) );
+                ASSERT_NOT_OK( fromjsonLines( "[ 1, 2 ]\n", &docs ) );
+                ASSERT_NOT_OK( fromjsonLines( "{ a : 1,\n b : 2 }\n", &docs ) );
+            }
+        };
+
+    } // namespace FromJsonLinesTests
+
     class All : public Suite {
     public:
         All() : Suite( "json" ) {
@@ -2928,6 +3115,16 @@ namespace JsonTests {
             add< FromJsonTests::NullFieldUnquoted >();
             add< FromJsonTests::MinKey >();
             add< FromJsonTests::MaxKey >();
+            add< FromJsonTests::FastPathIntegers >();
+            add< FromJsonTests::SlowPathNumbers >();
+            add< FromJsonTests::NumberAtEndOfInput >();
+            add< FromJsonTests::StringRuns >();
+            add< FromJsonTests::StringAtEndOfInput >();
+
+            add< FromJsonLinesTests::Basic >();
+            add< FromJsonLinesTests::Streaming >();
+            add< FromJsonLinesTests::ExtendedJson >();
+            add< FromJsonLinesTests::Bad >();
         }
     } myall;
 
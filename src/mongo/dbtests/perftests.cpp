@@ -41,16 +41,25 @@
 #include <iomanip>
 #include <fstream>
 
+#include "mongo/bson/bson_field_index.h"
+#include "mongo/bson/bson_validate.h"
 #include "mongo/db/db.h"
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/db/json.h"
 #include "mongo/db/lasterror.h"
+#include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context_impl.h"
 #include "mongo/db/storage/mmap_v1/durable_mapped_file.h"
 #include "mongo/db/storage/mmap_v1/dur_stats.h"
 #include "mongo/db/storage/mmap_v1/btree/key.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/dbtests/framework_options.h"
+#include "mongo/logger/async_file_appender.h"
+#include "mongo/logger/async_file_writer.h"
+#include "mongo/logger/message_event.h"
+#include "mongo/logger/message_event_utf8_encoder.h"
+#include "mongo/logger/rotatable_file_appender.h"
+#include "mongo/logger/rotatable_file_writer.h"
 #include "mongo/util/allocator.h"
 #include "mongo/util/checksum.h"
 #include "mongo/util/compress.h"
@@ -455,6 +464,141 @@ namespace PerfTests {
         }
     };
 
+    class BSONValidateWide : public NonDurTest {
+    public:
+        int n;
+        bo b;
+        string name() { return "BSONValidateWide"; }
+        BSONValidateWide() {
+            n = 0;
+            bob builder;
+            builder.append( "_id", OID() );
+            for( int i = 0; i < 200; i++ )
+                builder.append( BSONObjBuilder::numStr(i) + "field", i );
+            b = builder.obj();
+        }
+        void timed() {
+            if( validateBSON( b.objdata(), b.objsize() ).isOK() )
+                n++;
+        }
+    };
+
+    class BSONValidateLargeValues : public BSONValidateWide {
+    public:
+        string name() { return "BSONValidateLargeValues"; }
+        BSONValidateLargeValues() {
+            const string big( 50 * 1024, 'x' );
+            b = BSON( "_id" << OID() << "s" << big << "sub" << BSON( "s" << big ) );
+        }
+    };
+
+    class BSONValidateNested : public BSONValidateWide {
+    public:
+        string name() { return "BSONValidateNested"; }
+        BSONValidateNested() {
+            b = BSON( "x" << 1 );
+            for( int i = 0; i < 20; i++ )
+                b = BSON( "_id" << i << "a" << BSON_ARRAY( "y" << b ) );
+        }
+    };
+
+    // looks up 20 fields of a 200 field object
+    class BSONGetFieldWide : public NonDurTest {
+    public:
+        int n;
+        bo b;
+        vector<string> names;
+        string name() { return "BSONGetFieldWide"; }
+        BSONGetFieldWide() {
+            n = 0;
+            bob builder;
+            for( int i = 0; i < 200; i++ )
+                builder.append( BSONObjBuilder::numStr(i) + "field", i );
+            b = builder.obj();
+            for( int i = 0; i < 200; i += 10 )
+                names.push_back( BSONObjBuilder::numStr(i) + "field" );
+        }
+        void timed() {
+            for( size_t i = 0; i < names.size(); i++ )
+                if( !b.getField( names[i] ).eoo() )
+                    n++;
+        }
+    };
+
+    // the same lookups, including the cost of building the index each time
+    class BSONFieldIndexWide : public BSONGetFieldWide {
+    public:
+        string name() { return "BSONFieldIndexWide"; }
+        void timed() {
+            BSONFieldIndex index( b );
+            for( size_t i = 0; i < names.size(); i++ )
+                if( !index.getField( names[i] ).eoo() )
+                    n++;
+        }
+    };
+
+    // appends log lines to a file from one thread, then from several at once
+    class LogAppenderSync : public NonDurTest {
+    public:
+        LogAppenderSync() : _path((boost::filesystem::temp_directory_path() /
+                                   "perftest_log_appender.txt").string()) {
+            logger::RotatableFileWriter::Use writerUse(&_writer);
+            verify(writerUse.setFileName(_path, false).isOK());
+        }
+        virtual ~LogAppenderSync() {
+            _appender.reset();
+            boost::filesystem::remove(_path);
+        }
+        string name() { return "LogAppenderSync"; }
+        virtual string name2() { return name() + "-2"; }
+        virtual bool testThreaded() { return true; }
+        void prep() {
+            _appender.reset(new logger::RotatableFileAppender<logger::MessageEventEphemeral>(
+                                    new logger::MessageEventDetailsEncoder, &_writer));
+        }
+        void timed() {
+            append();
+        }
+        virtual void timed2(DBClientBase*) {
+            append();
+        }
+    protected:
+        void append() {
+            logger::MessageEventEphemeral event(curTimeMillis64(),
+                                                logger::LogSeverity::Log(),
+                                                "perftestthr",
+                                                "a log line of about the usual length, with a "
+                                                "number or two in it: 12345 67890");
+            verify(_appender->append(event).isOK());
+        }
+
+        string _path;
+        logger::RotatableFileWriter _writer;
+        boost::scoped_ptr<logger::Appender<logger::MessageEventEphemeral> > _appender;
+    };
+
+    // the same through an AsyncFileWriter
+    class LogAppenderAsync : public LogAppenderSync {
+    public:
+        string name() { return "LogAppenderAsync"; }
+        void prep() {
+            _asyncWriter.reset(new logger::AsyncFileWriter(&_writer,
+                                                           1024 * 1024,
+                                                           logger::AsyncFileWriter::kBlock));
+            _appender.reset(new logger::AsyncFileAppender<logger::MessageEventEphemeral>(
+                                    new logger::MessageEventDetailsEncoder, _asyncWriter.get()));
+        }
+        void post() {
+            _asyncWriter->flush();
+        }
+        virtual ~LogAppenderAsync() {
+            _appender.reset();
+            _asyncWriter.reset();
+        }
+    private:
+        boost::scoped_ptr<logger::AsyncFileWriter> _asyncWriter;
+    };
+
     class KeyTest : public B {
     public:
         KeyV1Owned a,b,c;
@@ -1075,6 +1219,238 @@ namespace PerfTests {
         }
     };
 
+    /** $set an unindexed field to values of varying length, so the update cannot be done in
+        place, on a collection with several indexes that the update does not touch
+    */
+    class UpdateUnindexedField : public B {
+    public:
+        static int rand() {
+            return std::rand() & 0x3fff;
+        }
+        virtual string name() { return "update-unindexed-field"; }
+        void prep() {
+            for ( int x = 0; x <= 0x3fff; x++ ) {
+                client()->insert( ns(), BSON( "_id" << x << "x" << x << "y" << x << "z" << x <<
+                                              "s" << "" ) );
+            }
+            client()->ensureIndex(ns(), BSON("x"<<1));
+            client()->ensureIndex(ns(), BSON("y"<<1));
+            client()->ensureIndex(ns(), BSON("z"<<1));
+            client()->ensureIndex(ns(), BSON("x"<<1<<"y"<<1<<"z"<<1));
+        }
+        void timed() {
+            static const string big( 64, 'x' );
+            int x = rand();
+            BSONObj u = BSON( "$set" << BSON( "s" << big.substr( 0, x % 64 ) ) );
+            client()->update( ns(), BSON( "_id" << x ), u );
+        }
+    };
+
+    /** $inc, then $set of a same-sized value, on ~64KB documents.  neither changes the
+        document's size, so both are applied to the record store as damages.
+    */
+    class UpdateLargeDocInPlace : public B {
+    public:
+        static int rand() {
+            return std::rand() & 0xff;
+        }
+        virtual string name() { return "update-large-doc-inc"; }
+        void prep() {
+            const string pad( 64 * 1024, 'p' );
+            for ( int x = 0; x <= 0xff; x++ ) {
+                client()->insert( ns(), BSON( "_id" << x << "n" << 0 << "w" << "aaaa" <<
+                                              "pad" << pad ) );
+            }
+        }
+        void timed() {
+            static BSONObj I = BSON( "$inc" << BSON( "n" << 1 ) );
+            client()->update( ns(), BSON( "_id" << rand() ), I );
+        }
+        virtual string name2() { return "update-large-doc-set"; }
+        virtual void timed2(DBClientBase* c) {
+            static const char* words[] = { "aaaa", "bbbb", "cccc", "dddd" };
+            int x = rand();
+            c->update( ns(), BSON( "_id" << x ), BSON( "$set" << BSON( "w" << words[x & 3] ) ) );
+        }
+    };
+
+    /** $text search sorted by score with a small limit, against the same search with no limit.
+        word frequencies are skewed so that the query terms have long posting lists.
+    */
+    class TextSearchTopK : public B {
+    public:
+        virtual string name() { return "text-search-top10"; }
+        void prep() {
+            for ( int x = 0; x < 20000; x++ ) {
+                StringBuilder words;
+                for ( int w = 0; w < 24; w++ ) {
+                    // skewed towards low word numbers
+                    int n = ( std::rand() % 200 ) * ( std::rand() % 200 ) / 200;
+                    words << "w" << n << ' ';
+                }
+                client()->insert( ns(), BSON( "_id" << x << "t" << words.str() ) );
+            }
+            client()->ensureIndex( ns(), BSON( "t" << "text" ) );
+        }
+        void search(DBClientBase* c, int nToReturn) {
+            static BSONObj fields = BSON( "score" << BSON( "$meta" << "textScore" ) );
+            Query q = Query( BSON( "$text" << BSON( "$search" << "w1 w3 w7" ) ) )
+                .sort( BSON( "score" << BSON( "$meta" << "textScore" ) ) );
+            auto_ptr<DBClientCursor> cursor = c->query( ns(), q, nToReturn, 0, &fields );
+            verify( cursor->itcount() > 0 );
+        }
+        void timed() {
+            search( client(), -10 );
+        }
+        virtual string name2() { return "text-search-unlimited"; }
+        virtual void timed2(DBClientBase* c) {
+            search( c, 0 );
+        }
+    };
+
+    /** inserts of prose-like documents into a collection with a text index.  most of the
+        time goes to tokenizing and stemming, which repeats the same few hundred words.
+    */
+    class InsertTextIndexed : public B {
+    public:
+        virtual string name() { return "insert-text-indexed"; }
+        void prep() {
+            client()->ensureIndex( ns(), BSON( "title" << "text" << "body" << "text" ) );
+            static const char* words[] = {
+                "running", "runner", "runs", "walked", "walking", "the", "quick", "brown",
+                "foxes", "jumped", "over", "lazy", "dogs", "indexing", "indexes", "searching",
+                "searched", "documents", "databases", "queries", "stemming", "stemmed", "words",
+                "languages", "tokens", "tokenizer", "score", "scoring", "collections", "shards"
+            };
+            const int nWords = sizeof( words ) / sizeof( words[0] );
+            for ( int i = 0; i < 64; i++ ) {
+                StringBuilder body;
+                for ( int w = 0; w < 200; w++ ) {
+                    body << words[ std::rand() % nWords ] << ( w % 12 == 11 ? ". " : " " );
+                }
+                _bodies.push_back( body.str() );
+            }
+            _i = 0;
+        }
+        void timed() {
+            client()->insert( ns(), BSON( "title" << "Stemming and scoring words" <<
+                                          "body" << _bodies[ _i++ % _bodies.size() ] ) );
+        }
+    private:
+        vector<string> _bodies;
+        unsigned _i;
+    };
+
+    /** $geoWithin queries on a 2dsphere index with a 200 vertex polygon, over a small
+        collection so that planning (covering the polygon) dominates.  the first test repeats
+        one polygon, the second shifts it on every query so the covering can't be reused.
+    */
+    class GeoWithinPolygon : public B {
+    public:
+        virtual string name() { return "geo-within-repeated-polygon"; }
+        void prep() {
+            client()->ensureIndex( ns(), BSON( "loc" << "2dsphere" ) );
+            for ( int x = 0; x < 100; x++ ) {
+                client()->insert( ns(), BSON( "_id" << x << "loc" <<
+                                              BSON_ARRAY( ( x % 10 ) * 0.1 << ( x / 10 ) * 0.1 ) ) );
+            }
+            _shift = 0;
+        }
+        static BSONObj polygonQuery( double shift ) {
+            const int nVertices = 200;
+            BSONArrayBuilder ring;
+            for ( int i = 0; i < nVertices; i++ ) {
+                // a star, so that the covering needs many cells
+                double angle = 2 * 3.14159265358979 * i / nVertices;
+                double radius = ( i % 2 ) ? 1.0 : 0.6;
+                ring.append( BSON_ARRAY( shift + 0.5 + radius * cos( angle ) <<
+                                         0.5 + radius * sin( angle ) ) );
+            }
+            ring.append( BSON_ARRAY( shift + 0.5 + 0.6 << 0.5 ) );
+            BSONObj geometry = BSON( "type" << "Polygon" <<
+                                     "coordinates" << BSON_ARRAY( ring.arr() ) );
+            return BSON( "loc" << BSON( "$geoWithin" << BSON( "$geometry" << geometry ) ) );
+        }
+        void timed() {
+            client()->findOne( ns(), polygonQuery( 0 ) );
+        }
+        virtual string name2() { return "geo-within-distinct-polygon"; }
+        virtual void timed2(DBClientBase* c) {
+            c->findOne( ns(), polygonQuery( ( ++_shift % 1000 ) * 0.0001 ) );
+        }
+    private:
+        unsigned _shift;
+    };
+
+    class GeoNearClustered : public B {
+    public:
+        virtual string name() { return "geo-near-dense"; }
+        void prep() {
+            client()->ensureIndex( ns(), BSON( "loc" << "2dsphere" ) );
+            // a tight cluster of points around the origin and a sparse grid far away from it
+            for ( int x = 0; x < 10000; x++ ) {
+                client()->insert( ns(), BSON( "_id" << x << "loc" <<
+                                              BSON_ARRAY( ( x % 100 ) * 0.00001 <<
+                                                          ( x / 100 ) * 0.00001 ) ) );
+            }
+            for ( int x = 0; x < 100; x++ ) {
+                client()->insert( ns(), BSON( "_id" << 10000 + x << "loc" <<
+                                              BSON_ARRAY( 50 + ( x % 10 ) << 30 + ( x / 10 ) ) ) );
+            }
+        }
+        static BSONObj nearQuery( double lng, double lat ) {
+            BSONObj point = BSON( "type" << "Point" << "coordinates" << BSON_ARRAY( lng << lat ) );
+            return BSON( "loc" << BSON( "$near" << BSON( "$geometry" << point ) ) );
+        }
+        void timed() {
+            auto_ptr<DBClientCursor> c = client()->query( ns(), nearQuery( 0, 0 ), 10 );
+            while ( c->more() ) c->next();
+        }
+        virtual string name2() { return "geo-near-sparse"; }
+        virtual void timed2(DBClientBase* c) {
+            auto_ptr<DBClientCursor> cursor = c->query( ns(), nearQuery( 55, 35 ), 10 );
+            while ( cursor->more() ) cursor->next();
+        }
+    };
+
+    // $unwind of a large array straight into a $group, first fused into the group with the
+    // $match filtering array elements in place, then with a $skip in the way of both.
+    class AggregateUnwindGroup : public B {
+    public:
+        virtual string name() { return "aggregate-unwind-group-fused"; }
+        virtual int howLongMillis() { return 3000; }
+        void prep() {
+            for ( int x = 0; x < 100; x++ ) {
+                BSONArrayBuilder items;
+                for ( int i = 0; i < 1000; i++ ) {
+                    items.append( BSON( "sku" << ( i % 50 ) << "qty" << ( ( x + i ) % 10 ) ) );
+                }
+                client()->insert( ns(), BSON( "_id" << x << "items" << items.arr() ) );
+            }
+        }
+        BSONObj command( bool fused ) {
+            BSONArrayBuilder pipeline;
+            pipeline.append( BSON( "$unwind" << "$items" ) );
+            if ( !fused ) {
+                pipeline.append( BSON( "$skip" << 0 ) );
+            }
+            pipeline.append( BSON( "$match" << BSON( "items.qty" << BSON( "$gte" << 5 ) ) ) );
+            pipeline.append( BSON( "$group" << BSON( "_id" << "$items.sku" <<
+                                                     "total" << BSON( "$sum" << "$items.qty" ) ) ) );
+            return BSON( "aggregate" << nsToCollectionSubstring( ns() ) <<
+                         "pipeline" << pipeline.arr() );
+        }
+        void timed() {
+            BSONObj info;
+            verify( client()->runCommand( "perftest", command( true ), info ) );
+        }
+        virtual string name2() { return "aggregate-unwind-group-unfused"; }
+        virtual void timed2(DBClientBase* c) {
+            BSONObj info;
+            verify( c->runCommand( "perftest", command( false ), info ) );
+        }
+    };
+
     template <typename T>
     class MoreIndexes : public T {
     public:
@@ -1359,6 +1735,13 @@ namespace PerfTests {
                 add< BSONIter >();
                 add< BSONGetFields1 >();
                 add< BSONGetFields2 >();
+                add< BSONValidateWide >();
+                add< BSONValidateLargeValues >();
+                add< BSONValidateNested >();
+                add< BSONGetFieldWide >();
+                add< BSONFieldIndexWide >();
+                add< LogAppenderSync >();
+                add< LogAppenderAsync >();
                 //add< TaskQueueTest >();
                 add< InsertDup >();
                 add< Insert1 >();
@@ -1366,6 +1749,13 @@ namespace PerfTests {
                 add< MoreIndexes<InsertRandom> >();
                 add< Update1 >();
                 add< MoreIndexes<Update1> >();
+                add< UpdateUnindexedField >();
+                add< UpdateLargeDocInPlace >();
+                add< TextSearchTopK >();
+                add< InsertTextIndexed >();
+                add< GeoWithinPolygon >();
+                add< GeoNearClustered >();
+                add< AggregateUnwindGroup >();
                 add< InsertBig >();
                 add< FailPointTest<false, false> >();
                 add< FailPointTest<true, false> >();
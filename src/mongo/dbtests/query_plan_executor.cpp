@@ -26,6 +26,8 @@
  *    then also delete it in the license file.
  */
 
+#include <boost/thread/thread.hpp>
+
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/database.h"
@@ -43,6 +45,8 @@
 #include "mongo/db/query/plan_executor.h"
 #include "mongo/db/query/query_solution.h"
 #include "mongo/dbtests/dbtests.h"
+#include "mongo/platform/random.h"
+#include "mongo/stdx/functional.h"
 
 namespace QueryPlanExecutor {
 
@@ -484,7 +488,116 @@ namespace QueryPlanExecutor {
                 ASSERT_EQUALS(1U, numCursors());
                 CollectionCursorCache::timeoutCursorsGlobal(&_txn, 600001);
                 ASSERT_EQUALS(0U, numCursors());
+
+                // A cursor opened after the others timed out gets a full timeout of its own.
+                {
+                    AutoGetCollectionForRead ctx(&_txn, ns());
+                    Collection* collection = ctx.getCollection();
+                    BSONObj filterObj = fromjson("{b: {$gt: 0}}");
+                    PlanExecutor* exec = makeCollScanExec(collection, filterObj);
+                    new ClientCursor(collection, exec, 0, BSONObj());
+                }
+                ASSERT_EQUALS(1U, numCursors());
+                CollectionCursorCache::timeoutCursorsGlobal(&_txn, 590000);
+                ASSERT_EQUALS(1U, numCursors());
+                CollectionCursorCache::timeoutCursorsGlobal(&_txn, 11000);
+                ASSERT_EQUALS(0U, numCursors());
+            }
+        };
+
+        /**
+         * Run getMores, kills and timeouts on the same cursors from several threads at once,
+         * and check that every cursor goes away exactly once.
+         */
+        class ConcurrentPinKillTimeout : public PlanExecutorBase {
+        public:
+            ConcurrentPinKillTimeout() : _collection(NULL), _killed(0), _timedOut(0) {}
+
+            void run() {
+                {
+                    Client::WriteContext ctx(&_txn, ns());
+                    insert(BSON("a" << 1));
+                    ctx.commit();
+                }
+
+                // The threads below act as if they shared this lock, as their counterparts in
+                // the server would each hold it.
+                AutoGetCollectionForRead ctx(&_txn, ns());
+                _collection = ctx.getCollection();
+
+                BSONObj filterObj = fromjson("{a: {$gt: 0}}");
+                for (int i = 0; i < kNumCursors; ++i) {
+                    PlanExecutor* exec = makeCollScanExec(_collection, filterObj);
+                    _ids.push_back((new ClientCursor(_collection, exec))->cursorid());
+                }
+                ASSERT_EQUALS(_ids.size(), numCursors());
+
+                boost::thread_group threads;
+                for (int i = 0; i < 4; ++i) {
+                    threads.create_thread(
+                        stdx::bind(&ConcurrentPinKillTimeout::getMores, this, i));
+                }
+                threads.create_thread(stdx::bind(&ConcurrentPinKillTimeout::kills, this));
+                threads.create_thread(stdx::bind(&ConcurrentPinKillTimeout::timeouts, this));
+                threads.join_all();
+
+                // Once nobody is using them, the rest time out.
+                _timedOut += _collection->cursorCache()->timeoutCursors(
+                        CollectionCursorCache::kIdleTimeoutMillis);
+                ASSERT_EQUALS(0U, _collection->cursorCache()->numCursors());
+                ASSERT_EQUALS(_ids.size(), static_cast<size_t>(_killed + _timedOut));
+                ASSERT_GREATER_THAN(_killed, 0);
+                ASSERT_GREATER_THAN(_timedOut, 0);
             }
+
+        private:
+            static const int kNumCursors = 1000;
+            static const int kIterations = 20000;
+
+            void getMores(int seed) {
+                PseudoRandom random(seed);
+                for (int i = 0; i < kIterations; ++i) {
+                    // Favor the first half of the cursors, so that the rest go idle.
+                    const size_t index =
+                        static_cast<unsigned>(random.nextInt32()) % (kNumCursors / 2);
+                    try {
+                        ClientCursorPin pin(_collection, _ids[index]);
+                        if (pin.c())
+                            pin.c()->incPos(1);
+                    }
+                    catch (const UserException&) {
+                        // Another thread has it pinned.
+                    }
+                }
+            }
+
+            void kills() {
+                for (size_t i = 0; i < _ids.size(); i += 3) {
+                    while (true) {
+                        try {
+                            if (_collection->cursorCache()->eraseCursor(NULL, _ids[i], false))
+                                ++_killed;
+                            break;
+                        }
+                        catch (const MsgAssertionException&) {
+                            // A getMore has it pinned, try again.
+                        }
+                    }
+                }
+            }
+
+            void timeouts() {
+                for (int i = 0; i < 200; ++i) {
+                    _timedOut += _collection->cursorCache()->timeoutCursors(
+                            CollectionCursorCache::kIdleTimeoutMillis / 100);
+                    sleepmillis(1);
+                }
+            }
+
+            Collection* _collection;
+            std::vector<CursorId> _ids;
+            int _killed;
+            int _timedOut;
         };
 
     } // namespace ClientCursor
@@ -502,6 +615,7 @@ namespace QueryPlanExecutor {
             add<ClientCursor::Invalidate>();
             add<ClientCursor::InvalidatePinned>();
             add<ClientCursor::Timeout>();
+            add<ClientCursor::ConcurrentPinKillTimeout>();
         }
     }  queryPlanExecutorAll;
 
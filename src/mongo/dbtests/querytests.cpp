@@ -1482,14 +1482,21 @@ namespace QueryTests {
             ASSERT( c->more() );
             long long cursorId = c->getCursorId();
             
-            ClientCursor *clientCursor = 0;
+            AutoGetCollectionForRead ctx(&_txn, ns());
+            CollectionCursorCache* cursorCache = ctx.getCollection()->cursorCache();
             {
-                AutoGetCollectionForRead ctx(&_txn, ns());
                 ClientCursorPin clientCursorPointer(ctx.getCollection(), cursorId);
-                clientCursor = clientCursorPointer.c();
+                ASSERT( clientCursorPointer.c() );
+                // While pinned, the cursor doesn't time out.
+                ASSERT_EQUALS( 0U, cursorCache->timeoutCursors( 600001 ) );
                 // clientCursorPointer destructor unpins the cursor.
             }
-            ASSERT( clientCursor->shouldTimeout( 600001 ) );
+
+            // Unpinning restarts the cursor's idle timeout.
+            ASSERT_EQUALS( 0U, cursorCache->timeoutCursors( 599000 ) );
+            ASSERT( cursorCache->find( cursorId, false ) );
+            ASSERT_EQUALS( 1U, cursorCache->timeoutCursors( 2000 ) );
+            ASSERT( !cursorCache->find( cursorId, false ) );
         }
     };
 
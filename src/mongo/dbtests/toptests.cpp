@@ -0,0 +1,258 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "mongo/db/concurrency/lock_state.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/stats/top.h"
+#include "mongo/dbtests/dbtests.h"
+#include "mongo/util/net/message.h"
+
+namespace TopTests {
+
+    long long totalCount( Top& top, const std::string& ns ) {
+        Top::UsageMap usage;
+        top.cloneMap( usage );
+        Top::UsageMap::const_iterator it = usage.find( ns );
+        return it == usage.end() ? 0 : it->second.total.count;
+    }
+
+    void recordQueries( Top* top, const std::string& ns, int n ) {
+        for ( int i = 0; i < n; i++ )
+            top->record( ns, dbQuery, -1, 2, false );
+    }
+
+    /** Usage recorded by several threads is summed when it is read. */
+    class MergesThreads {
+    public:
+        void run() {
+            Top top;
+            boost::thread_group threads;
+            for ( int i = 0; i < 4; i++ )
+                threads.create_thread( boost::bind( recordQueries, &top, "top.a", 100 ) );
+            threads.join_all();
+            recordQueries( &top, "top.a", 10 );
+            recordQueries( &top, "top.b", 1 );
+
+            Top::UsageMap usage;
+            top.cloneMap( usage );
+            ASSERT_EQUALS( 410, usage["top.a"].total.count );
+            ASSERT_EQUALS( 820, usage["top.a"].total.time );
+            ASSERT_EQUALS( 410, usage["top.a"].queries.count );
+            ASSERT_EQUALS( 410, usage["top.a"].readLock.count );
+            ASSERT_EQUALS( 0, usage["top.a"].writeLock.count );
+            ASSERT_EQUALS( 1, usage["top.b"].total.count );
+            ASSERT_EQUALS( 411, top.getGlobalData().total.count );
+
+            // Reading again doesn't count anything twice.
+            recordQueries( &top, "top.a", 1 );
+            ASSERT_EQUALS( 411, totalCount( top, "top.a" ) );
+            ASSERT_EQUALS( 412, top.getGlobalData().total.count );
+        }
+    };
+
+    /** A dropped collection is forgotten, and the drop command itself isn't recorded. */
+    class CollectionDropped {
+    public:
+        void run() {
+            Top top;
+            boost::thread other( boost::bind( recordQueries, &top, "top.a", 5 ) );
+            other.join();
+            recordQueries( &top, "top.a", 5 );
+
+            top.collectionDropped( "top.a" );
+            ASSERT_EQUALS( 0, totalCount( top, "top.a" ) );
+
+            top.record( "top.a", dbQuery, -1, 1, true );
+            ASSERT_EQUALS( 0, totalCount( top, "top.a" ) );
+            top.record( "top.a", dbQuery, -1, 1, true );
+            ASSERT_EQUALS( 1, totalCount( top, "top.a" ) );
+        }
+    };
+
+    void recordOps( Top* top, const std::string& ns ) {
+        for ( int i = 1; i <= 100; i++ ) {
+            top->record( ns, dbQuery, -1, i, false );
+            top->record( ns, dbInsert, 1, 1000, false );
+        }
+        top->record( ns, dbQuery, -1, 5, true );
+        top->record( ns, dbGetMore, -1, 7, false );
+        top->record( ns, dbKillCursors, -1, 9, false );
+    }
+
+    /** Latencies are kept per type of operation, per collection and overall. */
+    class LatencyHistograms {
+    public:
+        void run() {
+            Top top;
+            boost::thread other( boost::bind( recordOps, &top, "top.a" ) );
+            other.join();
+            recordOps( &top, "top.b" );
+
+            BSONObjBuilder builder;
+            top.appendLatencyStats( true, false, &builder );
+            BSONObj stats = builder.obj();
+
+            BSONObj global = stats["global"].Obj();
+            ASSERT_EQUALS( 200, global["reads"]["ops"].numberLong() );
+            ASSERT_EQUALS( 2 * 5050, global["reads"]["latency"].numberLong() );
+            ASSERT_EQUALS( 100, global["reads"]["max"].numberLong() );
+            ASSERT_EQUALS( 200, global["writes"]["ops"].numberLong() );
+            ASSERT_EQUALS( 1000, global["writes"]["max"].numberLong() );
+            ASSERT_EQUALS( 2, global["commands"]["ops"].numberLong() );
+            ASSERT_EQUALS( 2, global["getMores"]["ops"].numberLong() );
+            ASSERT_FALSE( global["reads"].Obj().hasField( "histogram" ) );
+
+            BSONObj a = stats["namespaces"]["top.a"].Obj();
+            ASSERT_EQUALS( 100, a["reads"]["ops"].numberLong() );
+            long long p50 = a["reads"]["p50"].numberLong();
+            ASSERT_GREATER_THAN_OR_EQUALS( p50, 50 );
+            ASSERT_LESS_THAN_OR_EQUALS( p50, 56 );
+
+            top.collectionDropped( "top.a" );
+            BSONObjBuilder afterDrop;
+            top.appendLatencyStats( true, true, &afterDrop );
+            stats = afterDrop.obj();
+            ASSERT_FALSE( stats["namespaces"].Obj().hasField( "top.a" ) );
+            ASSERT( stats["namespaces"].Obj().hasField( "top.b" ) );
+            ASSERT( stats["global"]["reads"].Obj().hasField( "histogram" ) );
+        }
+    };
+
+    /** A thread that records many latencies without anyone reading them merges them itself. */
+    class LatenciesDontPileUp {
+    public:
+        void run() {
+            Top top;
+            for ( int i = 0; i < 10000; i++ ) {
+                top.record( "top.a", dbQuery, -1, 1, false );
+            }
+            ASSERT_EQUALS( 10000U, top.getGlobalLatencyData().histograms[Top::kReads].count() );
+        }
+    };
+
+    /** Operations' resource usage is summed per collection and shown by the top command. */
+    class ResourceTotals {
+    public:
+        void run() {
+            Top top;
+            mongo::ResourceTotals op;
+            op.cpuMicros = 5;
+            op.docBytesRead = 100;
+            op.docBytesWritten = 10;
+            op.lockWaitMicros[RESOURCE_DATABASE] = 7;
+            top.recordResources( "top.a", op );
+            top.recordResources( "top.a", op );
+            top.recordResources( "top.b", op );
+
+            Top::UsageMap usage;
+            top.cloneMap( usage );
+            ASSERT_EQUALS( 10, usage["top.a"].resources.cpuMicros );
+            ASSERT_EQUALS( 200, usage["top.a"].resources.docBytesRead );
+            ASSERT_EQUALS( 20, usage["top.a"].resources.docBytesWritten );
+            ASSERT_EQUALS( 14, usage["top.a"].resources.lockWaitMicros[RESOURCE_DATABASE] );
+            ASSERT_EQUALS( 0, usage["top.a"].resources.lockWaitMicros[RESOURCE_COLLECTION] );
+            ASSERT_EQUALS( 300, top.getGlobalData().resources.docBytesRead );
+
+            BSONObjBuilder b;
+            top.append( b );
+            BSONObj resources = b.obj()["top.a"]["resources"].Obj();
+            ASSERT_EQUALS( 200, resources["docBytesRead"].numberLong() );
+            ASSERT_EQUALS( 14, resources["lockWaitMicros"]["Database"].numberLong() );
+            ASSERT( resources["lockWaitMicros"]["Collection"].eoo() );
+        }
+    };
+
+    /** A nested operation's usage is part of its parent's, but only recorded in Top once. */
+    class NestedResources {
+    public:
+        void run() {
+            const ResourceId resId( RESOURCE_COLLECTION, std::string( "top.nestedResources" ) );
+
+            // 'holder' keeps the collection locked, so that 'locker' has a lock wait to count.
+            LockerImpl holder;
+            ASSERT( LOCK_OK == holder.lockGlobal( MODE_IX ) );
+            ASSERT( LOCK_OK == holder.lock( resId, MODE_X ) );
+            LockerImpl locker;
+            ASSERT( LOCK_OK == locker.lockGlobal( MODE_IX ) );
+
+            OperationResources parent;
+            parent.startLockWaits( locker );
+            parent.recordDocBytesRead( 10 );
+            long long nestedWaitMicros;
+            {
+                OperationResources nested;
+                nested.startLockWaits( locker );
+                nested.recordDocBytesRead( 100 );
+                nested.recordDocBytesWritten( 50 );
+                ASSERT( LOCK_TIMEOUT == locker.lock( resId, MODE_S, 10 ) );
+                nested.finishLockWaits( locker );
+                nestedWaitMicros = nested.totals().lockWaitMicros[RESOURCE_COLLECTION];
+                parent.addNested( nested );
+            }
+            parent.recordDocBytesWritten( 1 );
+            parent.finishLockWaits( locker );
+
+            locker.unlockAll();
+            holder.unlockAll();
+
+            ASSERT_GREATER_THAN( nestedWaitMicros, 0 );
+
+            mongo::ResourceTotals all = parent.totals();
+            ASSERT_EQUALS( 110, all.docBytesRead );
+            ASSERT_EQUALS( 51, all.docBytesWritten );
+            ASSERT_EQUALS( nestedWaitMicros, all.lockWaitMicros[RESOURCE_COLLECTION] );
+
+            mongo::ResourceTotals own = parent.ownTotals();
+            ASSERT_EQUALS( 10, own.docBytesRead );
+            ASSERT_EQUALS( 1, own.docBytesWritten );
+            ASSERT_EQUALS( 0, own.lockWaitMicros[RESOURCE_COLLECTION] );
+            ASSERT_LESS_THAN_OR_EQUALS( own.cpuMicros, all.cpuMicros );
+        }
+    };
+
+    class All : public Suite {
+    public:
+        All() : Suite( "top" ) {
+        }
+
+        void setupTests() {
+            add<MergesThreads>();
+            add<CollectionDropped>();
+            add<LatencyHistograms>();
+            add<LatenciesDontPileUp>();
+            add<ResourceTotals>();
+            add<NestedResources>();
+        }
+    } myall;
+
+} // namespace TopTests
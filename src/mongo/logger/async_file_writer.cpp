@@ -0,0 +1,216 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/logger/async_file_writer.h"
+
+#include <algorithm>
+#include <boost/thread/thread.hpp>
+#include <cstring>
+#include <set>
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <signal.h>
+#endif
+
+#include "mongo/logger/rotatable_file_writer.h"
+#include "mongo/stdx/functional.h"
+
+namespace mongo {
+namespace logger {
+
+    namespace {
+        boost::mutex allWritersMutex;
+        std::set<AsyncFileWriter*> allWriters;
+    }  // namespace
+
+    AsyncFileWriter::AsyncFileWriter(RotatableFileWriter* writer,
+                                     size_t bufferSize,
+                                     OverflowPolicy policy) :
+        _writer(writer),
+        _policy(policy),
+        _buffer(bufferSize),
+        _head(0),
+        _tail(0),
+        _dropped(0),
+        _droppedReported(0),
+        _lastStatus(Status::OK()),
+        _shutdown(false) {
+
+        _thread.reset(new boost::thread(stdx::bind(&AsyncFileWriter::_run, this)));
+
+        boost::lock_guard<boost::mutex> lk(allWritersMutex);
+        allWriters.insert(this);
+    }
+
+    AsyncFileWriter::~AsyncFileWriter() {
+        {
+            boost::lock_guard<boost::mutex> lk(allWritersMutex);
+            allWriters.erase(this);
+        }
+        {
+            boost::lock_guard<boost::mutex> lk(_mutex);
+            _shutdown = true;
+            _dataAvailable.notify_one();
+        }
+        _thread->join();
+    }
+
+    Status AsyncFileWriter::write(const StringData& data) {
+        boost::unique_lock<boost::mutex> lk(_mutex);
+
+        if (data.size() > _buffer.size()) {
+            if (_policy == kDrop) {
+                _dropped++;
+                return _lastStatus;
+            }
+            while (_head != _tail) {
+                _progress.wait(lk);
+            }
+            lk.unlock();
+
+            RotatableFileWriter::Use useWriter(_writer);
+            Status status = useWriter.status();
+            if (!status.isOK())
+                return status;
+            useWriter.stream().write(data.rawData(), data.size());
+            useWriter.stream().flush();
+            return useWriter.status();
+        }
+
+        while (_tail - _head + data.size() > _buffer.size()) {
+            if (_policy == kDrop) {
+                _dropped++;
+                return _lastStatus;
+            }
+            _progress.wait(lk);
+        }
+
+        _copyIn_inlock(data);
+        _dataAvailable.notify_one();
+        return _lastStatus;
+    }
+
+    void AsyncFileWriter::_copyIn_inlock(const StringData& data) {
+        const size_t start = _tail % _buffer.size();
+        const size_t first = std::min(data.size(), _buffer.size() - start);
+        std::memcpy(&_buffer[start], data.rawData(), first);
+        std::memcpy(&_buffer[0], data.rawData() + first, data.size() - first);
+        _tail += data.size();
+    }
+
+    Status AsyncFileWriter::flush() {
+        boost::unique_lock<boost::mutex> lk(_mutex);
+        const uint64_t target = _tail;
+        while (_head < target) {
+            _progress.wait(lk);
+        }
+        return _lastStatus;
+    }
+
+    uint64_t AsyncFileWriter::droppedCount() const {
+        boost::lock_guard<boost::mutex> lk(_mutex);
+        return _dropped;
+    }
+
+    void AsyncFileWriter::flushAll() {
+        boost::lock_guard<boost::mutex> lk(allWritersMutex);
+        for (std::set<AsyncFileWriter*>::const_iterator it = allWriters.begin();
+             it != allWriters.end();
+             ++it) {
+            (*it)->flush();
+        }
+    }
+
+    void AsyncFileWriter::_run() {
+#ifndef _WIN32
+        // The writer is started while the server sets up logging, before the signal processing
+        // thread exists, so it doesn't inherit the mask that steers the asynchronous signals to
+        // that thread (see setupSignalHandlers()).  Block them here, or one of them could be
+        // delivered to this thread and take its default action.
+        sigset_t asyncSignals;
+        sigemptyset(&asyncSignals);
+        sigaddset(&asyncSignals, SIGHUP);
+        sigaddset(&asyncSignals, SIGINT);
+        sigaddset(&asyncSignals, SIGTERM);
+        sigaddset(&asyncSignals, SIGQUIT);
+        sigaddset(&asyncSignals, SIGUSR1);
+        sigaddset(&asyncSignals, SIGXCPU);
+        pthread_sigmask(SIG_BLOCK, &asyncSignals, NULL);
+#endif
+
+        while (true) {
+            uint64_t head;
+            uint64_t tail;
+            uint64_t newlyDropped;
+            {
+                boost::unique_lock<boost::mutex> lk(_mutex);
+                while (_head == _tail && !_shutdown) {
+                    _dataAvailable.wait(lk);
+                }
+                if (_head == _tail) {
+                    return;
+                }
+                head = _head;
+                tail = _tail;
+                newlyDropped = _dropped - _droppedReported;
+                _droppedReported = _dropped;
+            }
+
+            // Writers only append at _tail, and never past _head + the buffer size, so
+            // [head, tail) stays put while it is written without the lock.
+            Status status = Status::OK();
+            {
+                RotatableFileWriter::Use useWriter(_writer);
+                status = useWriter.status();
+                if (status.isOK()) {
+                    const size_t start = head % _buffer.size();
+                    const size_t length = tail - head;
+                    const size_t first = std::min(length, _buffer.size() - start);
+                    useWriter.stream().write(&_buffer[start], first);
+                    useWriter.stream().write(&_buffer[0], length - first);
+                    if (newlyDropped) {
+                        useWriter.stream() << "*** " << newlyDropped << " log messages dropped"
+                                           << " because the log buffer was full ***\n";
+                    }
+                    useWriter.stream().flush();
+                    status = useWriter.status();
+                }
+            }
+
+            boost::lock_guard<boost::mutex> lk(_mutex);
+            _head = tail;
+            _lastStatus = status;
+            _progress.notify_all();
+        }
+    }
+
+}  // namespace logger
+}  // namespace mongo
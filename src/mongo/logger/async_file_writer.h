@@ -0,0 +1,125 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/base/string_data.h"
+#include "mongo/platform/cstdint.h"
+
+namespace boost {
+    class thread;
+}  // namespace boost
+
+namespace mongo {
+namespace logger {
+
+    class RotatableFileWriter;
+
+    /**
+     * Buffers already encoded log output and writes it to a RotatableFileWriter from a
+     * background thread, so that threads that log don't wait on the log file.
+     *
+     * Output is copied into a fixed size ring buffer.  The background thread writes everything
+     * buffered so far in one go, outside the buffer's lock, while other threads keep appending.
+     * When the buffer is full, write() either waits for the background thread (kBlock) or drops
+     * the output and counts it (kDrop); the number of dropped writes is noted in the log once
+     * there is room again.
+     */
+    class AsyncFileWriter {
+        MONGO_DISALLOW_COPYING(AsyncFileWriter);
+    public:
+        enum OverflowPolicy {
+            kBlock,
+            kDrop
+        };
+
+        /**
+         * Starts a writer with a 'bufferSize' byte buffer, that writes to 'writer'.  The caller
+         * must keep 'writer' alive at least as long as this object.
+         */
+        AsyncFileWriter(RotatableFileWriter* writer, size_t bufferSize, OverflowPolicy policy);
+
+        /** Writes out everything buffered, and stops the background thread. */
+        ~AsyncFileWriter();
+
+        /**
+         * Queues 'data' to be written.  Returns the status of the last write the background
+         * thread made; dropping 'data' because the buffer is full is not an error.
+         *
+         * Output larger than the whole buffer is written directly, once everything before it has
+         * been written, under kBlock, and dropped and counted under kDrop.
+         */
+        Status write(const StringData& data);
+
+        /** Waits until everything queued before the call has been written. */
+        Status flush();
+
+        /** The number of writes dropped because the buffer was full. */
+        uint64_t droppedCount() const;
+
+        /** Flushes every AsyncFileWriter in the process.  Call before exiting. */
+        static void flushAll();
+
+    private:
+        void _run();
+
+        /** Copies 'data' into the ring at _tail; the caller has checked that it fits. */
+        void _copyIn_inlock(const StringData& data);
+
+        RotatableFileWriter* const _writer;
+        const OverflowPolicy _policy;
+
+        mutable boost::mutex _mutex;
+        boost::condition_variable _dataAvailable;
+        boost::condition_variable _progress;  // _head moved, or a direct write finished
+
+        std::vector<char> _buffer;
+
+        // Total bytes written out (_head) and buffered (_tail) since construction; the buffered
+        // bytes not yet written out are at positions [_head, _tail) modulo the buffer size.
+        uint64_t _head;
+        uint64_t _tail;
+
+        uint64_t _dropped;
+        uint64_t _droppedReported;
+        Status _lastStatus;
+        bool _shutdown;
+
+        boost::scoped_ptr<boost::thread> _thread;
+    };
+
+}  // namespace logger
+}  // namespace mongo
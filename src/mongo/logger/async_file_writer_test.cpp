@@ -0,0 +1,165 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <fstream>
+#include <sstream>
+
+#include "mongo/logger/async_file_writer.h"
+#include "mongo/logger/rotatable_file_writer.h"
+#include "mongo/unittest/unittest.h"
+
+namespace {
+    using namespace mongo;
+    using namespace mongo::logger;
+
+    const std::string logFileName("LogTest_AsyncFileWriter.txt");
+
+    class AsyncFileWriterTest : public mongo::unittest::Test {
+    public:
+        AsyncFileWriterTest() {
+            unlink(logFileName.c_str());
+            RotatableFileWriter::Use writerUse(&_fileWriter);
+            ASSERT_OK(writerUse.setFileName(logFileName, false));
+        }
+
+        virtual ~AsyncFileWriterTest() {
+            unlink(logFileName.c_str());
+        }
+
+    protected:
+        std::string contents() {
+            std::ifstream ifs(logFileName.c_str());
+            std::ostringstream os;
+            os << ifs.rdbuf();
+            return os.str();
+        }
+
+        RotatableFileWriter _fileWriter;
+    };
+
+    TEST_F(AsyncFileWriterTest, WritesInOrder) {
+        AsyncFileWriter writer(&_fileWriter, 1024, AsyncFileWriter::kBlock);
+        std::string expected;
+        for (int i = 0; i < 100; ++i) {
+            std::ostringstream line;
+            line << "message " << i << '\n';
+            expected += line.str();
+            ASSERT_OK(writer.write(line.str()));
+        }
+        ASSERT_OK(writer.flush());
+        ASSERT_EQUALS(expected, contents());
+        ASSERT_EQUALS(0U, writer.droppedCount());
+    }
+
+    TEST_F(AsyncFileWriterTest, WrapsAroundBuffer) {
+        // Lines don't divide the buffer evenly, so they straddle the end of the ring.
+        AsyncFileWriter writer(&_fileWriter, 17, AsyncFileWriter::kBlock);
+        std::string expected;
+        for (int i = 0; i < 50; ++i) {
+            ASSERT_OK(writer.write("abcdefghijk\n"));
+            expected += "abcdefghijk\n";
+        }
+        ASSERT_OK(writer.flush());
+        ASSERT_EQUALS(expected, contents());
+    }
+
+    TEST_F(AsyncFileWriterTest, WritesLargerThanBufferGoDirectly) {
+        AsyncFileWriter writer(&_fileWriter, 8, AsyncFileWriter::kBlock);
+        const std::string big(100, 'x');
+        ASSERT_OK(writer.write("one\n"));
+        ASSERT_OK(writer.write(big));
+        ASSERT_OK(writer.write("two\n"));
+        ASSERT_OK(writer.flush());
+        ASSERT_EQUALS("one\n" + big + "two\n", contents());
+    }
+
+    TEST_F(AsyncFileWriterTest, DropPolicyDropsWritesLargerThanBuffer) {
+        AsyncFileWriter writer(&_fileWriter, 8, AsyncFileWriter::kDrop);
+        ASSERT_OK(writer.write("one\n"));
+        ASSERT_OK(writer.write(std::string(100, 'x')));
+        ASSERT_EQUALS(1U, writer.droppedCount());
+        ASSERT_OK(writer.write("two\n"));
+        ASSERT_OK(writer.flush());
+        const std::string written = contents();
+        ASSERT_EQUALS(std::string::npos, written.find('x'));
+        ASSERT_EQUALS(0U, written.find("one\n"));
+        ASSERT_NOT_EQUALS(std::string::npos, written.find("two\n"));
+    }
+
+    TEST_F(AsyncFileWriterTest, DestructorDrainsBuffer) {
+        {
+            AsyncFileWriter writer(&_fileWriter, 64, AsyncFileWriter::kBlock);
+            ASSERT_OK(writer.write("last words\n"));
+        }
+        ASSERT_EQUALS("last words\n", contents());
+    }
+
+    TEST_F(AsyncFileWriterTest, DropPolicyCountsDroppedWrites) {
+        AsyncFileWriter writer(&_fileWriter, 4, AsyncFileWriter::kDrop);
+
+        // Hold the file so the background thread can't drain the buffer.
+        {
+            RotatableFileWriter::Use writerUse(&_fileWriter);
+            ASSERT_OK(writer.write("abc\n"));
+            ASSERT_OK(writer.write("def\n"));
+            ASSERT_OK(writer.write("ghi\n"));
+        }
+        ASSERT_OK(writer.flush());
+
+        ASSERT_EQUALS(2U, writer.droppedCount());
+
+        ASSERT_OK(writer.write("jkl\n"));
+        ASSERT_OK(writer.flush());
+        const std::string written = contents();
+        ASSERT_EQUALS(0U, written.find("abc\n"));
+        ASSERT_NOT_EQUALS(std::string::npos, written.find("log messages dropped"));
+        ASSERT_NOT_EQUALS(std::string::npos, written.find("jkl\n"));
+    }
+
+    TEST_F(AsyncFileWriterTest, BlockPolicyNeverDrops) {
+        AsyncFileWriter writer(&_fileWriter, 4, AsyncFileWriter::kBlock);
+        std::string expected;
+        for (int i = 0; i < 200; ++i) {
+            ASSERT_OK(writer.write("abc\n"));
+            expected += "abc\n";
+        }
+        ASSERT_OK(writer.flush());
+        ASSERT_EQUALS(0U, writer.droppedCount());
+        ASSERT_EQUALS(expected, contents());
+    }
+
+    TEST_F(AsyncFileWriterTest, FlushAll) {
+        AsyncFileWriter writer(&_fileWriter, 64, AsyncFileWriter::kBlock);
+        ASSERT_OK(writer.write("flushed\n"));
+        AsyncFileWriter::flushAll();
+        ASSERT_EQUALS("flushed\n", contents());
+    }
+
+}  // namespace
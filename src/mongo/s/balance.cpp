@@ -32,9 +32,14 @@
 
 #include "mongo/s/balance.h"
 
+#include <boost/thread/thread.hpp>
+
 #include "mongo/base/owned_pointer_map.h"
+#include "mongo/base/owned_pointer_vector.h"
 #include "mongo/client/dbclientcursor.h"
+#include "mongo/db/client.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/write_concern.h"
 #include "mongo/db/write_concern_options.h"
 #include "mongo/s/chunk.h"
@@ -51,6 +56,7 @@
 #include "mongo/s/type_mongos.h"
 #include "mongo/s/type_settings.h"
 #include "mongo/s/type_tags.h"
+#include "mongo/stdx/functional.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 #include "mongo/util/timer.h"
@@ -60,6 +66,15 @@ namespace mongo {
 
     MONGO_FP_DECLARE(skipBalanceRound);
 
+    // Maximum number of migrations, from different collections, running at the same time.
+    MONGO_EXPORT_SERVER_PARAMETER(balancerMaxConcurrentMigrations, int, 1);
+
+    // Maximum number of migrations a shard takes part in, as donor or recipient, per round.
+    MONGO_EXPORT_SERVER_PARAMETER(balancerMaxMigrationsPerShard, int, 1);
+
+    // Maximum number of chunks of one collection moved per round.
+    MONGO_EXPORT_SERVER_PARAMETER(balancerMaxMigrationsPerCollection, int, 1);
+
     Balancer balancer;
 
     Balancer::Balancer() : _balancedLastTime(0), _policy( new BalancerPolicy() ) {}
@@ -67,12 +82,72 @@ namespace mongo {
     Balancer::~Balancer() {
     }
 
-    int Balancer::_moveChunks(const vector<CandidateChunkPtr>* candidateChunks,
+    int Balancer::_moveChunks(const vector<CandidateWave>* candidateWaves,
                               const WriteConcernOptions* writeConcern,
                               bool waitForDelete)
     {
         int movedCount = 0;
+        const size_t maxConcurrent = std::max(1, balancerMaxConcurrentMigrations);
+
+        for (vector<CandidateWave>::const_iterator wave = candidateWaves->begin();
+                wave != candidateWaves->end(); ++wave) {
+
+            // one group per collection, keeping the order chosen by the policy
+            map<string, size_t> groupForNs;
+            vector<CandidateWave> groups;
+            for (CandidateWave::const_iterator it = wave->begin(); it != wave->end(); ++it) {
+                map<string, size_t>::iterator g = groupForNs.find((*it)->ns);
+                if (g == groupForNs.end()) {
+                    g = groupForNs.insert(make_pair((*it)->ns, groups.size())).first;
+                    groups.push_back(CandidateWave());
+                }
+                groups[g->second].push_back(*it);
+            }
+
+            for (size_t first = 0; first < groups.size(); first += maxConcurrent) {
+                const size_t last = std::min(groups.size(), first + maxConcurrent);
+
+                if (last - first == 1) {
+                    _moveChunkGroup(&groups[first], writeConcern, waitForDelete, &movedCount);
+                    continue;
+                }
+
+                vector<int> moved(last - first, 0);
+                OwnedPointerVector<boost::thread> threads;
+                for (size_t i = first; i < last; i++) {
+                    threads.push_back(new boost::thread(stdx::bind(&Balancer::_moveChunkGroupThread,
+                                                                   this,
+                                                                   &groups[i],
+                                                                   writeConcern,
+                                                                   waitForDelete,
+                                                                   &moved[i - first])));
+                }
+
+                for (size_t i = 0; i < threads.size(); i++) {
+                    threads[i]->join();
+                    movedCount += moved[i];
+                }
+            }
+        }
+
+        return movedCount;
+    }
 
+    void Balancer::_moveChunkGroupThread(const vector<CandidateChunkPtr>* candidateChunks,
+                                         const WriteConcernOptions* writeConcern,
+                                         bool waitForDelete,
+                                         int* movedCount)
+    {
+        Client::initThread("BalancerMigrate");
+        _moveChunkGroup(candidateChunks, writeConcern, waitForDelete, movedCount);
+        cc().shutdown();
+    }
+
+    void Balancer::_moveChunkGroup(const vector<CandidateChunkPtr>* candidateChunks,
+                                   const WriteConcernOptions* writeConcern,
+                                   bool waitForDelete,
+                                   int* movedCount)
+    {
         for ( vector<CandidateChunkPtr>::const_iterator it = candidateChunks->begin(); it != candidateChunks->end(); ++it ) {
             const CandidateChunk& chunkInfo = *it->get();
 
@@ -109,7 +184,7 @@ namespace mongo {
                                      waitForDelete,
                                      0, /* maxTimeMS */
                                      res)) {
-                    movedCount++;
+                    (*movedCount)++;
                     continue;
                 }
 
@@ -132,7 +207,7 @@ namespace mongo {
                         log() << "marking chunk as jumbo: " << c->toString() << endl;
                         c->markAsJumbo();
                         // we increment moveCount so we do another round right away
-                        movedCount++;
+                        (*movedCount)++;
                     }
 
                 }
@@ -141,9 +216,12 @@ namespace mongo {
                 warning() << "could not move chunk " << chunkInfo.chunk.toString()
                           << ", continuing balancing round" << causedBy( ex ) << endl;
             }
+            catch( const std::exception& ex ) {
+                // may be running on a helper thread, where nobody else would catch this
+                warning() << "could not move chunk " << chunkInfo.chunk.toString()
+                          << ", continuing balancing round" << causedBy( ex ) << endl;
+            }
         }
-
-        return movedCount;
     }
 
     void Balancer::_ping( bool waiting ) {
@@ -299,8 +377,8 @@ namespace mongo {
         }        
     }
 
-    void Balancer::_doBalanceRound( DBClientBase& conn, vector<CandidateChunkPtr>* candidateChunks ) {
-        verify( candidateChunks );
+    void Balancer::_doBalanceRound( DBClientBase& conn, vector<CandidateWave>* candidateWaves ) {
+        verify( candidateWaves );
 
         //
         // 1. Check whether there is any sharded collection to be balanced by querying
@@ -357,6 +435,12 @@ namespace mongo {
 
         OCCASIONALLY warnOnMultiVersion( shardInfo );
 
+        // shards already used in each wave, by any collection
+        const size_t numWaves = std::max(1, balancerMaxMigrationsPerShard);
+        const unsigned maxPerCollection = std::max(1, balancerMaxMigrationsPerCollection);
+        vector< set<string> > waveShards( numWaves );
+        candidateWaves->resize( numWaves );
+
         //
         // 3. For each collection, check if the balancing policy recommends moving anything around.
         //
@@ -490,9 +574,29 @@ namespace mongo {
                 continue;
             }
 
-            CandidateChunk* p = _policy->balance( ns, status, _balancedLastTime );
-            if ( p ) candidateChunks->push_back( CandidateChunkPtr( p ) );
+            unsigned planned = 0;
+            for ( size_t w = 0; w < numWaves && planned < maxPerCollection; w++ ) {
+                status.clearBusyShards();
+                for ( set<string>::const_iterator s = waveShards[w].begin();
+                      s != waveShards[w].end();
+                      ++s ) {
+                    status.addBusyShard( *s );
+                }
+
+                vector<CandidateChunk*> migrations;
+                planned += _policy->balanceWave( ns, &status, _balancedLastTime, &migrations,
+                                                 maxPerCollection - planned );
+
+                for ( size_t i = 0; i < migrations.size(); i++ ) {
+                    waveShards[w].insert( migrations[i]->from );
+                    waveShards[w].insert( migrations[i]->to );
+                    (*candidateWaves)[w].push_back( CandidateChunkPtr( migrations[i] ) );
+                }
+            }
         }
+
+        while ( ! candidateWaves->empty() && candidateWaves->back().empty() )
+            candidateWaves->pop_back();
     }
 
     bool Balancer::_init() {
@@ -639,20 +743,25 @@ namespace mongo {
                            << (writeConcern.get() ? writeConcern->toBSON().toString() : "default")
                            << endl;
 
-                    vector<CandidateChunkPtr> candidateChunks;
-                    _doBalanceRound( conn.conn() , &candidateChunks );
-                    if ( candidateChunks.size() == 0 ) {
+                    vector<CandidateWave> candidateWaves;
+                    _doBalanceRound( conn.conn() , &candidateWaves );
+
+                    size_t numCandidateChunks = 0;
+                    for ( size_t i = 0; i < candidateWaves.size(); i++ )
+                        numCandidateChunks += candidateWaves[i].size();
+
+                    if ( numCandidateChunks == 0 ) {
                         LOG(1) << "no need to move any chunk" << endl;
                         _balancedLastTime = 0;
                     }
                     else {
-                        _balancedLastTime = _moveChunks(&candidateChunks,
+                        _balancedLastTime = _moveChunks(&candidateWaves,
                                                         writeConcern.get(),
                                                         waitForDelete );
                     }
 
                     actionLog.setDetails( _buildDetails( false, balanceRoundTimer.millis(),
-                        static_cast<int>(candidateChunks.size()), _balancedLastTime, "") );
+                        static_cast<int>(numCandidateChunks), _balancedLastTime, "") );
 
                     _reportRound( actionLog );
 
@@ -46,8 +46,14 @@ namespace mongo {
      * uses a 'DistributedLock' for that coordination.
      *
      * The balancer does act continuously but in "rounds". At a given round, it would decide if there is an imbalance by
-     * checking the difference in chunks between the most and least loaded shards. It would issue a request for a chunk
-     * migration per round, if it found so.
+     * checking the difference in chunks between the most and least loaded shards. It would issue requests for chunk
+     * migrations, if it found so.
+     *
+     * The migrations of a round are grouped in waves. Within a wave no shard is donor or recipient more than once, so
+     * the migrations of different collections can run in parallel (up to balancerMaxConcurrentMigrations at a time).
+     * The number of waves, balancerMaxMigrationsPerShard, bounds how many migrations a shard takes part in per round,
+     * and balancerMaxMigrationsPerCollection how many chunks of one collection move per round. Both default to 1, which
+     * moves at most one chunk per collection per round as the balancer always has.
      */
     class Balancer : public BackgroundJob {
     public:
@@ -63,6 +69,7 @@ namespace mongo {
     private:
         typedef MigrateInfo CandidateChunk;
         typedef shared_ptr<CandidateChunk> CandidateChunkPtr;
+        typedef std::vector<CandidateChunkPtr> CandidateWave;
 
         // hostname:port of my mongos
         std::string _myid;
@@ -90,22 +97,43 @@ namespace mongo {
          * be moved.
          *
          * @param conn is the connection with the config server(s)
-         * @param candidateChunks (IN/OUT) filled with candidate chunks, one per collection, that could possibly be moved
+         * @param candidateWaves (IN/OUT) filled with waves of candidate chunks that could possibly be moved; the
+         *        migrations of a wave have disjoint donor/recipient shards
          */
-        void _doBalanceRound( DBClientBase& conn, std::vector<CandidateChunkPtr>* candidateChunks );
+        void _doBalanceRound( DBClientBase& conn, std::vector<CandidateWave>* candidateWaves );
 
         /**
-         * Issues chunk migration request, one at a time.
+         * Issues the chunk migration requests of each wave, one wave after the other. Inside a wave, migrations of
+         * different collections run in parallel, while those of a single collection run one at a time since they
+         * contend for the collection's distributed lock.
          *
-         * @param candidateChunks possible chunks to move
+         * @param candidateWaves possible chunks to move
          * @param writeConcern detailed write concern. NULL means the default write concern.
          * @param waitForDelete wait for deletes to complete after each chunk move
          * @return number of chunks effectively moved
          */
-        int _moveChunks(const std::vector<CandidateChunkPtr>* candidateChunks,
+        int _moveChunks(const std::vector<CandidateWave>* candidateWaves,
                         const WriteConcernOptions* writeConcern,
                         bool waitForDelete);
 
+        /**
+         * Issues chunk migration requests, one at a time.
+         *
+         * @param movedCount (OUT) incremented by the number of chunks effectively moved
+         */
+        void _moveChunkGroup(const std::vector<CandidateChunkPtr>* candidateChunks,
+                             const WriteConcernOptions* writeConcern,
+                             bool waitForDelete,
+                             int* movedCount);
+
+        /**
+         * Runs _moveChunkGroup() on a helper thread, with the Client the migration code expects.
+         */
+        void _moveChunkGroupThread(const std::vector<CandidateChunkPtr>* candidateChunks,
+                                   const WriteConcernOptions* writeConcern,
+                                   bool waitForDelete,
+                                   int* movedCount);
+
         /**
          * Marks this balancer as being live on the config server(s).
          */
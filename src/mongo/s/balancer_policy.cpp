@@ -80,7 +80,17 @@ namespace mongo {
             return 0;
         }
 
-        return i->second->size();
+        int total = i->second->size();
+
+        map<string, map<string,int> >::const_iterator d = _plannedDelta.find(shard);
+        if (d != _plannedDelta.end()) {
+            for (map<string,int>::const_iterator j = d->second.begin();
+                    j != d->second.end(); ++j) {
+                total += j->second;
+            }
+        }
+
+        return total;
     }
 
     unsigned DistributionStatus::numberOfChunksInShardWithTag( const string& shard , const string& tag ) const {
@@ -97,9 +107,46 @@ namespace mongo {
             }
         }
 
+        map<string, map<string,int> >::const_iterator d = _plannedDelta.find(shard);
+        if (d != _plannedDelta.end()) {
+            map<string,int>::const_iterator j = d->second.find(tag);
+            if (j != d->second.end()) {
+                total += j->second;
+            }
+        }
+
         return total;
     }
 
+    void DistributionStatus::applyMigration( const MigrateInfo& migration ) {
+        ChunkType chunk;
+        chunk.setMin(migration.chunk.min);
+        const string tag = getTagForChunk(chunk);
+
+        _plannedChunks[migration.chunk.min] = tag;
+        _plannedDelta[migration.from][tag]--;
+        _plannedDelta[migration.to][tag]++;
+
+        _busyShards.insert(migration.from);
+        _busyShards.insert(migration.to);
+    }
+
+    bool DistributionStatus::isChunkPlanned( const ChunkType& chunk ) const {
+        return _plannedChunks.count(chunk.getMin()) > 0;
+    }
+
+    void DistributionStatus::addBusyShard( const string& shard ) {
+        _busyShards.insert(shard);
+    }
+
+    bool DistributionStatus::isShardBusy( const string& shard ) const {
+        return _busyShards.count(shard) > 0;
+    }
+
+    void DistributionStatus::clearBusyShards() {
+        _busyShards.clear();
+    }
+
     string DistributionStatus::getBestReceieverShard( const string& tag ) const {
         string best;
         unsigned minChunks = numeric_limits<unsigned>::max();
@@ -120,6 +167,11 @@ namespace mongo {
                 continue;
             }
 
+            if ( isShardBusy( i->first ) ) {
+                LOG(1) << i->first << " is already part of a planned migration" << endl;
+                continue;
+            }
+
             unsigned myChunks = numberOfChunksInShard( i->first );
             if ( myChunks >= minChunks ) {
                 LOG(1) << i->first << " has more chunks me:" << myChunks << " best: " << best << ":" << minChunks << endl;
@@ -138,6 +190,9 @@ namespace mongo {
         unsigned maxChunks = 0;
 
         for ( ShardInfoMap::const_iterator i = _shardInfo.begin(); i != _shardInfo.end(); ++i ) {
+            if ( isShardBusy( i->first ) )
+                continue;
+
             unsigned myChunks = numberOfChunksInShardWithTag( i->first, tag );
             if ( myChunks <= maxChunks )
                 continue;
@@ -331,6 +386,9 @@ namespace mongo {
                 if ( ! info.isDraining() )
                     continue;
 
+                if ( distribution.isShardBusy( shard ) )
+                    continue;
+
                 if ( distribution.numberOfChunksInShard( shard ) == 0 )
                     continue;
 
@@ -342,6 +400,9 @@ namespace mongo {
                 // since we have to move all chunks, lets just do in order
                 for ( unsigned i=0; i<chunks.size(); i++ ) {
                     const ChunkType& chunkToMove = *chunks[i];
+                    if (distribution.isChunkPlanned(chunkToMove))
+                        continue;
+
                     if (chunkToMove.isJumboSet() && chunkToMove.getJumbo()) {
                         numJumboChunks++;
                         continue;
@@ -381,9 +442,15 @@ namespace mongo {
                 string shard = *i;
                 const ShardInfo& info = distribution.shardInfo( shard );
 
+                if ( distribution.isShardBusy( shard ) )
+                    continue;
+
                 const vector<ChunkType *>& chunks = distribution.getChunks(shard);
                 for ( unsigned j = 0; j < chunks.size(); j++ ) {
                     const ChunkType& chunk = *chunks[j];
+                    if (distribution.isChunkPlanned(chunk))
+                        continue;
+
                     string tag = distribution.getTagForChunk(chunk);
 
                     if ( info.hasTag( tag ) )
@@ -467,6 +534,9 @@ namespace mongo {
                 if (distribution.getTagForChunk(chunk) != tag)
                     continue;
 
+                if (distribution.isChunkPlanned(chunk))
+                    continue;
+
                 if (chunk.isJumboSet() && chunk.getJumbo()) {
                     numJumboChunks++;
                     continue;
@@ -486,6 +556,10 @@ namespace mongo {
                 continue;
             }
 
+            // chunks planned to move onto 'from' are counted there but not listed yet
+            if ( distribution.hasPlannedMigrations() )
+                continue;
+
             verify( false ); // should be impossible
         }
 
@@ -493,6 +567,29 @@ namespace mongo {
         return NULL;
     }
 
+    unsigned BalancerPolicy::balanceWave( const string& ns,
+                                          DistributionStatus* distribution,
+                                          int balancedLastTime,
+                                          vector<MigrateInfo*>* migrations,
+                                          unsigned maxMigrations ) {
+        unsigned planned = 0;
+
+        while ( maxMigrations == 0 || planned < maxMigrations ) {
+            // once something is planned, use the same low threshold as a round that follows
+            // one that moved chunks
+            const bool movingChunks = balancedLastTime || distribution->hasPlannedMigrations();
+            MigrateInfo* m = balance( ns, *distribution, movingChunks );
+            if ( ! m )
+                break;
+
+            distribution->applyMigration( *m );
+            migrations->push_back( m );
+            planned++;
+        }
+
+        return planned;
+    }
+
 
     ShardInfo::ShardInfo( long long maxSize, long long currSize,
                           bool draining,
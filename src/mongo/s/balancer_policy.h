@@ -177,6 +177,29 @@ namespace mongo {
 
         /** @return the ShardInfo for the shard */
         const ShardInfo& shardInfo( const std::string& shard ) const;
+
+        // ---- planning several migrations at once
+
+        /**
+         * Records a migration that was planned but not yet executed. Chunk counts returned by
+         * this object then reflect the chunk being on 'migration.to', the chunk itself is not
+         * proposed again, and both shards become busy until clearBusyShards() is called.
+         */
+        void applyMigration( const MigrateInfo& migration );
+
+        /** @return true if the chunk starting at 'chunk' min is part of a planned migration */
+        bool isChunkPlanned( const ChunkType& chunk ) const;
+
+        /** @return true if there is any planned migration on this status */
+        bool hasPlannedMigrations() const { return ! _plannedChunks.empty(); }
+
+        /**
+         * A busy shard neither donates nor receives chunks. Used to keep the migrations of a
+         * single wave on disjoint donor/recipient pairs, possibly across several collections.
+         */
+        void addBusyShard( const std::string& shard );
+        bool isShardBusy( const std::string& shard ) const;
+        void clearBusyShards();
         
         /** writes all state to log() */
         void dump() const;
@@ -206,6 +229,11 @@ namespace mongo {
         std::map<BSONObj,TagRange> _tagRanges;
         std::set<std::string> _allTags;
         std::set<std::string> _shards;
+
+        // planned migrations: chunk min -> tag, and per shard, per tag change in the chunk count
+        std::map<BSONObj,std::string> _plannedChunks;
+        std::map<std::string, std::map<std::string,int> > _plannedDelta;
+        std::set<std::string> _busyShards;
     };
 
     class BalancerPolicy {
@@ -225,6 +253,22 @@ namespace mongo {
         static MigrateInfo* balance( const std::string& ns,
                                      const DistributionStatus& distribution,
                                      int balancedLastTime );
+
+        /**
+         * Plans one wave of migrations for a collection: repeatedly asks balance() for a move,
+         * applying each one to 'distribution' so that no shard appears in more than one of them
+         * and no shard already marked busy is used. Shards of the returned migrations are left
+         * busy on 'distribution'.
+         *
+         * @param migrations (OUT) migrations are appended here; caller owns them.
+         * @param maxMigrations stop after planning this many; 0 means no limit.
+         * @return number of migrations appended.
+         */
+        static unsigned balanceWave( const std::string& ns,
+                                     DistributionStatus* distribution,
+                                     int balancedLastTime,
+                                     std::vector<MigrateInfo*>* migrations,
+                                     unsigned maxMigrations = 0 );
     };
 
 
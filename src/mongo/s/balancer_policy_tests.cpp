@@ -584,5 +584,206 @@ namespace mongo {
                 }
             }
         }
+
+        TEST( BalancerPolicyTests, WaveUsesDisjointShards ) {
+            OwnedShardToChunksMap chunks;
+            addShard( chunks, 40 , false );
+            addShard( chunks, 40 , false );
+            addShard( chunks, 0 , false );
+            addShard( chunks, 0 , false );
+            addShard( chunks, 0 , false );
+            addShard( chunks, 0 , true );
+
+            ShardInfoMap shards;
+            for ( unsigned i = 0; i < 6; i++ )
+                shards[str::stream() << "shard" << i] = ShardInfo(0, 0, false);
+
+            DistributionStatus d(shards, chunks.map());
+            OwnedPointerVector<MigrateInfo> wave;
+            BalancerPolicy::balanceWave( "ns", &d, 0, &wave.mutableVector() );
+
+            // each overloaded shard can only donate once, to its own recipient
+            ASSERT_EQUALS( 2U, wave.size() );
+
+            set<string> used;
+            for ( unsigned i = 0; i < wave.size(); i++ ) {
+                ASSERT( used.insert( wave[i]->from ).second );
+                ASSERT( used.insert( wave[i]->to ).second );
+            }
+
+            // the counts reflect the planned moves
+            ASSERT_EQUALS( 39U, d.numberOfChunksInShard( "shard0" ) );
+            ASSERT_EQUALS( 39U, d.numberOfChunksInShard( "shard1" ) );
+
+            // the next wave does not propose the same chunks again
+            d.clearBusyShards();
+            OwnedPointerVector<MigrateInfo> next;
+            BalancerPolicy::balanceWave( "ns", &d, 0, &next.mutableVector() );
+            ASSERT_EQUALS( 2U, next.size() );
+            for ( unsigned i = 0; i < next.size(); i++ ) {
+                for ( unsigned j = 0; j < wave.size(); j++ ) {
+                    ASSERT( next[i]->chunk.min != wave[j]->chunk.min );
+                }
+            }
+        }
+
+        TEST( BalancerPolicyTests, WaveRespectsBusyShards ) {
+            OwnedShardToChunksMap chunks;
+            addShard( chunks, 10 , false );
+            addShard( chunks, 0 , false );
+            addShard( chunks, 0 , true );
+
+            ShardInfoMap shards;
+            shards["shard0"] = ShardInfo(0, 0, false);
+            shards["shard1"] = ShardInfo(0, 0, false);
+            shards["shard2"] = ShardInfo(0, 0, false);
+
+            // shard1 is taken by another collection's migration
+            DistributionStatus d(shards, chunks.map());
+            d.addBusyShard( "shard1" );
+
+            OwnedPointerVector<MigrateInfo> wave;
+            BalancerPolicy::balanceWave( "ns", &d, 0, &wave.mutableVector() );
+            ASSERT_EQUALS( 1U, wave.size() );
+            ASSERT_EQUALS( "shard0", wave[0]->from );
+            ASSERT_EQUALS( "shard2", wave[0]->to );
+
+            // all shards busy, nothing else to do
+            wave.clear();
+            BalancerPolicy::balanceWave( "ns", &d, 0, &wave.mutableVector() );
+            ASSERT_EQUALS( 0U, wave.size() );
+        }
+
+        TEST( BalancerPolicyTests, WaveStopsAtMaxMigrations ) {
+            OwnedShardToChunksMap chunks;
+            addShard( chunks, 40 , false );
+            addShard( chunks, 40 , false );
+            addShard( chunks, 0 , false );
+            addShard( chunks, 0 , false );
+
+            ShardInfoMap shards;
+            for ( unsigned i = 0; i < 4; i++ )
+                shards[str::stream() << "shard" << i] = ShardInfo(0, 0, false);
+
+            DistributionStatus d(shards, chunks.map());
+            OwnedPointerVector<MigrateInfo> wave;
+            ASSERT_EQUALS( 1U, BalancerPolicy::balanceWave( "ns", &d, 0, &wave.mutableVector(), 1 ) );
+            ASSERT_EQUALS( 1U, wave.size() );
+        }
+
+        /**
+         * Runs balancing rounds until the policy has nothing left to move, each round planning
+         * 'numWaves' waves, or, if 'numWaves' is 0, a single migration as balance() alone would.
+         * @return the number of rounds that moved something.
+         */
+        int roundsToBalance( OwnedShardToChunksMap& chunks,
+                             const ShardInfoMap& shards,
+                             unsigned numWaves ) {
+            int rounds = 0;
+            int movedLastTime = 0;
+
+            while ( true ) {
+                OwnedPointerVector<MigrateInfo> planned;
+                {
+                    DistributionStatus d(shards, chunks.map());
+
+                    if ( numWaves == 0 ) {
+                        MigrateInfo* m = BalancerPolicy::balance( "ns", d, movedLastTime );
+                        if ( m )
+                            planned.push_back( m );
+                    }
+
+                    for ( unsigned w = 0; w < numWaves; w++ ) {
+                        d.clearBusyShards();
+                        size_t waveStart = planned.size();
+                        BalancerPolicy::balanceWave( "ns", &d, movedLastTime,
+                                                     &planned.mutableVector() );
+
+                        set<string> used;
+                        for ( size_t i = waveStart; i < planned.size(); i++ ) {
+                            ASSERT( used.insert( planned[i]->from ).second );
+                            ASSERT( used.insert( planned[i]->to ).second );
+                        }
+                    }
+                }
+
+                if ( planned.empty() )
+                    return rounds;
+
+                for ( size_t i = 0; i < planned.size(); i++ )
+                    moveChunk( chunks, planned[i] );
+
+                movedLastTime = planned.size();
+                rounds++;
+                ASSERT_LESS_THAN( rounds, 1000 );
+            }
+        }
+
+        void assertBalanced( OwnedShardToChunksMap& chunks ) {
+            size_t min = numeric_limits<size_t>::max();
+            size_t max = 0;
+            const OwnedShardToChunksMap::MapType& shardToChunks = chunks.map();
+            for (OwnedShardToChunksMap::MapType::const_iterator i = shardToChunks.begin();
+                    i != shardToChunks.end(); ++i) {
+                min = std::min( min, i->second->size() );
+                max = std::max( max, i->second->size() );
+            }
+            ASSERT_LESS_THAN_OR_EQUALS( max - min, 1U );
+        }
+
+        /**
+         * Four loaded shards are joined by four empty ones. Planning disjoint migrations per wave
+         * must reach the same balanced state in far fewer rounds than one migration per round.
+         */
+        TEST( BalancerPolicyTests, RoundsToBalanceAfterAddingShards ) {
+            ShardInfoMap shards;
+            for ( unsigned i = 0; i < 8; i++ )
+                shards[str::stream() << "shard" << i] = ShardInfo(0, 0, false);
+
+            int rounds[3];
+            const unsigned numWaves[3] = { 0, 1, 4 };
+
+            for ( unsigned t = 0; t < 3; t++ ) {
+                OwnedShardToChunksMap chunks;
+                for ( unsigned i = 0; i < 8; i++ )
+                    addShard( chunks, i < 4 ? 30 : 0, i == 7 );
+
+                rounds[t] = roundsToBalance( chunks, shards, numWaves[t] );
+                log() << "waves per round: " << numWaves[t]
+                      << " rounds to balance: " << rounds[t] << endl;
+
+                assertBalanced( chunks );
+            }
+
+            // 60 chunks have to move; a wave moves four of them, one per donor/recipient pair
+            ASSERT_EQUALS( 60, rounds[0] );
+            ASSERT_EQUALS( 15, rounds[1] );
+            ASSERT_EQUALS( 4, rounds[2] );
+        }
+
+        /**
+         * Draining shards are emptied in parallel, each one giving to a different recipient.
+         */
+        TEST( BalancerPolicyTests, RoundsToDrainInParallel ) {
+            ShardInfoMap shards;
+            for ( unsigned i = 0; i < 6; i++ )
+                shards[str::stream() << "shard" << i] = ShardInfo(0, 0, i < 3);
+
+            OwnedShardToChunksMap single;
+            OwnedShardToChunksMap multi;
+            for ( unsigned i = 0; i < 6; i++ ) {
+                addShard( single, i < 3 ? 12 : 0, i == 5 );
+                addShard( multi, i < 3 ? 12 : 0, i == 5 );
+            }
+
+            const int serialRounds = roundsToBalance( single, shards, 0 );
+            const int parallelRounds = roundsToBalance( multi, shards, 1 );
+
+            ASSERT_EQUALS( 0U, multi.mutableMap()["shard0"]->size() );
+            ASSERT_EQUALS( 0U, multi.mutableMap()["shard1"]->size() );
+            ASSERT_EQUALS( 0U, multi.mutableMap()["shard2"]->size() );
+            ASSERT_EQUALS( 36, serialRounds );
+            ASSERT_EQUALS( 12, parallelRounds );
+        }
     }
 }
@@ -34,6 +34,7 @@
 #include "mongo/s/distlock.h"
 #include "mongo/s/chunk.h"  // needed for genID
 #include "mongo/s/config.h" // needed for changelog write
+#include "mongo/s/split_point_estimator.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 
@@ -297,6 +298,9 @@ namespace mongo {
             shardingState.mergeChunks(txn, nss.ns(), minKey, maxKey, mergeVersion);
         }
 
+        // Cached split points were computed for chunk bounds which no longer exist.
+        splitPointCache.invalidate(nss.ns());
+
         //
         // Log change
         //
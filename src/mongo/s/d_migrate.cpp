@@ -76,6 +76,7 @@
 #include "mongo/s/d_state.h"
 #include "mongo/s/distlock.h"
 #include "mongo/s/shard.h"
+#include "mongo/s/split_point_estimator.h"
 #include "mongo/s/type_chunk.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/elapsed_tracker.h"
@@ -1509,6 +1510,9 @@ namespace mongo {
 
                 migrateFromStatus.setInCriticalSection( false );
 
+                // Cached split points may have been computed over the chunk that just left.
+                splitPointCache.invalidate(ns);
+
                 // 5.d
                 BSONObjBuilder commitInfo;
                 commitInfo.appendElements( chunkInfo );
@@ -2044,6 +2048,9 @@ namespace mongo {
                 MONGO_FP_PAUSE_WHILE(migrateThreadHangAtStep5);
             }
 
+            // The collection has new data in a range this shard did not own before.
+            splitPointCache.invalidate(ns);
+
             setState(DONE);
             conn.done();
         }
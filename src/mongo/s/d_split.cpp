@@ -46,22 +46,42 @@
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/dbhelpers.h"
+#include "mongo/db/index/index_access_method.h"
 #include "mongo/db/index_legacy.h"
 #include "mongo/db/instance.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/query/internal_plans.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/s/chunk.h" // for static genID only
 #include "mongo/s/chunk_version.h"
 #include "mongo/s/config.h"
 #include "mongo/s/d_state.h"
 #include "mongo/s/distlock.h"
 #include "mongo/s/shard_key_pattern.h"
+#include "mongo/s/split_point_estimator.h"
 #include "mongo/s/type_chunk.h"
 #include "mongo/util/log.h"
 #include "mongo/util/timer.h"
 
 namespace mongo {
 
+    // When true, splitVector estimates split points from the internal buckets of the shard key
+    // index instead of counting every key in the chunk, if the index supports it.  The samples
+    // also size the chunk for the split point cache, so turning this off disables the cache too
+    // and leaves splitVector counting every key, as it always did.
+    MONGO_EXPORT_SERVER_PARAMETER(splitVectorUseSampling, bool, true);
+
+    // How long a splitVector result may be served again for the same chunk and parameters.
+    MONGO_EXPORT_SERVER_PARAMETER(splitVectorCacheMillis, int, 60 * 1000);
+
+    namespace {
+
+        // Below this many samples the estimate is too coarse to be useful, and the range is small
+        // enough that counting keys is cheap anyway.
+        const size_t kMinSamplesForEstimate = 16;
+
+    }  // namespace
+
     class CmdMedianKey : public Command {
     public:
         CmdMedianKey() : Command( "medianKey" ) {}
@@ -226,6 +246,7 @@ namespace mongo {
                  "  \n"
                  "  { splitVector : \"blog.post\" , keyPattern:{x:1} , min:{x:10} , max:{x:20}, force: true }\n"
                  "  'force' will produce one split point even if data is small; defaults to false\n"
+                 "  'exact' will count every key rather than estimate split points from the index structure\n"
                  "NOTE: This command may take a while to run";
         }
         virtual Status checkAuthForCommand(ClientBasic* client,
@@ -276,6 +297,8 @@ namespace mongo {
                 maxChunkObjects = MaxChunkObjectsElem.numberLong();
             }
 
+            const bool exact = jsobj["exact"].trueValue();
+
             vector<BSONObj> splitKeys;
 
             {
@@ -370,7 +393,71 @@ namespace mongo {
                     log() << "limiting split vector to " << maxChunkObjects << " (from " << keyCount << ") objects " << endl;
                     keyCount = maxChunkObjects;
                 }
-                
+
+                //
+                // 1.c Sample the index over the chunk's range.  The samples both size the chunk,
+                //     which decides whether a cached result still applies, and may provide the
+                //     split points without walking the whole range.  An index without enough
+                //     structure to sample is small enough to count, and is not cached; neither
+                //     is anything when sampling is turned off.
+                //
+
+                const IndexAccessMethod* iam = collection->getIndexCatalog()->getIndex( idx );
+                vector<BSONObj> samples;
+                double keysPerSample = 0;
+                long long rangeKeyCount = -1;
+                if ( !exact && splitVectorUseSampling &&
+                     iam->sampleKeys( txn, min, max, &samples, &keysPerSample ) ) {
+                    rangeKeyCount = static_cast<long long>( ( samples.size() + 1 ) * keysPerSample );
+                }
+
+                const string cacheKey = SplitPointCache::makeKey(ns, keyPattern, min, max, keyCount,
+                                                                 maxSplitPoints, forceMedianSplit);
+                if (rangeKeyCount >= 0 &&
+                    splitPointCache.get(cacheKey, rangeKeyCount, jsTime(), splitVectorCacheMillis,
+                                        &splitKeys)) {
+                    LOG(1) << "using cached split points for chunk " << ns << " " << min << " -->> "
+                           << max << endl;
+                    result.append( "cached", true );
+                    result.append( "splitKeys" , splitKeys );
+                    return true;
+                }
+
+                if ( rangeKeyCount >= 0 && samples.size() >= kMinSamplesForEstimate ) {
+                    Timer timer;
+                    for ( size_t i = 0; i < samples.size(); ++i ) {
+                        samples[i] = prettyKey( idx->keyPattern(), samples[i] ).extractFields( keyPattern );
+                    }
+                    const BSONObj rangeMin = prettyKey( idx->keyPattern(), min ).extractFields( keyPattern );
+
+                    long long estKeyCount = keyCount;
+                    long long estMaxSplitPoints = maxSplitPoints;
+                    if ( forceMedianSplit ) {
+                        estKeyCount = static_cast<long long>( ( samples.size() + 1 ) * keysPerSample / 2 );
+                        estMaxSplitPoints = 1;
+                    }
+
+                    vector<BSONObj> estimated;
+                    pickSplitPoints( samples, keysPerSample, estKeyCount, estMaxSplitPoints,
+                                     rangeMin, &estimated );
+
+                    // Without any split point the estimate may just be too coarse, so only
+                    // trust a positive answer and count otherwise.
+                    if ( !estimated.empty() ) {
+                        LOG(1) << "estimated " << estimated.size() << " split points for chunk "
+                               << ns << " " << min << " -->> " << max << " from "
+                               << samples.size() << " samples of ~" << keysPerSample
+                               << " keys each" << endl;
+
+                        splitPointCache.put( cacheKey, ns, rangeKeyCount, jsTime(), estimated );
+
+                        result.append( "timeMillis", timer.millis() );
+                        result.append( "estimated", true );
+                        result.append( "splitKeys" , estimated );
+                        return true;
+                    }
+                }
+
                 //
                 // 2. Traverse the index and add the keyCount-th key to the result vector. If that key
                 //    appeared in the vector before, we omit it. The invariant here is that all the
@@ -470,6 +557,10 @@ namespace mongo {
                 // Warning: we are sending back an array of keys but are currently limited to
                 // 4MB work of 'result' size. This should be okay for now.
 
+                if ( rangeKeyCount >= 0 ) {
+                    splitPointCache.put( cacheKey, ns, rangeKeyCount, jsTime(), splitKeys );
+                }
+
                 result.append( "timeMillis", timer.millis() );
             }
 
@@ -801,6 +892,9 @@ namespace mongo {
                 shardingState.splitChunk(txn, ns, min, max, splitKeys, newShardVersion);
             }
 
+            // Cached split points were computed for chunk bounds which no longer exist.
+            splitPointCache.invalidate(ns);
+
             //
             // 5. logChanges
             //
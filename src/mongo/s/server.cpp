@@ -56,6 +56,7 @@
 #include "mongo/db/log_process_details.h"
 #include "mongo/db/operation_context_noop.h"
 #include "mongo/db/startup_warnings_common.h"
+#include "mongo/logger/async_file_writer.h"
 #include "mongo/platform/process_id.h"
 #include "mongo/s/balance.h"
 #include "mongo/s/chunk.h"
@@ -496,6 +497,7 @@ void mongo::dbexit( ExitCode rc, const char *why ) {
     log() << "dbexit: " << why
           << " rc:" << rc
           << endl;
+    logger::AsyncFileWriter::flushAll();
     flushForGcov();
     quickExit(rc);
 }
@@ -0,0 +1,195 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/split_point_estimator.h"
+
+#include <cmath>
+
+namespace mongo {
+
+    namespace {
+
+        // Cached results are dropped once the chunk holds this fraction more or fewer keys.
+        const double kMaxCachedKeyCountDrift = 0.1;
+
+    }  // namespace
+
+    SplitPointCache splitPointCache(1000, kMaxCachedKeyCountDrift);
+
+    void pickSplitPoints(const std::vector<BSONObj>& samples,
+                         double keysPerSample,
+                         long long keyCount,
+                         long long maxSplitPoints,
+                         const BSONObj& rangeMin,
+                         std::vector<BSONObj>* splitPointsOut) {
+        splitPointsOut->clear();
+
+        BSONObj lastSplit = rangeMin;
+        double currCount = 0;
+        for (std::vector<BSONObj>::const_iterator it = samples.begin();
+             it != samples.end();
+             ++it) {
+            currCount += keysPerSample;
+
+            if (currCount <= keyCount) {
+                continue;
+            }
+
+            // Same as the previous split point: the key is too frequent to split on, so keep
+            // accumulating and split on the next distinct value.
+            if (it->woCompare(lastSplit) == 0) {
+                continue;
+            }
+
+            splitPointsOut->push_back(*it);
+            lastSplit = *it;
+            currCount = 0;
+
+            if (maxSplitPoints &&
+                static_cast<long long>(splitPointsOut->size()) >= maxSplitPoints) {
+                break;
+            }
+        }
+    }
+
+    SplitPointCache::SplitPointCache(size_t maxEntries, double maxKeyCountDrift)
+        : _maxEntries(maxEntries),
+          _maxKeyCountDrift(maxKeyCountDrift),
+          _mutex("SplitPointCache") {
+    }
+
+    bool SplitPointCache::_isUsable(const Entry& entry,
+                                    long long rangeKeyCount,
+                                    Date_t now,
+                                    long long maxAgeMillis) const {
+        if (now.millis < entry.created.millis ||
+            static_cast<long long>(now.millis - entry.created.millis) > maxAgeMillis) {
+            return false;
+        }
+
+        const double drift = std::fabs(static_cast<double>(rangeKeyCount - entry.rangeKeyCount));
+        return drift <= _maxKeyCountDrift * entry.rangeKeyCount;
+    }
+
+    bool SplitPointCache::get(const std::string& key,
+                              long long rangeKeyCount,
+                              Date_t now,
+                              long long maxAgeMillis,
+                              std::vector<BSONObj>* splitKeysOut) {
+        SimpleMutex::scoped_lock lk(_mutex);
+        for (EntryList::iterator it = _entries.begin(); it != _entries.end(); ++it) {
+            if (it->key != key) {
+                continue;
+            }
+
+            if (!_isUsable(*it, rangeKeyCount, now, maxAgeMillis)) {
+                _entries.erase(it);
+                return false;
+            }
+
+            *splitKeysOut = it->splitKeys;
+            return true;
+        }
+        return false;
+    }
+
+    void SplitPointCache::put(const std::string& key,
+                              const StringData& ns,
+                              long long rangeKeyCount,
+                              Date_t now,
+                              const std::vector<BSONObj>& splitKeys) {
+        if (0 == _maxEntries) {
+            return;
+        }
+
+        Entry entry;
+        entry.key = key;
+        entry.ns = ns.toString();
+        entry.rangeKeyCount = rangeKeyCount;
+        entry.created = now;
+        entry.splitKeys.reserve(splitKeys.size());
+        for (size_t i = 0; i < splitKeys.size(); ++i) {
+            entry.splitKeys.push_back(splitKeys[i].getOwned());
+        }
+
+        SimpleMutex::scoped_lock lk(_mutex);
+        for (EntryList::iterator it = _entries.begin(); it != _entries.end(); ++it) {
+            if (it->key == key) {
+                _entries.erase(it);
+                break;
+            }
+        }
+
+        while (_entries.size() >= _maxEntries) {
+            _entries.pop_front();
+        }
+
+        _entries.push_back(entry);
+    }
+
+    void SplitPointCache::invalidate(const StringData& ns) {
+        SimpleMutex::scoped_lock lk(_mutex);
+        EntryList::iterator it = _entries.begin();
+        while (it != _entries.end()) {
+            if (ns == it->ns) {
+                it = _entries.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+    }
+
+    size_t SplitPointCache::size() const {
+        SimpleMutex::scoped_lock lk(_mutex);
+        return _entries.size();
+    }
+
+    // static
+    std::string SplitPointCache::makeKey(const StringData& ns,
+                                         const BSONObj& keyPattern,
+                                         const BSONObj& min,
+                                         const BSONObj& max,
+                                         long long keyCount,
+                                         long long maxSplitPoints,
+                                         bool force) {
+        BSONObjBuilder b;
+        b.append("ns", ns);
+        b.append("keyPattern", keyPattern);
+        b.append("min", min);
+        b.append("max", max);
+        b.append("keyCount", keyCount);
+        b.append("maxSplitPoints", maxSplitPoints);
+        b.append("force", force);
+        BSONObj obj = b.obj();
+        return std::string(obj.objdata(), obj.objsize());
+    }
+
+}  // namespace mongo
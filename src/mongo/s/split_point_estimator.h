@@ -0,0 +1,144 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <list>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/util/concurrency/mutex.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+    /**
+     * Chooses chunk split points from a sorted sample of keys, as produced by
+     * IndexAccessMethod::sampleKeys, where roughly 'keysPerSample' index entries precede each
+     * sample.  A split point is emitted as soon as more than 'keyCount' entries have accumulated
+     * since the previous one, mirroring what splitVector does when counting every key.
+     *
+     * Samples equal to 'rangeMin' or to the previous split point are skipped so that all entries
+     * with one shard key value stay in the same chunk.  Stops after 'maxSplitPoints' split points
+     * if that is non-zero.
+     */
+    void pickSplitPoints(const std::vector<BSONObj>& samples,
+                         double keysPerSample,
+                         long long keyCount,
+                         long long maxSplitPoints,
+                         const BSONObj& rangeMin,
+                         std::vector<BSONObj>* splitPointsOut);
+
+    /**
+     * A bounded cache of recent splitVector results, keyed by a description of the request
+     * (namespace, bounds and sizing parameters).
+     *
+     * mongos asks for split points every time enough data has been written to a chunk, and most
+     * of those requests come back for the same chunk with barely changed data.  An entry is only
+     * served while it is younger than the configured age and the number of keys in the chunk's
+     * range is within 'maxKeyCountDrift' (a fraction) of the count the entry was computed at.
+     *
+     * This class is thread safe.
+     */
+    class SplitPointCache {
+        MONGO_DISALLOW_COPYING(SplitPointCache);
+    public:
+        SplitPointCache(size_t maxEntries, double maxKeyCountDrift);
+
+        /**
+         * Returns true and fills 'splitKeysOut' if an entry for 'key' exists which is at most
+         * 'maxAgeMillis' old and was computed for about 'rangeKeyCount' keys.  A stale entry is
+         * dropped.
+         */
+        bool get(const std::string& key,
+                 long long rangeKeyCount,
+                 Date_t now,
+                 long long maxAgeMillis,
+                 std::vector<BSONObj>* splitKeysOut);
+
+        /**
+         * Stores 'splitKeys' for 'key', evicting the oldest entry if the cache is full.
+         */
+        void put(const std::string& key,
+                 const StringData& ns,
+                 long long rangeKeyCount,
+                 Date_t now,
+                 const std::vector<BSONObj>& splitKeys);
+
+        /**
+         * Drops every entry for 'ns'.  Called whenever the bounds of its chunks on this shard
+         * change: after a split, a merge, or a migration commits.
+         */
+        void invalidate(const StringData& ns);
+
+        size_t size() const;
+
+        /**
+         * Builds the cache key for a splitVector request.
+         */
+        static std::string makeKey(const StringData& ns,
+                                   const BSONObj& keyPattern,
+                                   const BSONObj& min,
+                                   const BSONObj& max,
+                                   long long keyCount,
+                                   long long maxSplitPoints,
+                                   bool force);
+
+    private:
+        struct Entry {
+            std::string key;
+            std::string ns;
+            long long rangeKeyCount;
+            Date_t created;
+            std::vector<BSONObj> splitKeys;
+        };
+
+        typedef std::list<Entry> EntryList;
+
+        bool _isUsable(const Entry& entry,
+                       long long rangeKeyCount,
+                       Date_t now,
+                       long long maxAgeMillis) const;
+
+        const size_t _maxEntries;
+        const double _maxKeyCountDrift;
+
+        // Protects '_entries'.  Entries are kept oldest first.
+        mutable SimpleMutex _mutex;
+        EntryList _entries;
+    };
+
+    /**
+     * The split points served by the splitVector command on this shard.
+     */
+    extern SplitPointCache splitPointCache;
+
+}  // namespace mongo
@@ -0,0 +1,155 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/s/split_point_estimator.h"
+
+#include "mongo/unittest/unittest.h"
+
+namespace {
+
+    using mongo::BSONObj;
+    using mongo::Date_t;
+    using mongo::SplitPointCache;
+    using mongo::pickSplitPoints;
+    using std::string;
+    using std::vector;
+
+    vector<BSONObj> makeSamples(int first, int count) {
+        vector<BSONObj> samples;
+        for (int i = first; i < first + count; ++i) {
+            samples.push_back(BSON("x" << i));
+        }
+        return samples;
+    }
+
+    TEST(PickSplitPoints, EvenlySpaced) {
+        // 100 samples, 10 keys each: splitting every 95 keys picks every 10th sample.
+        vector<BSONObj> samples = makeSamples(1, 100);
+        vector<BSONObj> splitPoints;
+        pickSplitPoints(samples, 10.0, 95, 0, BSON("x" << 0), &splitPoints);
+
+        ASSERT_EQUALS(10U, splitPoints.size());
+        for (size_t i = 0; i < splitPoints.size(); ++i) {
+            ASSERT_EQUALS(BSON("x" << static_cast<int>(10 * (i + 1))), splitPoints[i]);
+        }
+    }
+
+    TEST(PickSplitPoints, RespectsMaxSplitPoints) {
+        vector<BSONObj> samples = makeSamples(1, 100);
+        vector<BSONObj> splitPoints;
+        pickSplitPoints(samples, 10.0, 95, 3, BSON("x" << 0), &splitPoints);
+
+        ASSERT_EQUALS(3U, splitPoints.size());
+        ASSERT_EQUALS(BSON("x" << 30), splitPoints.back());
+    }
+
+    TEST(PickSplitPoints, TooFewEntries) {
+        vector<BSONObj> samples = makeSamples(1, 5);
+        vector<BSONObj> splitPoints;
+        pickSplitPoints(samples, 10.0, 100, 0, BSON("x" << 0), &splitPoints);
+        ASSERT_TRUE(splitPoints.empty());
+    }
+
+    TEST(PickSplitPoints, SkipsRepeatedKeys) {
+        vector<BSONObj> samples;
+        samples.push_back(BSON("x" << 0));
+        samples.push_back(BSON("x" << 5));
+        samples.push_back(BSON("x" << 5));
+        samples.push_back(BSON("x" << 5));
+        samples.push_back(BSON("x" << 6));
+        vector<BSONObj> splitPoints;
+        pickSplitPoints(samples, 10.0, 5, 0, BSON("x" << 0), &splitPoints);
+
+        // The first sample equals the range minimum and can't be a split point.  Each value is
+        // used once, however often it occurs.
+        ASSERT_EQUALS(2U, splitPoints.size());
+        ASSERT_EQUALS(BSON("x" << 5), splitPoints[0]);
+        ASSERT_EQUALS(BSON("x" << 6), splitPoints[1]);
+    }
+
+    TEST(SplitPointCache, HitAndMiss) {
+        SplitPointCache cache(10, 0.1);
+        const string key = SplitPointCache::makeKey("test.foo", BSON("x" << 1),
+                                                    BSON("x" << 0), BSON("x" << 100),
+                                                    50, 0, false);
+        vector<BSONObj> splitKeys;
+        ASSERT_FALSE(cache.get(key, 1000, Date_t(0), 1000, &splitKeys));
+
+        cache.put(key, "test.foo", 1000, Date_t(0), makeSamples(1, 3));
+        ASSERT_TRUE(cache.get(key, 1000, Date_t(500), 1000, &splitKeys));
+        ASSERT_EQUALS(3U, splitKeys.size());
+
+        const string otherKey = SplitPointCache::makeKey("test.foo", BSON("x" << 1),
+                                                         BSON("x" << 0), BSON("x" << 100),
+                                                         50, 0, true);
+        ASSERT_FALSE(cache.get(otherKey, 1000, Date_t(500), 1000, &splitKeys));
+    }
+
+    TEST(SplitPointCache, ExpiresByAge) {
+        SplitPointCache cache(10, 0.1);
+        cache.put("k", "test.foo", 1000, Date_t(0), makeSamples(1, 3));
+
+        vector<BSONObj> splitKeys;
+        ASSERT_FALSE(cache.get("k", 1000, Date_t(1001), 1000, &splitKeys));
+        ASSERT_EQUALS(0U, cache.size());
+    }
+
+    TEST(SplitPointCache, ExpiresByKeyCountDrift) {
+        SplitPointCache cache(10, 0.1);
+        cache.put("k", "test.foo", 1000, Date_t(0), makeSamples(1, 3));
+
+        vector<BSONObj> splitKeys;
+        ASSERT_TRUE(cache.get("k", 1100, Date_t(1), 1000, &splitKeys));
+        ASSERT_FALSE(cache.get("k", 1101, Date_t(1), 1000, &splitKeys));
+    }
+
+    TEST(SplitPointCache, EvictsOldest) {
+        SplitPointCache cache(2, 0.1);
+        cache.put("a", "test.foo", 1000, Date_t(0), makeSamples(1, 1));
+        cache.put("b", "test.foo", 1000, Date_t(0), makeSamples(1, 1));
+        cache.put("c", "test.foo", 1000, Date_t(0), makeSamples(1, 1));
+        ASSERT_EQUALS(2U, cache.size());
+
+        vector<BSONObj> splitKeys;
+        ASSERT_FALSE(cache.get("a", 1000, Date_t(0), 1000, &splitKeys));
+        ASSERT_TRUE(cache.get("b", 1000, Date_t(0), 1000, &splitKeys));
+        ASSERT_TRUE(cache.get("c", 1000, Date_t(0), 1000, &splitKeys));
+    }
+
+    TEST(SplitPointCache, InvalidateNamespace) {
+        SplitPointCache cache(10, 0.1);
+        cache.put("a", "test.foo", 1000, Date_t(0), makeSamples(1, 1));
+        cache.put("b", "test.bar", 1000, Date_t(0), makeSamples(1, 1));
+        cache.invalidate("test.foo");
+
+        vector<BSONObj> splitKeys;
+        ASSERT_FALSE(cache.get("a", 1000, Date_t(0), 1000, &splitKeys));
+        ASSERT_TRUE(cache.get("b", 1000, Date_t(0), 1000, &splitKeys));
+    }
+
+}  // namespace
@@ -35,6 +35,34 @@ namespace mongo {
 
     using mongoutils::str::stream;
 
+    namespace {
+
+        /**
+         * Appends to 'out' views of the objects of the array 'elem', without copying them.
+         * @return false if 'elem' is not an array of objects.
+         */
+        bool extractDocumentViews(const BSONElement& elem, std::vector<BSONObj>* out) {
+            if (elem.type() != Array) {
+                return false;
+            }
+
+            BSONObj arr = elem.embeddedObject();
+            out->reserve(out->size() + arr.nFields());
+
+            BSONObjIterator arrIt(arr);
+            while (arrIt.more()) {
+                BSONElement next = arrIt.next();
+                if (next.type() != Object) {
+                    return false;
+                }
+                out->push_back(next.embeddedObject());
+            }
+
+            return true;
+        }
+
+    } // namespace
+
     const std::string BatchedInsertRequest::BATCHED_INSERT_REQUEST = "insert";
     const BSONField<std::string> BatchedInsertRequest::collName("insert");
     const BSONField<std::vector<BSONObj> > BatchedInsertRequest::documents("documents");
@@ -112,10 +140,15 @@ namespace mongo {
                 _isCollNameSet = fieldState == FieldParser::FIELD_SET;
             }
             else if ( documents() == sourceEl.fieldName() ) {
-                FieldParser::FieldState fieldState =
-                    FieldParser::extract( sourceEl, documents, &_documents, errMsg );
-                if ( fieldState == FieldParser::FIELD_INVALID ) return false;
-                _isDocumentsSet = fieldState == FieldParser::FIELD_SET;
+                // A batch can hold many documents, so don't make an owned copy of each one.
+                if ( !extractDocumentViews( sourceEl, &_documents ) ) {
+                    // let the field parser explain what is wrong with the field
+                    std::vector<BSONObj> unused;
+                    FieldParser::extract( sourceEl, documents, &unused, errMsg );
+                    return false;
+                }
+                _documentsSource = source;
+                _isDocumentsSet = true;
             }
             else if ( writeConcern() == sourceEl.fieldName() ) {
                 FieldParser::FieldState fieldState =
@@ -153,6 +186,7 @@ namespace mongo {
 
         _documents.clear();
         _isDocumentsSet =false;
+        _documentsSource = BSONObj();
 
         _writeConcern = BSONObj();
         _isWriteConcernSet = false;
@@ -175,6 +209,7 @@ namespace mongo {
             other->addToDocuments(*it);
         }
         other->_isDocumentsSet = _isDocumentsSet;
+        other->_documentsSource = _documentsSource;
 
         other->_writeConcern = _writeConcern;
         other->_isWriteConcernSet = _isWriteConcernSet;
@@ -218,6 +253,7 @@ namespace mongo {
     void BatchedInsertRequest::unsetDocuments() {
         _documents.clear();
         _isDocumentsSet = false;
+        _documentsSource = BSONObj();
     }
 
     bool BatchedInsertRequest::isDocumentsSet() const {
@@ -128,6 +128,12 @@ namespace mongo {
         std::vector<BSONObj> _documents;
         bool _isDocumentsSet;
 
+        // Object the documents were parsed from. Parsed documents are not copied but point into
+        // it, so it has to outlive them: it is kept here if owned, and is otherwise the caller's
+        // buffer (e.g. the Message of the command), which must stay pinned while the request is
+        // in use.
+        BSONObj _documentsSource;
+
         // (O)  to be issued after the batch applied
         BSONObj _writeConcern;
         bool _isWriteConcernSet;
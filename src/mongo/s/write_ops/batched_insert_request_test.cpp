@@ -70,6 +70,48 @@ namespace {
         ASSERT_EQUALS(0, genInsertRequestObj.woCompare(origInsertRequestObj));
     }
 
+    TEST(Parse, DocumentsAreNotCopied) {
+        BSONObj requestObj = BSON(BatchedInsertRequest::collName("test") <<
+                                  BatchedInsertRequest::documents() <<
+                                      BSON_ARRAY(BSON("a" << 1) << BSON("b" << 2)));
+
+        string errMsg;
+        BatchedInsertRequest request;
+        ASSERT_TRUE(request.parseBSON(requestObj, &errMsg));
+        ASSERT_EQUALS(2U, request.sizeDocuments());
+
+        for (size_t i = 0; i < request.sizeDocuments(); i++) {
+            const char* docData = request.getDocumentsAt(i).objdata();
+            ASSERT(docData > requestObj.objdata());
+            ASSERT(docData < requestObj.objdata() + requestObj.objsize());
+        }
+
+        // An owned source is kept alive by the request.
+        requestObj = BSONObj();
+        ASSERT_EQUALS(BSON("a" << 1), request.getDocumentsAt(0));
+        ASSERT_EQUALS(BSON("b" << 2), request.getDocumentsAt(1));
+
+        BatchedInsertRequest clone;
+        request.cloneTo(&clone);
+        request.clear();
+        ASSERT_EQUALS(BSON("b" << 2), clone.getDocumentsAt(1));
+    }
+
+    TEST(Parse, DocumentsMustBeObjects) {
+        string errMsg;
+        BatchedInsertRequest request;
+
+        ASSERT_FALSE(request.parseBSON(BSON(BatchedInsertRequest::collName("test") <<
+                                            BatchedInsertRequest::documents() <<
+                                                BSON_ARRAY(BSON("a" << 1) << 2)),
+                                       &errMsg));
+        ASSERT_NOT_EQUALS(string::npos, errMsg.find("error parsing element 1"));
+
+        ASSERT_FALSE(request.parseBSON(BSON(BatchedInsertRequest::collName("test") <<
+                                            BatchedInsertRequest::documents() << BSON("a" << 1)),
+                                       &errMsg));
+    }
+
     TEST(GenID, All) {
 
         BatchedCommandRequest cmdRequest(BatchedCommandRequest::BatchType_Insert);
@@ -544,17 +544,29 @@ namespace mongo {
                         bool safe = e["safe"].trueValue();
                         BSONObj result;
 
+                        // Number of documents sent per insert message or command, each one
+                        // generated from the "doc" template.
+                        const int batchSize = e["batchSize"].eoo() ? 1 :
+                            std::max(1, e["batchSize"].numberInt());
+
                         {
                             BenchRunEventTrace _bret(&_stats.insertCounter);
 
-                            BSONObj insertDoc = fixQuery(e["doc"].Obj(), bsonTemplateEvaluator);
+                            vector<BSONObj> insertDocs;
+                            insertDocs.reserve(batchSize);
+                            for (int i = 0; i < batchSize; i++) {
+                                insertDocs.push_back(fixQuery(e["doc"].Obj(),
+                                                              bsonTemplateEvaluator));
+                            }
 
                             if (useWriteCmd) {
                                 BSONObjBuilder builder;
                                 builder.append("insert", nsToCollectionSubstring(ns));
                                 BSONArrayBuilder docBuilder(
                                     builder.subarrayStart("documents"));
-                                docBuilder.append(insertDoc);
+                                for (int i = 0; i < batchSize; i++) {
+                                    docBuilder.append(insertDocs[i]);
+                                }
                                 docBuilder.done();
                                 // TODO: Replace after SERVER-11774.
                                 conn->runCommand(
@@ -562,7 +574,10 @@ namespace mongo {
                                     builder.done(), result);
                             }
                             else {
-                                conn->insert(ns, insertDoc);
+                                if (batchSize == 1)
+                                    conn->insert(ns, insertDocs[0]);
+                                else
+                                    conn->insert(ns, insertDocs);
                                 if (safe)
                                     result = conn->getLastErrorDetailed();
                             }
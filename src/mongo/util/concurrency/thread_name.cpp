@@ -30,13 +30,21 @@
 #include "mongo/platform/compiler.h"
 #include "mongo/util/concurrency/thread_name.h"
 
+#include <algorithm>
 #include <boost/thread/tss.hpp>
+#include <cstring>
 
 namespace mongo {
 
 namespace {
     boost::thread_specific_ptr<std::string> _threadName;
 
+#if defined(MONGO_HAVE___THREAD)
+    // A plain copy of the name, for signal handlers, which can't use thread_specific_ptr.
+    const size_t kMaxSignalSafeName = 64;
+    __thread char _signalSafeThreadName[kMaxSignalSafeName];
+#endif
+
 #if defined(_WIN32)
 
 #define MS_VC_EXCEPTION 0x406D1388
@@ -71,6 +79,12 @@ namespace {
     void setThreadName(StringData name) {
         _threadName.reset(new string(name.rawData(), name.size()));
 
+#if defined(MONGO_HAVE___THREAD)
+        const size_t length = std::min(name.size(), kMaxSignalSafeName - 1);
+        std::memcpy(_signalSafeThreadName, name.rawData(), length);
+        _signalSafeThreadName[length] = '\0';
+#endif
+
 #if defined( DEBUG ) && defined( _WIN32 )
         // naming might be expensive so don't do "conn*" over and over
         setWinThreadName(_threadName.get()->c_str());
@@ -86,4 +100,18 @@ namespace {
         return *s;
     }
 
+    bool copyThreadNameForSignalHandler(char* buf, size_t size) {
+#if defined(MONGO_HAVE___THREAD)
+        if (size == 0)
+            return true;
+        size_t i = 0;
+        for (; i < size - 1 && _signalSafeThreadName[i]; ++i)
+            buf[i] = _signalSafeThreadName[i];
+        buf[i] = '\0';
+        return true;
+#else
+        return false;
+#endif
+    }
+
 }  // namespace mongo
@@ -45,4 +45,12 @@ namespace mongo {
      */
     MONGO_CLIENT_API const std::string& getThreadName();
 
+    /**
+     * Copies the name of the current thread into "buf", truncated to fit "size" bytes including
+     * the terminating NUL.  Unlike getThreadName(), this is safe to call from a signal handler.
+     *
+     * Returns false, leaving "buf" alone, on platforms that can't support it.
+     */
+    bool copyThreadNameForSignalHandler(char* buf, size_t size);
+
 }  // namespace mongo
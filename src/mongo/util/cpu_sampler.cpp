@@ -0,0 +1,293 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/cpu_sampler.h"
+
+#include <algorithm>
+#include <boost/scoped_array.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+#include <cstring>
+
+#if !defined(_WIN32)
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <dlfcn.h>
+#include <sys/time.h>
+#if defined(__GNUC__)
+#include <cxxabi.h>
+#endif
+#endif
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/backtrace.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/hex.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/processinfo.h"
+#include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
+
+namespace mongo {
+
+    const int CpuSampler::kMaxFrequencyHz;
+    const int CpuSampler::kMaxDurationMillis;
+
+#if defined(_WIN32)
+
+    Status CpuSampler::sample(int durationMillis, int frequencyHz, Result* result) {
+        return Status(ErrorCodes::IllegalOperation, "CPU sampling is not supported on Windows");
+    }
+
+#else
+
+    namespace {
+
+        const int kMaxFrames = 64;
+
+        // The signal handler's own frame and the kernel's signal trampoline.
+        const int kSkipFrames = 2;
+
+        const size_t kMaxSamples = 32 * 1024;
+
+        struct Sample {
+            int depth;
+            char thread[32];
+            void* frames[kMaxFrames];
+        };
+
+        boost::mutex samplerMutex;
+        bool handlerInstalled = false;
+
+        // The signal handler only touches 'samples' while 'samplingEnabled' is set, and counts
+        // itself in 'handlersRunning' so that sample() can wait for it before reading them.
+        AtomicUInt32 samplingEnabled;
+        AtomicUInt32 handlersRunning;
+        Sample* samples = NULL;
+        size_t samplesCapacity = 0;
+        AtomicUInt32 nextSample;
+        AtomicUInt32 droppedSamples;
+
+        /** SIGPROF handler: records the interrupted thread's stack.  Must stay signal safe. */
+        void recordSample(int, siginfo_t*, void*) {
+            const int savedErrno = errno;
+            handlersRunning.fetchAndAdd(1);
+
+            if (samplingEnabled.load()) {
+                const unsigned slot = nextSample.fetchAndAdd(1);
+                if (slot < samplesCapacity) {
+                    Sample& sample = samples[slot];
+                    if (!copyThreadNameForSignalHandler(sample.thread, sizeof(sample.thread)))
+                        sample.thread[0] = '\0';
+                    sample.depth = backtrace(sample.frames, kMaxFrames);
+                }
+                else {
+                    droppedSamples.fetchAndAdd(1);
+                }
+            }
+
+            handlersRunning.fetchAndSubtract(1);
+            errno = savedErrno;
+        }
+
+        /** "conn12" -> "conn" */
+        std::string threadLabel(const char* name) {
+            std::string label(name);
+            const size_t last = label.find_last_not_of("0123456789");
+            label.erase(last == std::string::npos ? 0 : last + 1);
+            return label.empty() ? "unnamed" : label;
+        }
+
+        /** Names the functions of sampled frames, caching the answer for each address. */
+        class Symbolizer {
+        public:
+            const std::string& name(void* address) {
+                std::map<void*, std::string>::const_iterator it = _names.find(address);
+                if (it != _names.end())
+                    return it->second;
+                return _names[address] = _lookUp(address);
+            }
+
+        private:
+            static std::string _lookUp(void* address) {
+                Dl_info info;
+                if (!dladdr(address, &info))
+                    return str::stream() << address;
+
+                if (info.dli_sname) {
+#if defined(__GNUC__)
+                    int status;
+                    char* demangled = abi::__cxa_demangle(info.dli_sname, NULL, NULL, &status);
+                    if (demangled) {
+                        std::string result(demangled);
+                        free(demangled);
+                        return result;
+                    }
+#endif
+                    return info.dli_sname;
+                }
+
+                // Without a symbol, name the frame by its offset in the binary or library.
+                StringData file(info.dli_fname ? info.dli_fname : "???");
+                const size_t slash = file.rfind('/');
+                if (slash != std::string::npos)
+                    file = file.substr(slash + 1);
+                return str::stream() << file << "+0x"
+                                     << integerToHex(uintptr_t(address) -
+                                                     uintptr_t(info.dli_fbase));
+            }
+
+            std::map<void*, std::string> _names;
+        };
+
+        void foldSamples(const Sample* samples, size_t count, CpuSampler::FoldedStacks* out) {
+            Symbolizer symbolizer;
+            for (size_t i = 0; i < count; ++i) {
+                const Sample& sample = samples[i];
+                std::string folded = threadLabel(sample.thread);
+                for (int frame = sample.depth - 1; frame >= kSkipFrames; --frame) {
+                    // Other than the interrupted one, frames hold return addresses, which may be
+                    // past the end of the calling function; look up the call instruction instead.
+                    char* address = static_cast<char*>(sample.frames[frame]);
+                    if (frame != kSkipFrames)
+                        --address;
+                    folded += ';';
+                    folded += symbolizer.name(address);
+                }
+                ++(*out)[folded];
+            }
+        }
+
+        itimerval timerForFrequency(int frequencyHz) {
+            const long long intervalMicros = 1000 * 1000 / frequencyHz;
+            itimerval timer;
+            timer.it_interval.tv_sec = intervalMicros / (1000 * 1000);
+            timer.it_interval.tv_usec = intervalMicros % (1000 * 1000);
+            timer.it_value = timer.it_interval;
+            return timer;
+        }
+
+    }  // namespace
+
+    Status CpuSampler::sample(int durationMillis, int frequencyHz, Result* result) {
+        if (frequencyHz < 1 || frequencyHz > kMaxFrequencyHz) {
+            return Status(ErrorCodes::BadValue, str::stream()
+                          << "sampling frequency must be between 1 and " << kMaxFrequencyHz
+                          << " Hz");
+        }
+        if (durationMillis < 1 || durationMillis > kMaxDurationMillis) {
+            return Status(ErrorCodes::BadValue, str::stream()
+                          << "sampling duration must be between 1 and " << kMaxDurationMillis
+                          << " ms");
+        }
+
+        boost::unique_lock<boost::mutex> lk(samplerMutex, boost::try_to_lock);
+        if (!lk.owns_lock()) {
+            return Status(ErrorCodes::LockBusy,
+                          "a CPU sample is already being taken");
+        }
+
+        itimerval current;
+        if (getitimer(ITIMER_PROF, &current) == 0 &&
+            (current.it_value.tv_sec || current.it_value.tv_usec)) {
+            return Status(ErrorCodes::LockBusy,
+                          "another CPU profiler is running");
+        }
+
+        // Room for every core to be busy the whole time, within reason.
+        ProcessInfo p;
+        const long long expected = static_cast<long long>(frequencyHz) * durationMillis / 1000;
+        const size_t capacity = static_cast<size_t>(
+                std::min<long long>(kMaxSamples, (expected + 1) * std::max(1U, p.getNumCores())));
+        boost::scoped_array<Sample> buffer(new Sample[capacity]);
+
+        // The first backtrace() may load the unwinder, which is not safe in a signal handler.
+        void* warmUp[1];
+        backtrace(warmUp, 1);
+
+        if (!handlerInstalled) {
+            // Once installed, the handler stays: a SIGPROF still pending when sampling stops must
+            // not hit the default action, which terminates the process.
+            struct sigaction action;
+            std::memset(&action, 0, sizeof(action));
+            action.sa_sigaction = &recordSample;
+            action.sa_flags = SA_SIGINFO | SA_RESTART;
+            sigemptyset(&action.sa_mask);
+            if (sigaction(SIGPROF, &action, NULL)) {
+                return Status(ErrorCodes::InternalError, str::stream()
+                              << "could not install SIGPROF handler: " << errnoWithDescription());
+            }
+            handlerInstalled = true;
+        }
+
+        samples = buffer.get();
+        samplesCapacity = capacity;
+        nextSample.store(0);
+        droppedSamples.store(0);
+        samplingEnabled.store(1);
+
+        itimerval timer = timerForFrequency(frequencyHz);
+        if (setitimer(ITIMER_PROF, &timer, NULL)) {
+            const std::string error = errnoWithDescription();
+            samplingEnabled.store(0);
+            return Status(ErrorCodes::InternalError, str::stream()
+                          << "could not start profiling timer: " << error);
+        }
+
+        // Signals can cut a sleep short.
+        Timer elapsed;
+        for (int remaining = durationMillis; remaining > 0;
+             remaining = durationMillis - elapsed.millis()) {
+            sleepmillis(remaining);
+        }
+
+        itimerval off;
+        std::memset(&off, 0, sizeof(off));
+        setitimer(ITIMER_PROF, &off, NULL);
+        samplingEnabled.store(0);
+        while (handlersRunning.load()) {
+            sleepmicros(100);
+        }
+
+        const size_t taken = std::min<size_t>(nextSample.load(), capacity);
+        result->samples = taken;
+        result->dropped = droppedSamples.load();
+        foldSamples(buffer.get(), taken, &result->stacks);
+
+        samples = NULL;
+        samplesCapacity = 0;
+        return Status::OK();
+    }
+
+#endif
+
+}  // namespace mongo
@@ -0,0 +1,76 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <map>
+#include <string>
+
+#include "mongo/base/status.h"
+
+namespace mongo {
+
+    /**
+     * Samples the call stacks of every thread in the process at a fixed rate of CPU time, for
+     * profiling a running server on demand.
+     *
+     * Sampling uses the same mechanism as the gperftools CPU profiler: an ITIMER_PROF interval
+     * timer, whose SIGPROF lands on whichever thread is using the CPU, and a signal handler that
+     * records that thread's stack.  Threads are sampled in proportion to the CPU they use, and
+     * idle threads cost nothing.
+     *
+     * Only one sample may run at a time.  Not supported on Windows.
+     */
+    class CpuSampler {
+    public:
+        /**
+         * Samples, aggregated by stack in the "folded" format flame graph tools read: the name of
+         * the thread, then each function from the outermost call inwards, separated by ';'.
+         * Trailing digits are removed from thread names, so that all "conn" threads share stacks.
+         */
+        typedef std::map<std::string, long long> FoldedStacks;
+
+        struct Result {
+            Result() : samples(0), dropped(0) {}
+
+            long long samples;
+            long long dropped;  // taken while the sample buffer was full
+            FoldedStacks stacks;
+        };
+
+        static const int kMaxFrequencyHz = 1000;
+        static const int kMaxDurationMillis = 60 * 1000;
+
+        /**
+         * Samples for 'durationMillis' at 'frequencyHz' per second of CPU used by the process,
+         * blocking the calling thread meanwhile.
+         */
+        static Status sample(int durationMillis, int frequencyHz, Result* result);
+    };
+
+}  // namespace mongo
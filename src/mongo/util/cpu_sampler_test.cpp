@@ -0,0 +1,102 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <boost/thread/thread.hpp>
+
+#include "mongo/stdx/functional.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/cpu_sampler.h"
+#include "mongo/util/timer.h"
+
+namespace mongo {
+
+    volatile unsigned long long cpuSamplerTestSink;
+
+    // Not in an anonymous namespace, so that the symbolizer can name it.
+    void cpuSamplerTestSpin(volatile bool* stop) {
+        while (!*stop) {
+            for (int i = 0; i < 1000; ++i)
+                cpuSamplerTestSink = cpuSamplerTestSink + i;
+        }
+    }
+
+}  // namespace mongo
+
+namespace {
+
+    using mongo::CpuSampler;
+    using mongo::Status;
+
+    void spinner(volatile bool* stop) {
+        mongo::setThreadName("spinner7");
+        mongo::cpuSamplerTestSpin(stop);
+    }
+
+    TEST(CpuSamplerTest, RejectsBadArguments) {
+        CpuSampler::Result result;
+        ASSERT_EQUALS(mongo::ErrorCodes::BadValue, CpuSampler::sample(0, 100, &result).code());
+        ASSERT_EQUALS(mongo::ErrorCodes::BadValue,
+                      CpuSampler::sample(CpuSampler::kMaxDurationMillis + 1, 100, &result).code());
+        ASSERT_EQUALS(mongo::ErrorCodes::BadValue, CpuSampler::sample(100, 0, &result).code());
+        ASSERT_EQUALS(mongo::ErrorCodes::BadValue,
+                      CpuSampler::sample(100, CpuSampler::kMaxFrequencyHz + 1, &result).code());
+    }
+
+#if !defined(_WIN32)
+    TEST(CpuSamplerTest, SamplesBusyThread) {
+        volatile bool stop = false;
+        boost::thread thread(mongo::stdx::bind(&spinner, &stop));
+
+        CpuSampler::Result result;
+        const Status status = CpuSampler::sample(500, 1000, &result);
+        stop = true;
+        thread.join();
+        ASSERT_OK(status);
+
+        ASSERT_GREATER_THAN(result.samples, 0);
+        long long total = 0;
+        long long spinning = 0;
+        for (CpuSampler::FoldedStacks::const_iterator it = result.stacks.begin();
+             it != result.stacks.end(); ++it) {
+            total += it->second;
+            if (it->first.find("cpuSamplerTestSpin") == std::string::npos)
+                continue;
+#if defined(MONGO_HAVE___THREAD)
+            ASSERT_EQUALS(0U, it->first.find("spinner;"));
+#endif
+            spinning += it->second;
+        }
+        ASSERT_EQUALS(result.samples, total);
+        ASSERT_GREATER_THAN(spinning, 0);
+    }
+#endif
+
+}  // namespace
@@ -39,6 +39,7 @@
 #include "mongo/util/goodies.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/net/hostandport.h"
+#include "mongo/util/net/segmented_buf_builder.h"
 #include "mongo/util/net/sock.h"
 
 namespace mongo {
@@ -324,12 +325,12 @@ namespace mongo {
     class Message {
     public:
         // we assume here that a vector with initial size 0 does no allocation (0 is the default, but wanted to make it explicit).
-        Message() : _buf( 0 ), _data( 0 ), _freeIt( false ) {}
+        Message() : _buf( 0 ), _data( 0 ), _freeIt( false ), _pooled( false ) {}
         Message( void * data , bool freeIt ) :
-            _buf( 0 ), _data( 0 ), _freeIt( false ) {
+            _buf( 0 ), _data( 0 ), _freeIt( false ), _pooled( false ) {
             _setData( reinterpret_cast< char* >( data ), freeIt );
         };
-        Message(Message& r) : _buf( 0 ), _data( 0 ), _freeIt( false ) {
+        Message(Message& r) : _buf( 0 ), _data( 0 ), _freeIt( false ), _pooled( false ) {
             *this = r;
         }
         ~Message() {
@@ -402,22 +403,25 @@ namespace mongo {
             }
             r._freeIt = false;
             _freeIt = true;
+            _pooled = r._pooled;
+            r._pooled = false;
             return *this;
         }
 
         void reset() {
             if ( _freeIt ) {
                 if ( _buf ) {
-                    free( _buf );
+                    _freeBuffer( _buf );
                 }
                 for (std::vector< std::pair< char *, int > >::const_iterator i = _data.begin();
                      i != _data.end(); ++i) {
-                    free(i->first);
+                    _freeBuffer(i->first);
                 }
             }
             _buf = 0;
             _data.clear();
             _freeIt = false;
+            _pooled = false;
         }
 
         // use to add a buffer
@@ -441,6 +445,18 @@ namespace mongo {
             header().setLen(header().getLen() + size);
         }
 
+        // use to add a segment obtained from MessageSegmentPool, see SegmentedBufBuilder
+        // all buffers of the message must then come from the pool, and go back to it on reset
+        void appendPooledData(char *d, int size) {
+            verify( empty() || _pooled );
+            if ( size <= 0 ) {
+                MessageSegmentPool::release( d );
+                return;
+            }
+            appendData( d, size );
+            _pooled = true;
+        }
+
         // use to set first buffer if empty
         void setData(char* d, bool freeIt) {
             verify( empty() );
@@ -472,12 +488,22 @@ namespace mongo {
             _freeIt = freeIt;
             _buf = d;
         }
+        void _freeBuffer( char* d ) {
+            if ( _pooled ) {
+                MessageSegmentPool::release( d );
+            }
+            else {
+                free( d );
+            }
+        }
         // if just one buffer, keep it in _buf, otherwise keep a sequence of buffers in _data
         char* _buf;
         // byte buffer(s) - the first must contain at least a full MsgData unless using _buf for storage instead
         typedef std::vector< std::pair< char*, int > > MsgVec;
         MsgVec _data;
         bool _freeIt;
+        // buffers come from MessageSegmentPool rather than malloc
+        bool _pooled;
     };
 
 
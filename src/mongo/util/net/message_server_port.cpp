@@ -48,6 +48,7 @@
 #include "mongo/util/net/message.h"
 #include "mongo/util/net/message_port.h"
 #include "mongo/util/net/message_server.h"
+#include "mongo/util/net/segmented_buf_builder.h"
 #include "mongo/util/net/ssl_manager.h"
 
 #ifdef __linux__  // TODO: consider making this ifndef _WIN32
@@ -221,6 +222,9 @@ namespace mongo {
                     m.reset();
                     p->psock->clearCounters();
 
+                    // Don't hold on to reply buffers while the client may stay idle.
+                    MessageSegmentPool::releaseThreadCache();
+
                     if ( ! p->recv(m) ) {
                         if (!serverGlobalParams.quiet) {
                             int conns = Listener::globalTicketHolder.used()-1;
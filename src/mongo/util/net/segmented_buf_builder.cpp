@@ -0,0 +1,252 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/net/segmented_buf_builder.h"
+
+#include <boost/thread/tss.hpp>
+#include <cstring>
+
+#include "mongo/util/allocator.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/mutex.h"
+#include "mongo/util/net/message.h"
+
+namespace mongo {
+
+    namespace {
+
+        const int kNumSizeClasses = 6;
+
+        // Bytes in front of each segment remembering its size class; keeps segments 16 byte
+        // aligned.
+        const int kSegmentPrefix = 16;
+
+        struct SegmentCache {
+            SegmentCache() : bytes(0) {}
+
+            ~SegmentCache() {
+                for (int i = 0; i < kNumSizeClasses; i++) {
+                    for (size_t j = 0; j < free[i].size(); j++) {
+                        ::free(free[i][j]);
+                    }
+                }
+            }
+
+            // raw allocations, including the prefix
+            std::vector<char*> free[kNumSizeClasses];
+            size_t bytes;
+        };
+
+        boost::thread_specific_ptr<SegmentCache> segmentCache;
+
+        // Protects 'sharedCache'.
+        SimpleMutex sharedCacheMutex("MessageSegmentPool");
+        SegmentCache sharedCache;
+
+        SegmentCache* getSegmentCache() {
+            SegmentCache* cache = segmentCache.get();
+            if (!cache) {
+                cache = new SegmentCache();
+                segmentCache.reset(cache);
+            }
+            return cache;
+        }
+
+    } // namespace
+
+    const int MessageSegmentPool::kMinSegmentSize;
+    const int MessageSegmentPool::kMaxSegmentSize;
+    const size_t MessageSegmentPool::kMaxThreadCachedBytes;
+    const size_t MessageSegmentPool::kMaxSharedCachedBytes;
+
+    int MessageSegmentPool::segmentSize(int sizeClass) {
+        dassert(sizeClass >= 0 && sizeClass < kNumSizeClasses);
+        return kMinSegmentSize << sizeClass;
+    }
+
+    int MessageSegmentPool::sizeClassForSegment(size_t n) {
+        return n < static_cast<size_t>(kNumSizeClasses) ? static_cast<int>(n)
+                                                        : kNumSizeClasses - 1;
+    }
+
+    char* MessageSegmentPool::acquire(int sizeClass) {
+        SegmentCache* cache = getSegmentCache();
+
+        char* raw = NULL;
+        if (!cache->free[sizeClass].empty()) {
+            raw = cache->free[sizeClass].back();
+            cache->free[sizeClass].pop_back();
+            cache->bytes -= segmentSize(sizeClass);
+        }
+        else {
+            SimpleMutex::scoped_lock lk(sharedCacheMutex);
+            if (!sharedCache.free[sizeClass].empty()) {
+                raw = sharedCache.free[sizeClass].back();
+                sharedCache.free[sizeClass].pop_back();
+                sharedCache.bytes -= segmentSize(sizeClass);
+            }
+        }
+
+        if (!raw) {
+            raw = static_cast<char*>(mongoMalloc(kSegmentPrefix + segmentSize(sizeClass)));
+            *reinterpret_cast<int*>(raw) = sizeClass;
+        }
+
+        return raw + kSegmentPrefix;
+    }
+
+    void MessageSegmentPool::release(char* segment) {
+        char* raw = segment - kSegmentPrefix;
+        const int sizeClass = *reinterpret_cast<int*>(raw);
+        const size_t size = segmentSize(sizeClass);
+
+        SegmentCache* cache = getSegmentCache();
+        if (cache->bytes + size <= kMaxThreadCachedBytes) {
+            cache->free[sizeClass].push_back(raw);
+            cache->bytes += size;
+            return;
+        }
+
+        {
+            SimpleMutex::scoped_lock lk(sharedCacheMutex);
+            if (sharedCache.bytes + size <= kMaxSharedCachedBytes) {
+                sharedCache.free[sizeClass].push_back(raw);
+                sharedCache.bytes += size;
+                return;
+            }
+        }
+
+        ::free(raw);
+    }
+
+    void MessageSegmentPool::releaseThreadCache() {
+        SegmentCache* cache = segmentCache.get();
+        if (!cache || 0 == cache->bytes) {
+            return;
+        }
+
+        SimpleMutex::scoped_lock lk(sharedCacheMutex);
+        for (int i = 0; i < kNumSizeClasses; i++) {
+            const size_t size = segmentSize(i);
+            for (size_t j = 0; j < cache->free[i].size(); j++) {
+                if (sharedCache.bytes + size <= kMaxSharedCachedBytes) {
+                    sharedCache.free[i].push_back(cache->free[i][j]);
+                    sharedCache.bytes += size;
+                }
+                else {
+                    ::free(cache->free[i][j]);
+                }
+            }
+            cache->free[i].clear();
+        }
+        cache->bytes = 0;
+    }
+
+    size_t MessageSegmentPool::cachedBytes() {
+        return getSegmentCache()->bytes;
+    }
+
+    size_t MessageSegmentPool::sharedCachedBytes() {
+        SimpleMutex::scoped_lock lk(sharedCacheMutex);
+        return sharedCache.bytes;
+    }
+
+    SegmentedBufBuilder::SegmentedBufBuilder() : _len(0) {
+    }
+
+    SegmentedBufBuilder::~SegmentedBufBuilder() {
+        for (size_t i = 0; i < _segments.size(); i++) {
+            MessageSegmentPool::release(_segments[i].first);
+        }
+    }
+
+    void SegmentedBufBuilder::_addSegment() {
+        const int sizeClass = MessageSegmentPool::sizeClassForSegment(_segments.size());
+        _segments.push_back(std::make_pair(MessageSegmentPool::acquire(sizeClass), 0));
+    }
+
+    void SegmentedBufBuilder::skip(int n) {
+        if (_segments.empty()) {
+            _addSegment();
+        }
+
+        std::pair<char*, int>& last = _segments.back();
+        const int size = MessageSegmentPool::segmentSize(
+                MessageSegmentPool::sizeClassForSegment(_segments.size() - 1));
+        invariant(last.second + n <= size);
+
+        last.second += n;
+        _len += n;
+    }
+
+    void SegmentedBufBuilder::appendBuf(const void* data, int len) {
+        const char* src = static_cast<const char*>(data);
+
+        while (len > 0) {
+            if (_segments.empty()) {
+                _addSegment();
+            }
+
+            const int size = MessageSegmentPool::segmentSize(
+                    MessageSegmentPool::sizeClassForSegment(_segments.size() - 1));
+            if (_segments.back().second == size) {
+                _addSegment();
+                continue;
+            }
+
+            std::pair<char*, int>& last = _segments.back();
+            const int n = std::min(len, size - last.second);
+            memcpy(last.first + last.second, src, n);
+            last.second += n;
+            _len += n;
+            src += n;
+            len -= n;
+        }
+    }
+
+    char* SegmentedBufBuilder::buf() {
+        if (_segments.empty()) {
+            _addSegment();
+        }
+        return _segments.front().first;
+    }
+
+    void SegmentedBufBuilder::releaseTo(Message* out) {
+        invariant(out->empty());
+
+        for (size_t i = 0; i < _segments.size(); i++) {
+            out->appendPooledData(_segments[i].first, _segments[i].second);
+        }
+
+        _segments.clear();
+        _len = 0;
+    }
+
+} // namespace mongo
@@ -0,0 +1,127 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+
+namespace mongo {
+
+    class Message;
+
+    /**
+     * Cache of the buffers used to build large messages in segments, so that replies of several
+     * megabytes don't go back to the allocator on every batch.
+     *
+     * Segments come in a few power of two size classes. Each thread keeps at most
+     * kMaxThreadCachedBytes of released segments without locking; beyond that they go to a free
+     * list shared by all threads, which holds at most kMaxSharedCachedBytes. Anything beyond
+     * both is freed. A connection thread hands its segments to the shared list with
+     * releaseThreadCache() before it waits for the next request, so idle connections pin
+     * nothing.
+     */
+    class MessageSegmentPool {
+    public:
+        static const int kMinSegmentSize = 32 * 1024;
+        static const int kMaxSegmentSize = 1024 * 1024;
+        static const size_t kMaxThreadCachedBytes = 64 * 1024;
+        static const size_t kMaxSharedCachedBytes = 32 * 1024 * 1024;
+
+        /**
+         * @return a buffer of segmentSize(sizeClass) bytes, owned by the caller until passed to
+         *         release()
+         */
+        static char* acquire(int sizeClass);
+
+        /** Gives back a buffer obtained from acquire(), possibly from another thread. */
+        static void release(char* segment);
+
+        /** @return the usable size of a segment of the given class */
+        static int segmentSize(int sizeClass);
+
+        /** @return the size class to use for the n-th segment of a message */
+        static int sizeClassForSegment(size_t n);
+
+        /** Moves the calling thread's cached segments to the shared free list. */
+        static void releaseThreadCache();
+
+        /** @return bytes currently cached by the calling thread */
+        static size_t cachedBytes();
+
+        /** @return bytes currently on the shared free list */
+        static size_t sharedCachedBytes();
+    };
+
+    /**
+     * Builds a message as a list of segments drawn from MessageSegmentPool instead of a single
+     * buffer. Unlike BufBuilder it never reallocates and copies what was already written:
+     * appended bytes simply continue into a new segment, possibly splitting a document across
+     * two segments. The segments are then sent as they are by a single gathering write.
+     *
+     * Usage mirrors BufBuilder: skip() room for the header, append the body, fill in the header
+     * through buf(), and hand the segments to a Message with releaseTo().
+     */
+    class SegmentedBufBuilder {
+        MONGO_DISALLOW_COPYING(SegmentedBufBuilder);
+    public:
+        SegmentedBufBuilder();
+        ~SegmentedBufBuilder();
+
+        /** Reserves 'n' bytes, which must fit in the first segment if nothing was appended yet. */
+        void skip(int n);
+
+        void appendBuf(const void* data, int len);
+
+        /** @return total number of bytes written so far */
+        int len() const { return _len; }
+
+        /** @return start of the first segment, where a header reserved by skip() lives */
+        char* buf();
+
+        /** @return number of segments in use */
+        size_t numSegments() const { return _segments.size(); }
+
+        /**
+         * Hands all segments over to 'out', which must be empty. 'out' gives them back to the
+         * pool when reset. The header length of the message is the total length written.
+         */
+        void releaseTo(Message* out);
+
+    private:
+        void _addSegment();
+
+        // (segment, bytes used); all but the last segment are full
+        std::vector<std::pair<char*, int> > _segments;
+        int _len;
+    };
+
+} // namespace mongo
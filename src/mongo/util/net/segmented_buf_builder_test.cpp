@@ -0,0 +1,151 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/net/segmented_buf_builder.h"
+
+#include <string>
+
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/net/message.h"
+
+namespace mongo {
+namespace {
+
+    std::string flatten(Message& m) {
+        m.concat();
+        return std::string(m.singleData().view2ptr(), m.header().getLen());
+    }
+
+    TEST(SegmentedBufBuilder, SmallMessageIsSingleSegment) {
+        SegmentedBufBuilder bb;
+        bb.skip(sizeof(MSGHEADER::Value));
+        bb.appendBuf("hello", 5);
+        ASSERT_EQUALS(static_cast<int>(sizeof(MSGHEADER::Value)) + 5, bb.len());
+        ASSERT_EQUALS(1U, bb.numSegments());
+
+        MsgData::View(bb.buf()).setOperation(opReply);
+
+        Message m;
+        bb.releaseTo(&m);
+        ASSERT_EQUALS(0, bb.len());
+        ASSERT_EQUALS(static_cast<int>(sizeof(MSGHEADER::Value)) + 5, m.header().getLen());
+        ASSERT_EQUALS(opReply, m.operation());
+        ASSERT_EQUALS("hello", std::string(m.singleData().data(), 5));
+    }
+
+    TEST(SegmentedBufBuilder, LargeMessageSpansSegments) {
+        const int docSize = 1000;
+        const int numDocs = 4000;
+        std::string doc(docSize, 'x');
+
+        std::string expected(sizeof(MSGHEADER::Value), '\0');
+
+        SegmentedBufBuilder bb;
+        bb.skip(sizeof(MSGHEADER::Value));
+        for (int i = 0; i < numDocs; i++) {
+            doc[0] = static_cast<char>(i);
+            bb.appendBuf(doc.data(), docSize);
+            expected += doc;
+        }
+        ASSERT_EQUALS(static_cast<int>(expected.size()), bb.len());
+        ASSERT_GREATER_THAN(bb.numSegments(), 1U);
+
+        memset(bb.buf(), 0, sizeof(MSGHEADER::Value));
+
+        Message m;
+        bb.releaseTo(&m);
+        ASSERT_EQUALS(static_cast<int>(expected.size()), m.size());
+        ASSERT_EQUALS(static_cast<int>(expected.size()), m.header().getLen());
+
+        // Everything but the length prefix, which the message fills in.
+        std::string flat = flatten(m);
+        ASSERT_EQUALS(expected.size(), flat.size());
+        ASSERT(expected.compare(4, std::string::npos, flat, 4, std::string::npos) == 0);
+    }
+
+    TEST(SegmentedBufBuilder, SegmentsGoBackToThePool) {
+        {
+            SegmentedBufBuilder bb;
+            bb.skip(sizeof(MSGHEADER::Value));
+            Message m;
+            bb.releaseTo(&m);
+        }
+        const size_t cached = MessageSegmentPool::cachedBytes();
+        ASSERT_GREATER_THAN_OR_EQUALS(cached,
+                                      static_cast<size_t>(MessageSegmentPool::kMinSegmentSize));
+
+        // Reusing the cached segment does not grow the pool.
+        {
+            SegmentedBufBuilder bb;
+            bb.skip(sizeof(MSGHEADER::Value));
+            ASSERT_EQUALS(cached - MessageSegmentPool::kMinSegmentSize,
+                          MessageSegmentPool::cachedBytes());
+        }
+        ASSERT_EQUALS(cached, MessageSegmentPool::cachedBytes());
+    }
+
+    TEST(SegmentedBufBuilder, PoolIsBounded) {
+        {
+            std::string chunk(64 * 1024, 'y');
+            SegmentedBufBuilder bb;
+            for (int i = 0; i < 256; i++) {
+                bb.appendBuf(chunk.data(), chunk.size());
+            }
+        }
+        ASSERT_LESS_THAN_OR_EQUALS(MessageSegmentPool::cachedBytes(),
+                                   MessageSegmentPool::kMaxThreadCachedBytes);
+        ASSERT_LESS_THAN_OR_EQUALS(MessageSegmentPool::sharedCachedBytes(),
+                                   MessageSegmentPool::kMaxSharedCachedBytes);
+    }
+
+    TEST(SegmentedBufBuilder, ReleaseThreadCache) {
+        {
+            SegmentedBufBuilder bb;
+            bb.skip(sizeof(MSGHEADER::Value));
+        }
+        ASSERT_GREATER_THAN(MessageSegmentPool::cachedBytes(), 0U);
+
+        const size_t shared = MessageSegmentPool::sharedCachedBytes();
+        const size_t cached = MessageSegmentPool::cachedBytes();
+        MessageSegmentPool::releaseThreadCache();
+        ASSERT_EQUALS(0U, MessageSegmentPool::cachedBytes());
+        ASSERT_EQUALS(shared + cached, MessageSegmentPool::sharedCachedBytes());
+
+        // The next message on this thread is built from the shared list.
+        {
+            SegmentedBufBuilder bb;
+            bb.skip(sizeof(MSGHEADER::Value));
+            ASSERT_EQUALS(shared + cached - MessageSegmentPool::kMinSegmentSize,
+                          MessageSegmentPool::sharedCachedBytes());
+        }
+    }
+
+} // namespace
+} // namespace mongo
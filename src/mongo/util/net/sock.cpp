@@ -660,7 +660,7 @@ namespace mongo {
         struct msghdr meta;
         memset( &meta, 0, sizeof( meta ) );
         meta.msg_iov = &d[ 0 ];
-        meta.msg_iovlen = d.size();
+        meta.msg_iovlen = i;
 
         while( meta.msg_iovlen > 0 ) {
             int ret = -1;
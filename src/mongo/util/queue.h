@@ -99,6 +99,19 @@ namespace mongo {
             return _maxSize;
         }
 
+        /**
+         * Waits until the size, as measured by the size function, is at most 'size', or until
+         * 'maxMillisToWait' passes.  Returns true if the size is at most 'size'.
+         */
+        bool waitForSizeAtMost(size_t size, int maxMillisToWait) {
+            scoped_lock l( _lock );
+            if (_currentSize > size) {
+                _cvNoLongerFull.timed_wait(l.boost(),
+                                           boost::posix_time::milliseconds(maxMillisToWait));
+            }
+            return _currentSize <= size;
+        }
+
         /**
          * The number/count of items in the queue ( _queue.size() )
          */
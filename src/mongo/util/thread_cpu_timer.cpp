@@ -0,0 +1,129 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/thread_cpu_timer.h"
+
+#include <ctime>
+#if defined(MONGO_HAVE_HEADER_UNISTD_H)
+#include <unistd.h>
+#endif
+
+#include "mongo/util/timer.h"
+
+#if !defined(_WIN32) && defined(_POSIX_THREAD_CPUTIME) && (_POSIX_THREAD_CPUTIME >= 0)
+#define MONGO_HAVE_POSIX_THREAD_CPUTIME
+#endif
+
+namespace mongo {
+
+    namespace {
+
+#if defined(_WIN32)
+
+        /** the CPU time, user and kernel, that 'thread' has used in microseconds, or -1 */
+        long long threadCpuMicros(HANDLE thread) {
+            FILETIME creation;
+            FILETIME exit;
+            FILETIME kernel;
+            FILETIME user;
+            if (!GetThreadTimes(thread, &creation, &exit, &kernel, &user))
+                return -1;
+
+            // FILETIMEs count 100ns intervals.
+            ULARGE_INTEGER k;
+            k.LowPart = kernel.dwLowDateTime;
+            k.HighPart = kernel.dwHighDateTime;
+            ULARGE_INTEGER u;
+            u.LowPart = user.dwLowDateTime;
+            u.HighPart = user.dwHighDateTime;
+            return static_cast<long long>((k.QuadPart + u.QuadPart) / 10);
+        }
+
+        long long threadCpuMicros(DWORD threadId) {
+            if (threadId == GetCurrentThreadId())
+                return threadCpuMicros(GetCurrentThread());
+
+            HANDLE thread = OpenThread(THREAD_QUERY_LIMITED_INFORMATION, FALSE, threadId);
+            if (thread == NULL)
+                return -1;
+            const long long result = threadCpuMicros(thread);
+            CloseHandle(thread);
+            return result;
+        }
+
+#elif defined(MONGO_HAVE_POSIX_THREAD_CPUTIME)
+
+        long long threadCpuMicros(pthread_t thread) {
+            clockid_t clock;
+            if (pthread_getcpuclockid(thread, &clock))
+                return -1;
+
+            timespec t;
+            if (clock_gettime(clock, &t))
+                return -1;
+            return static_cast<long long>(t.tv_sec) * Timer::microsPerSecond + t.tv_nsec / 1000;
+        }
+
+#endif
+
+    }  // namespace
+
+    bool ThreadCpuTimer::isSupported() {
+#if defined(_WIN32) || defined(MONGO_HAVE_POSIX_THREAD_CPUTIME)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void ThreadCpuTimer::reset() {
+#if defined(_WIN32)
+        _threadId = GetCurrentThreadId();
+        _startMicros = threadCpuMicros(_threadId);
+        _valid = _startMicros >= 0;
+#elif defined(MONGO_HAVE_POSIX_THREAD_CPUTIME)
+        _thread = pthread_self();
+        _startMicros = threadCpuMicros(_thread);
+        _valid = _startMicros >= 0;
+#endif
+    }
+
+    long long ThreadCpuTimer::micros() const {
+#if defined(_WIN32)
+        const long long now = _valid ? threadCpuMicros(_threadId) : -1;
+#elif defined(MONGO_HAVE_POSIX_THREAD_CPUTIME)
+        const long long now = _valid ? threadCpuMicros(_thread) : -1;
+#else
+        const long long now = -1;
+#endif
+        return now < 0 ? -1 : now - _startMicros;
+    }
+
+}  // namespace mongo
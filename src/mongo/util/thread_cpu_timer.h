@@ -0,0 +1,73 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#if !defined(_WIN32)
+#include <pthread.h>
+#endif
+
+#include "mongo/base/disallow_copying.h"
+
+namespace mongo {
+
+    /**
+     * Measures the CPU time used by one thread.
+     *
+     * reset() starts timing the calling thread; micros() may then be called from any thread, as
+     * long as the timed thread is still running.  On platforms without per-thread CPU clocks,
+     * micros() always returns -1.
+     */
+    class ThreadCpuTimer {
+        MONGO_DISALLOW_COPYING(ThreadCpuTimer);
+    public:
+        ThreadCpuTimer() : _valid(false), _startMicros(0) {}
+
+        /** Starts timing the calling thread. */
+        void reset();
+
+        /**
+         * @return the CPU time the timed thread has used since reset(), in microseconds, or -1 if
+         *     it can't be measured.
+         */
+        long long micros() const;
+
+        /** @return true if this platform can measure the CPU time of a thread. */
+        static bool isSupported();
+
+    private:
+#if defined(_WIN32)
+        unsigned long _threadId;  // a DWORD
+#else
+        pthread_t _thread;
+#endif
+        bool _valid;
+        long long _startMicros;
+    };
+
+}  // namespace mongo
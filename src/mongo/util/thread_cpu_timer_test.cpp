@@ -0,0 +1,103 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <boost/thread/thread.hpp>
+
+#include "mongo/stdx/functional.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/thread_cpu_timer.h"
+#include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
+
+namespace {
+
+    using mongo::ThreadCpuTimer;
+    using mongo::Timer;
+
+    volatile unsigned long long sink;
+
+    void spinMillis(int millis) {
+        Timer t;
+        while (t.millis() < millis) {
+            for (int i = 0; i < 1000; ++i)
+                sink = sink + i;
+        }
+    }
+
+    TEST(ThreadCpuTimerTest, CountsBusyTimeNotSleep) {
+        if (!ThreadCpuTimer::isSupported())
+            return;
+
+        ThreadCpuTimer timer;
+        timer.reset();
+        spinMillis(50);
+        const long long busy = timer.micros();
+        ASSERT_GREATER_THAN(busy, 0);
+
+        mongo::sleepmillis(200);
+        const long long slept = timer.micros() - busy;
+        ASSERT_GREATER_THAN_OR_EQUALS(slept, 0);
+        ASSERT_LESS_THAN(slept, 100 * 1000);
+    }
+
+    void timeBusyThread(ThreadCpuTimer* timer, volatile bool* started, volatile bool* stop) {
+        timer->reset();
+        *started = true;
+        while (!*stop) {
+            spinMillis(1);
+        }
+    }
+
+    TEST(ThreadCpuTimerTest, ReadFromAnotherThread) {
+        if (!ThreadCpuTimer::isSupported())
+            return;
+
+        ThreadCpuTimer timer;
+        volatile bool started = false;
+        volatile bool stop = false;
+        boost::thread busy(mongo::stdx::bind(&timeBusyThread, &timer, &started, &stop));
+        while (!started) {
+            mongo::sleepmillis(1);
+        }
+
+        // Our own CPU time while sleeping is ~0, so anything counted here is the other thread's.
+        mongo::sleepmillis(100);
+        const long long otherThread = timer.micros();
+        stop = true;
+        busy.join();
+        ASSERT_GREATER_THAN(otherThread, 0);
+    }
+
+    TEST(ThreadCpuTimerTest, NotStarted) {
+        ThreadCpuTimer timer;
+        ASSERT_EQUALS(-1, timer.micros());
+    }
+
+}  // namespace
@@ -0,0 +1,128 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/timer_wheel.h"
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+    const int TimerWheel::kLevels;
+    const int TimerWheel::kSlotBits;
+    const int TimerWheel::kSlots;
+
+    namespace {
+        // The number of ticks spanned by one slot of the wheel at 'level'.
+        long long ticksPerSlot(int level) {
+            return 1LL << (TimerWheel::kSlotBits * level);
+        }
+    }
+
+    TimerWheel::TimerWheel(long long tickMillis, long long nowMillis)
+        : _tickMillis(tickMillis),
+          _currentTick(nowMillis / tickMillis) {
+        invariant(tickMillis > 0);
+    }
+
+    void TimerWheel::schedule(Id id, long long deadlineMillis) {
+        TimerMap::iterator it = _timers.find(id);
+        if (it == _timers.end()) {
+            it = _timers.insert(std::make_pair(id, Timer())).first;
+        }
+        else {
+            it->second.slot->erase(it->second.position);
+        }
+        it->second.deadlineMillis = deadlineMillis;
+        _place(id, &it->second);
+    }
+
+    bool TimerWheel::cancel(Id id) {
+        TimerMap::iterator it = _timers.find(id);
+        if (it == _timers.end())
+            return false;
+        it->second.slot->erase(it->second.position);
+        _timers.erase(it);
+        return true;
+    }
+
+    void TimerWheel::advance(long long nowMillis, std::vector<Id>* expired) {
+        const long long targetTick = nowMillis / _tickMillis;
+        while (_currentTick < targetTick) {
+            if (_timers.empty()) {
+                _currentTick = targetTick;
+                break;
+            }
+
+            ++_currentTick;
+
+            // Each time a wheel completes a turn, the next slot of the wheel above comes due.
+            for (int level = 1; level < kLevels; ++level) {
+                if (_currentTick & (ticksPerSlot(level) - 1))
+                    break;
+                _cascade(&_wheels[level][(_currentTick / ticksPerSlot(level)) & (kSlots - 1)]);
+            }
+
+            Slot& due = _wheels[0][_currentTick & (kSlots - 1)];
+            while (!due.empty()) {
+                const Id id = due.front();
+                due.pop_front();
+                _timers.erase(id);
+                expired->push_back(id);
+            }
+        }
+    }
+
+    void TimerWheel::_place(Id id, Timer* timer) {
+        // Round up, so that timers never expire early.
+        long long tick = (timer->deadlineMillis + _tickMillis - 1) / _tickMillis;
+        if (tick <= _currentTick)
+            tick = _currentTick + 1;
+        if (tick - _currentTick >= ticksPerSlot(kLevels))
+            tick = _currentTick + ticksPerSlot(kLevels) - 1;
+
+        int level = 0;
+        while (level < kLevels - 1 && tick - _currentTick >= ticksPerSlot(level + 1))
+            ++level;
+
+        timer->slot = &_wheels[level][(tick / ticksPerSlot(level)) & (kSlots - 1)];
+        timer->position = timer->slot->insert(timer->slot->end(), id);
+    }
+
+    void TimerWheel::_cascade(Slot* slot) {
+        Slot pending;
+        pending.swap(*slot);
+        for (Slot::const_iterator it = pending.begin(); it != pending.end(); ++it) {
+            TimerMap::iterator timer = _timers.find(*it);
+            invariant(timer != _timers.end());
+            _place(*it, &timer->second);
+        }
+    }
+
+}  // namespace mongo
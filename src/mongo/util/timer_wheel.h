@@ -0,0 +1,111 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/platform/unordered_map.h"
+
+namespace mongo {
+
+    /**
+     * Tracks deadlines for a large number of timers, keyed by id, with constant-time schedule()
+     * and cancel().  advance() costs time proportional to the timers that expire plus the
+     * number of ticks passed, not to the number of timers pending.
+     *
+     * Timers are kept in a hierarchy of wheels, each of kSlots slots.  A slot of the first wheel
+     * spans one tick, a slot of the second wheel spans a full turn of the first, and so on.
+     * Timers further in the future sit in coarser slots, and move down to finer ones as their
+     * deadline approaches.  Deadlines beyond the last wheel are parked in its furthest slot until
+     * they come into range.
+     *
+     * Times are in milliseconds on any clock the caller likes, as long as it never goes back.
+     * A timer expires on the first advance() to a time at or after its deadline, rounded up to
+     * a whole tick.
+     *
+     * Not thread safe.
+     */
+    class TimerWheel {
+        MONGO_DISALLOW_COPYING(TimerWheel);
+    public:
+        typedef long long Id;
+
+        static const int kLevels = 4;
+        static const int kSlotBits = 6;
+        static const int kSlots = 1 << kSlotBits;
+
+        /**
+         * @param tickMillis the span of a slot in the first wheel.
+         * @param nowMillis the current time.
+         */
+        TimerWheel(long long tickMillis, long long nowMillis);
+
+        /** Sets the deadline of timer 'id', replacing any it already has. */
+        void schedule(Id id, long long deadlineMillis);
+
+        /** Stops timer 'id'.  @return false if it wasn't scheduled. */
+        bool cancel(Id id);
+
+        bool isScheduled(Id id) const { return _timers.count(id) > 0; }
+
+        size_t size() const { return _timers.size(); }
+
+        /**
+         * Moves the current time forward to 'nowMillis', appending the ids of the timers that
+         * expire to 'expired' and unscheduling them.
+         */
+        void advance(long long nowMillis, std::vector<Id>* expired);
+
+    private:
+        typedef std::list<Id> Slot;
+
+        struct Timer {
+            long long deadlineMillis;
+            Slot* slot;
+            Slot::iterator position;
+        };
+
+        typedef unordered_map<Id, Timer> TimerMap;
+
+        void _place(Id id, Timer* timer);
+
+        /** Re-places every timer in '*slot', which must not be in the first wheel. */
+        void _cascade(Slot* slot);
+
+        const long long _tickMillis;
+        long long _currentTick;
+
+        TimerMap _timers;
+        Slot _wheels[kLevels][kSlots];
+    };
+
+}  // namespace mongo
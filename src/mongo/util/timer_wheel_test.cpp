@@ -0,0 +1,145 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <algorithm>
+#include <map>
+
+#include "mongo/platform/random.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/timer_wheel.h"
+
+namespace {
+
+    using mongo::PseudoRandom;
+    using mongo::TimerWheel;
+
+    long long randomBelow(PseudoRandom* random, long long max) {
+        return static_cast<long long>(static_cast<uint64_t>(random->nextInt64()) % max);
+    }
+
+    std::vector<TimerWheel::Id> advance(TimerWheel* wheel, long long nowMillis) {
+        std::vector<TimerWheel::Id> expired;
+        wheel->advance(nowMillis, &expired);
+        std::sort(expired.begin(), expired.end());
+        return expired;
+    }
+
+    TEST(TimerWheelTest, ExpiresAtDeadlineRoundedUpToTick) {
+        TimerWheel wheel(10, 0);
+        wheel.schedule(1, 25);
+        wheel.schedule(2, 30);
+        ASSERT_EQUALS(2U, wheel.size());
+
+        ASSERT_TRUE(advance(&wheel, 29).empty());
+        std::vector<TimerWheel::Id> expired = advance(&wheel, 30);
+        ASSERT_EQUALS(2U, expired.size());
+        ASSERT_EQUALS(1, expired[0]);
+        ASSERT_EQUALS(2, expired[1]);
+        ASSERT_EQUALS(0U, wheel.size());
+        ASSERT_FALSE(wheel.isScheduled(1));
+    }
+
+    TEST(TimerWheelTest, PastDeadlineExpiresOnNextTick) {
+        TimerWheel wheel(10, 100);
+        wheel.schedule(1, 50);
+        ASSERT_TRUE(advance(&wheel, 105).empty());
+        ASSERT_EQUALS(1U, advance(&wheel, 110).size());
+    }
+
+    TEST(TimerWheelTest, CancelAndReschedule) {
+        TimerWheel wheel(1, 0);
+        wheel.schedule(1, 10);
+        wheel.schedule(2, 10);
+        ASSERT_TRUE(wheel.cancel(1));
+        ASSERT_FALSE(wheel.cancel(1));
+        ASSERT_FALSE(wheel.cancel(3));
+
+        // Pushing a deadline back, as a cursor does each time it is used.
+        wheel.schedule(2, 5000);
+        ASSERT_EQUALS(1U, wheel.size());
+        ASSERT_TRUE(advance(&wheel, 4999).empty());
+        std::vector<TimerWheel::Id> expired = advance(&wheel, 5000);
+        ASSERT_EQUALS(1U, expired.size());
+        ASSERT_EQUALS(2, expired[0]);
+    }
+
+    TEST(TimerWheelTest, DeadlineBeyondLastWheel) {
+        const long long range = 1LL << (TimerWheel::kSlotBits * TimerWheel::kLevels);
+        TimerWheel wheel(1, 0);
+        wheel.schedule(1, 3 * range + 17);
+        ASSERT_TRUE(advance(&wheel, 3 * range + 16).empty());
+        ASSERT_EQUALS(1U, advance(&wheel, 3 * range + 17).size());
+    }
+
+    TEST(TimerWheelTest, MatchesSortedDeadlines) {
+        const long long tickMillis = 7;
+        PseudoRandom random(12345);
+        TimerWheel wheel(tickMillis, 0);
+        std::map<TimerWheel::Id, long long> expectedTicks;
+
+        long long now = 0;
+        TimerWheel::Id nextId = 0;
+        for (int round = 0; round < 2000; ++round) {
+            for (int i = 0; i < 20; ++i) {
+                // Mostly near deadlines, with some spread over every wheel.
+                const long long shift = randomBelow(&random, 26);
+                const long long deadline = now + randomBelow(&random, 1LL << shift) - 100;
+                const TimerWheel::Id id = (randomBelow(&random, 4) == 0 && !expectedTicks.empty())
+                        ? expectedTicks.begin()->first
+                        : nextId++;
+                wheel.schedule(id, deadline);
+                const long long tick = std::max((deadline + tickMillis - 1) / tickMillis,
+                                                now / tickMillis + 1);
+                expectedTicks[id] = tick;
+            }
+            if (randomBelow(&random, 10) == 0 && !expectedTicks.empty()) {
+                ASSERT_TRUE(wheel.cancel(expectedTicks.begin()->first));
+                expectedTicks.erase(expectedTicks.begin());
+            }
+
+            now += randomBelow(&random, round % 100 == 0 ? 1000 * 1000 : 5000);
+            std::vector<TimerWheel::Id> expected;
+            for (std::map<TimerWheel::Id, long long>::iterator it = expectedTicks.begin();
+                 it != expectedTicks.end();) {
+                if (it->second <= now / tickMillis) {
+                    expected.push_back(it->first);
+                    expectedTicks.erase(it++);
+                }
+                else {
+                    ++it;
+                }
+            }
+
+            ASSERT_TRUE(expected == advance(&wheel, now));
+            ASSERT_EQUALS(expectedTicks.size(), wheel.size());
+        }
+    }
+
+}  // namespace